@@ -56,7 +56,8 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
         ifeq ($(strip $(AUDIO_DRIVER)), dac_basic)
             OPT_DEFS += -DAUDIO_DRIVER_DAC
         else ifeq ($(strip $(AUDIO_DRIVER)), dac_additive)
-            OPT_DEFS += -DAUDIO_DRIVER_DAC
+            OPT_DEFS += -DAUDIO_DRIVER_DAC -DAUDIO_DRIVER_DAC_ADDITIVE
+            SRC += $(QUANTUM_DIR)/audio/audio_mixer.c
         ## stm32f2 and above have a usable DAC unit, f1 do not, and need to use pwm instead
         else ifeq ($(strip $(AUDIO_DRIVER)), pwm_software)
             OPT_DEFS += -DAUDIO_DRIVER_PWM
@@ -125,6 +126,16 @@ ifeq ($(strip $(MOUSEKEY_ENABLE)), yes)
     MOUSE_ENABLE := yes
 endif
 
+ifeq ($(strip $(KEY_OVERRIDE_ENABLE)), yes)
+    # Deferred registration of replacement keys
+    DEFERRED_EXEC_ENABLE := yes
+endif
+
+ifeq ($(strip $(DYNAMIC_MACRO_ENABLE)), yes)
+    # Non-blocking macro playback
+    DEFERRED_EXEC_ENABLE := yes
+endif
+
 VALID_POINTING_DEVICE_DRIVER_TYPES := adns5050 adns9800 analog_joystick azoteq_iqs5xx cirque_pinnacle_i2c cirque_pinnacle_spi paw3204 paw3222 pmw3320 pmw3360 pmw3389 pimoroni_trackball custom
 ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
     ifeq ($(filter $(POINTING_DEVICE_DRIVER),$(VALID_POINTING_DEVICE_DRIVER_TYPES)),)
@@ -352,6 +363,8 @@ ifeq ($(strip $(LED_MATRIX_ENABLE)), yes)
     COMMON_VPATH += $(QUANTUM_DIR)/led_matrix
     COMMON_VPATH += $(QUANTUM_DIR)/led_matrix/animations
     COMMON_VPATH += $(QUANTUM_DIR)/led_matrix/animations/runners
+    COMMON_VPATH += $(QUANTUM_DIR)/led_effect
+    COMMON_VPATH += $(QUANTUM_DIR)/led_effect/runners
     POST_CONFIG_H += $(QUANTUM_DIR)/led_matrix/post_config.h
     SRC += $(QUANTUM_DIR)/process_keycode/process_led_matrix.c
     SRC += $(QUANTUM_DIR)/led_matrix/led_matrix.c
@@ -373,60 +386,70 @@ ifeq ($(strip $(LED_MATRIX_ENABLE)), yes)
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3729)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3729-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3731)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3731-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3733)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3733-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3736)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3736-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3737)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3737-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3741)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3741-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3742a)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3742a-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3743a)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3743a-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3745)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3745-mono.c
     endif
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), is31fl3746a)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3746a-mono.c
     endif
@@ -467,6 +490,8 @@ ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
     COMMON_VPATH += $(QUANTUM_DIR)/rgb_matrix
     COMMON_VPATH += $(QUANTUM_DIR)/rgb_matrix/animations
     COMMON_VPATH += $(QUANTUM_DIR)/rgb_matrix/animations/runners
+    COMMON_VPATH += $(QUANTUM_DIR)/led_effect
+    COMMON_VPATH += $(QUANTUM_DIR)/led_effect/runners
     POST_CONFIG_H += $(QUANTUM_DIR)/rgb_matrix/post_config.h
 
     # TODO: Remove this
@@ -476,6 +501,8 @@ ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/color.c
     SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix.c
     SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix_drivers.c
+    SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix_program.c
+    SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix_stream.c
     LIB8TION_ENABLE := yes
     CIE1931_CURVE := yes
 
@@ -499,60 +526,70 @@ ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3729)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3729.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3731)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3731.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3733)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3733.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3736)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3736.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3737)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3737.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3741)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3741.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3742a)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3742a.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3743a)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3743a.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3745)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3745.c
     endif
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), is31fl3746a)
         I2C_DRIVER_REQUIRED = yes
+        IS31_COMMON_REQUIRED = yes
         COMMON_VPATH += $(DRIVER_PATH)/led/issi
         SRC += is31fl3746a.c
     endif
@@ -651,6 +688,24 @@ ifeq ($(strip $(DYNAMIC_KEYMAP_ENABLE)), yes)
     SEND_STRING_ENABLE := yes
 endif
 
+ifeq ($(strip $(MATRIX_IDLE_ENABLE)), yes)
+    OPT_DEFS += -DMATRIX_IDLE_ENABLE
+    COMMON_VPATH += $(QUANTUM_DIR)/matrix
+    QUANTUM_SRC += $(QUANTUM_DIR)/matrix/matrix_idle.c
+endif
+
+VALID_IO_EXPANDER_MATRIX_DRIVER_TYPES := mcp23018 pca9555
+
+ifeq ($(strip $(IO_EXPANDER_MATRIX_ENABLE)), yes)
+    ifeq ($(filter $(IO_EXPANDER_MATRIX_DRIVER),$(VALID_IO_EXPANDER_MATRIX_DRIVER_TYPES)),)
+        $(call CATASTROPHIC_ERROR,Invalid IO_EXPANDER_MATRIX_DRIVER,IO_EXPANDER_MATRIX_DRIVER="$(IO_EXPANDER_MATRIX_DRIVER)" is not a valid I/O expander matrix driver)
+    endif
+    OPT_DEFS += -DIO_EXPANDER_MATRIX_ENABLE -DIO_EXPANDER_MATRIX_DRIVER_$(strip $(shell echo $(IO_EXPANDER_MATRIX_DRIVER) | tr '[:lower:]' '[:upper:]'))
+    COMMON_VPATH += $(DRIVER_PATH)/matrix
+    SRC += io_expander_matrix.c
+    I2C_DRIVER_REQUIRED = yes
+endif
+
 VALID_CUSTOM_MATRIX_TYPES:= yes lite no
 
 CUSTOM_MATRIX ?= no
@@ -660,12 +715,14 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     endif
 
     # Include common stuff for all non custom matrix users
+    COMMON_VPATH += $(QUANTUM_DIR)/matrix
     QUANTUM_SRC += $(QUANTUM_DIR)/matrix_common.c
 
     # if 'lite' then skip the actual matrix implementation
     ifneq ($(strip $(CUSTOM_MATRIX)), lite)
         # Include the standard or split matrix code if needed
         QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
+        QUANTUM_SRC += $(QUANTUM_DIR)/matrix/matrix_port_plan.c
     endif
 endif
 
@@ -947,6 +1004,12 @@ ifeq ($(strip $(DIP_SWITCH_ENABLE)), yes)
     endif
 endif
 
+ifeq ($(strip $(LEADER_ENABLE)), yes)
+    ifeq ($(strip $(LEADER_SEQUENCES_ENABLE)), yes)
+        OPT_DEFS += -DLEADER_SEQUENCES_ENABLE
+    endif
+endif
+
 ifeq ($(strip $(BATTERY_ENABLE)), yes)
     BATTERY_DRIVER_REQUIRED := yes
 endif
@@ -999,6 +1062,11 @@ ifeq ($(strip $(WS2812_DRIVER_REQUIRED)), yes)
     endif
 endif
 
+ifeq ($(strip $(IS31_COMMON_REQUIRED)), yes)
+    COMMON_VPATH += $(DRIVER_PATH)/led/issi
+    SRC += is31_common.c
+endif
+
 ifeq ($(strip $(APA102_DRIVER_REQUIRED)), yes)
     COMMON_VPATH += $(DRIVER_PATH)/led
     SRC += apa102.c
@@ -1012,6 +1080,13 @@ endif
 ifeq ($(strip $(I2C_DRIVER_REQUIRED)), yes)
     OPT_DEFS += -DHAL_USE_I2C=TRUE
     QUANTUM_LIB_SRC += i2c_master.c
+
+    ifeq ($(strip $(I2C_ASYNC_ENABLE)), yes)
+        ifneq ($(strip $(PLATFORM)), CHIBIOS)
+            $(call CATASTROPHIC_ERROR,Invalid I2C_ASYNC_ENABLE,I2C_ASYNC_ENABLE is only supported on ChibiOS)
+        endif
+        OPT_DEFS += -DI2C_ASYNC_ENABLE
+    endif
 endif
 
 ifeq ($(strip $(SPI_DRIVER_REQUIRED)), yes)
@@ -27,6 +27,16 @@
 #    define ENCODER_DEFAULT_PIN_API_IMPL
 #endif
 
+#ifdef ENCODER_QUADRATURE_INTERRUPT
+#    if !defined(PROTOCOL_CHIBIOS)
+#        error "ENCODER_QUADRATURE_INTERRUPT is only supported on ChibiOS"
+#    endif
+#    if !defined(ENCODER_DEFAULT_PIN_API_IMPL)
+#        error "ENCODER_QUADRATURE_INTERRUPT requires ENCODER_A_PINS and ENCODER_B_PINS"
+#    endif
+#    include <hal.h>
+#endif // ENCODER_QUADRATURE_INTERRUPT
+
 extern volatile bool isLeftHand;
 
 __attribute__((weak)) void    encoder_quadrature_init_pin(uint8_t index, bool pad_b);
@@ -74,6 +84,14 @@ static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1,
 static uint8_t encoder_state[NUM_ENCODERS]  = {0};
 static int8_t  encoder_pulses[NUM_ENCODERS] = {0};
 
+#ifdef ENCODER_QUADRATURE_INTERRUPT
+// Free-running detent counters per direction, only ever written from the pin
+// interrupt and only read from the main loop - a lock-free single producer,
+// single consumer channel which coalesces any number of ticks between scans.
+static volatile uint8_t encoder_ticks[NUM_ENCODERS_MAX_PER_SIDE][2];
+static uint8_t          encoder_ticks_seen[NUM_ENCODERS_MAX_PER_SIDE][2];
+#endif // ENCODER_QUADRATURE_INTERRUPT
+
 // encoder counts
 static uint8_t thisCount;
 #ifdef SPLIT_KEYBOARD
@@ -89,6 +107,15 @@ __attribute__((weak)) void encoder_quadrature_post_init_kb(void) {
     // During the interrupt, read the pins then call `encoder_handle_read()` with the pin states and it'll queue up an encoder event if needed.
 }
 
+#ifdef ENCODER_QUADRATURE_INTERRUPT
+void encoder_quadrature_handle_read(uint8_t index, uint8_t pin_a_state, uint8_t pin_b_state);
+
+static void encoder_quadrature_pin_callback(void *arg) {
+    uint8_t index = (uint8_t)(uintptr_t)arg;
+    encoder_quadrature_handle_read(index, encoder_quadrature_read_pin(index, false), encoder_quadrature_read_pin(index, true));
+}
+#endif // ENCODER_QUADRATURE_INTERRUPT
+
 void encoder_quadrature_post_init(void) {
 #ifdef ENCODER_DEFAULT_PIN_API_IMPL
     for (uint8_t i = 0; i < thisCount; i++) {
@@ -103,6 +130,20 @@ void encoder_quadrature_post_init(void) {
     memset(encoder_state, 0, sizeof(encoder_state));
 #endif
 
+#ifdef ENCODER_QUADRATURE_INTERRUPT
+    for (uint8_t i = 0; i < thisCount; i++) {
+        encoder_ticks[i][0] = encoder_ticks_seen[i][0] = 0;
+        encoder_ticks[i][1] = encoder_ticks_seen[i][1] = 0;
+        for (uint8_t pad = 0; pad < 2; pad++) {
+            pin_t pin = pad ? encoders_pad_b[i] : encoders_pad_a[i];
+            if (pin != NO_PIN) {
+                palEnableLineEvent(pin, PAL_EVENT_MODE_BOTH_EDGES);
+                palSetLineCallback(pin, encoder_quadrature_pin_callback, (void *)(uintptr_t)i);
+            }
+        }
+    }
+#endif // ENCODER_QUADRATURE_INTERRUPT
+
     encoder_quadrature_post_init_kb();
 }
 
@@ -158,6 +199,16 @@ void encoder_driver_init(void) {
     encoder_quadrature_post_init();
 }
 
+static inline void encoder_emit(uint8_t i, uint8_t index, bool clockwise) {
+#ifdef ENCODER_QUADRATURE_INTERRUPT
+    (void)index;
+    encoder_ticks[i][clockwise]++;
+#else
+    (void)i;
+    encoder_queue_event(index, clockwise);
+#endif // ENCODER_QUADRATURE_INTERRUPT
+}
+
 static void encoder_handle_state_change(uint8_t index, uint8_t state) {
     uint8_t i = index;
 
@@ -180,7 +231,7 @@ static void encoder_handle_state_change(uint8_t index, uint8_t state) {
     if (encoder_pulses[i] >= resolution) {
 #endif
 
-            encoder_queue_event(index, ENCODER_COUNTER_CLOCKWISE);
+            encoder_emit(i, index, ENCODER_COUNTER_CLOCKWISE);
         }
 
 #ifdef ENCODER_DEFAULT_POS
@@ -188,7 +239,7 @@ static void encoder_handle_state_change(uint8_t index, uint8_t state) {
 #else
     if (encoder_pulses[i] <= -resolution) { // direction is arbitrary here, but this clockwise
 #endif
-            encoder_queue_event(index, ENCODER_CLOCKWISE);
+            encoder_emit(i, index, ENCODER_CLOCKWISE);
         }
         encoder_pulses[i] %= resolution;
 #ifdef ENCODER_DEFAULT_POS
@@ -207,7 +258,25 @@ void encoder_quadrature_handle_read(uint8_t index, uint8_t pin_a_state, uint8_t
 }
 
 __attribute__((weak)) void encoder_driver_task(void) {
+#ifdef ENCODER_QUADRATURE_INTERRUPT
+    // The pins are decoded from their interrupts, only collect what was counted since the last scan
+    for (uint8_t i = 0; i < thisCount; i++) {
+#    ifdef SPLIT_KEYBOARD
+        uint8_t index = i + thisHand;
+#    else
+        uint8_t index = i;
+#    endif
+        for (uint8_t clockwise = 0; clockwise < 2; clockwise++) {
+            uint8_t ticks = encoder_ticks[i][clockwise];
+            while (encoder_ticks_seen[i][clockwise] != ticks) {
+                encoder_ticks_seen[i][clockwise]++;
+                encoder_queue_event(index, clockwise);
+            }
+        }
+    }
+#else
     for (uint8_t i = 0; i < thisCount; i++) {
         encoder_quadrature_handle_read(i, encoder_quadrature_read_pin(i, false), encoder_quadrature_read_pin(i, true));
     }
+#endif // ENCODER_QUADRATURE_INTERRUPT
 }
@@ -153,4 +153,77 @@ i2c_status_t i2c_read_register16(uint8_t devaddr, uint16_t regaddr, uint8_t* dat
  */
 i2c_status_t i2c_ping_address(uint8_t address, uint16_t timeout);
 
+#if defined(I2C_ASYNC_ENABLE) || defined(__DOXYGEN__)
+/**
+ * \brief Called by the I2C thread when a queued transaction has completed.
+ *
+ * Callbacks run on the I2C thread rather than the main loop. They should be short and must not queue further transactions.
+ *
+ * \param status The result of the transaction.
+ * \param arg The pointer given when the transaction was queued.
+ */
+typedef void (*i2c_async_callback_t)(i2c_status_t status, void* arg);
+
+/**
+ * \brief Queue a transmission to the selected I2C device.
+ *
+ * The data is copied into the queue, so the buffer may be reused as soon as this function returns. Queued transactions are sent in order, back to back, while the caller continues. Any blocking I2C function first waits for the queue to drain.
+ *
+ * Only available on ChibiOS, with `I2C_ASYNC_ENABLE = yes` in `rules.mk`.
+ *
+ * \param address The 7-bit I2C address of the device.
+ * \param data A pointer to the data to transmit.
+ * \param length The number of bytes to write. Take care not to overrun the length of `data`.
+ * \param timeout The time in milliseconds to wait for room in the queue, and then for a response from the target device.
+ * \param callback A function to call on completion, or `NULL`.
+ * \param arg A pointer passed to `callback`.
+ *
+ * \return `I2C_STATUS_TIMEOUT` if the queue stayed full for the timeout period, `I2C_STATUS_ERROR` if the transaction cannot fit in the queue, otherwise `I2C_STATUS_SUCCESS`.
+ */
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_async_callback_t callback, void* arg);
+
+/**
+ * \brief Queue a write to a register with an 8-bit address on the I2C device.
+ *
+ * See i2c_transmit_async() for the queueing rules.
+ *
+ * \param devaddr The 7-bit I2C address of the device.
+ * \param regaddr The register address to write to.
+ * \param data A pointer to the data to transmit.
+ * \param length The number of bytes to write. Take care not to overrun the length of `data`.
+ * \param timeout The time in milliseconds to wait for room in the queue, and then for a response from the target device.
+ * \param callback A function to call on completion, or `NULL`.
+ * \param arg A pointer passed to `callback`.
+ *
+ * \return `I2C_STATUS_TIMEOUT` if the queue stayed full for the timeout period, `I2C_STATUS_ERROR` if the transaction cannot fit in the queue, otherwise `I2C_STATUS_SUCCESS`.
+ */
+i2c_status_t i2c_write_register_async(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_async_callback_t callback, void* arg);
+
+/**
+ * \brief Queue a read from a register with an 8-bit address on the I2C device.
+ *
+ * `data` is written by the I2C thread and must stay valid until the callback has run or i2c_wait_all() has returned.
+ *
+ * \param devaddr The 7-bit I2C address of the device.
+ * \param regaddr The register address to read from.
+ * \param data A pointer to a buffer to read into.
+ * \param length The number of bytes to read. Take care not to overrun the length of `data`.
+ * \param timeout The time in milliseconds to wait for room in the queue, and then for a response from the target device.
+ * \param callback A function to call on completion, or `NULL`.
+ * \param arg A pointer passed to `callback`.
+ *
+ * \return `I2C_STATUS_TIMEOUT` if the queue stayed full for the timeout period, `I2C_STATUS_ERROR` if the transaction cannot fit in the queue, otherwise `I2C_STATUS_SUCCESS`.
+ */
+i2c_status_t i2c_read_register_async(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout, i2c_async_callback_t callback, void* arg);
+
+/**
+ * \brief Wait for all queued transactions to complete.
+ *
+ * \param timeout The time in milliseconds to wait for the queue to drain.
+ *
+ * \return `I2C_STATUS_TIMEOUT` if the queue did not drain in time, otherwise the first error reported by a queued transaction since the last call, or `I2C_STATUS_SUCCESS`.
+ */
+i2c_status_t i2c_wait_all(uint16_t timeout);
+#endif
+
 /** \} */
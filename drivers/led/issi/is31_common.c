@@ -0,0 +1,44 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stddef.h>
+#include "is31_common.h"
+#include "i2c_master.h"
+
+is31_dirty_t is31_write_pwm_chunks(uint8_t address, const is31_pwm_block_t *block, const uint8_t *buffer, is31_dirty_t dirty, uint8_t persistence, uint16_t timeout) {
+    uint8_t      attempts = persistence > 0 ? persistence : 1;
+    is31_dirty_t failed   = 0;
+
+    for (uint16_t offset = 0, chunk = 0; dirty && offset < block->count; offset += block->chunk_size, chunk++) {
+        is31_dirty_t bit = (is31_dirty_t)1 << chunk;
+        if (!(dirty & bit)) continue;
+        dirty &= ~bit;
+
+        uint16_t length = block->count - offset;
+        if (length > block->chunk_size) length = block->chunk_size;
+
+#ifdef I2C_ASYNC_ENABLE
+        // Without retries there is nothing to wait for: queue the chunk and
+        // let the I2C thread send it while the keyboard carries on scanning.
+        // This is best-effort: only a chunk that cannot be queued stays
+        // dirty, and one that later fails on the bus is not sent again
+        // until its LEDs change.
+        if (persistence == 0) {
+            if (i2c_write_register_async(address << 1, block->reg + offset, buffer + offset, length, timeout, NULL, NULL) != I2C_STATUS_SUCCESS) {
+                failed |= bit;
+            }
+            continue;
+        }
+#endif
+
+        uint8_t i = 0;
+        while (i2c_write_register(address << 1, block->reg + offset, buffer + offset, length, timeout) != I2C_STATUS_SUCCESS) {
+            if (++i >= attempts) {
+                failed |= bit;
+                break;
+            }
+        }
+    }
+
+    return failed;
+}
@@ -0,0 +1,50 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+// One bit per chunk of a PWM block; chips have at most 12 chunks per page.
+typedef uint16_t is31_dirty_t;
+
+// Describes a contiguous run of PWM registers on one page and how it is
+// split into I2C transfers. The chunk size is chosen per chip so that a
+// transfer fits the platform I2C buffer.
+typedef struct is31_pwm_block_t {
+    uint8_t  reg;        // register address of the first byte of the block
+    uint16_t count;      // number of registers in the block
+    uint8_t  chunk_size; // number of registers per transfer
+} is31_pwm_block_t;
+
+#define IS31_CHUNK_COUNT(count, chunk_size) (((count) + (chunk_size) - 1) / (chunk_size))
+
+/**
+ * \brief Get the dirty bit of the chunk containing a buffer offset.
+ *
+ * \param offset Offset of the register within the block.
+ * \param chunk_size Number of registers per transfer.
+ */
+static inline is31_dirty_t is31_chunk_bit(uint16_t offset, uint8_t chunk_size) {
+    return (is31_dirty_t)1 << (offset / chunk_size);
+}
+
+/**
+ * \brief Transmit the dirty chunks of a PWM block.
+ *
+ * The page holding the block must already be selected. Each chunk is
+ * retried up to `persistence` times. With `I2C_ASYNC_ENABLE` and no
+ * persistence the chunks are queued instead and sent in the background.
+ * Queued chunks are best-effort: they count as transmitted once queued, and
+ * one that then fails on the bus stays stale until it is marked dirty again.
+ *
+ * \param address The 7-bit I2C address of the driver.
+ * \param block The layout of the PWM block.
+ * \param buffer The PWM buffer, `block->count` bytes long.
+ * \param dirty The chunks to transmit.
+ * \param persistence The number of attempts per chunk, 0 meaning a single attempt.
+ * \param timeout The I2C timeout per transfer, in milliseconds.
+ *
+ * \return The chunks which could not be transmitted.
+ */
+is31_dirty_t is31_write_pwm_chunks(uint8_t address, const is31_pwm_block_t *block, const uint8_t *buffer, is31_dirty_t dirty, uint8_t persistence, uint16_t timeout);
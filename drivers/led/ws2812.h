@@ -95,3 +95,8 @@ void ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
 void ws2812_flush(void);
 
 void ws2812_rgb_to_rgbw(ws2812_led_t *led);
+
+#if defined(WS2812_SPI)
+// Number of frames replaced by a newer flush before they could be sent.
+uint32_t ws2812_spi_skipped_frames(void);
+#endif
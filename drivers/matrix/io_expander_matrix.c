@@ -0,0 +1,299 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "io_expander_matrix.h"
+#include "i2c_master.h"
+#include "gpio.h"
+#include "timer.h"
+#include "debug.h"
+#include "compiler_support.h"
+
+#if !defined(IO_EXPANDER_MATRIX_ADDRESS) || !defined(IO_EXPANDER_MATRIX_ROW_BITS) || !defined(IO_EXPANDER_MATRIX_COL_BITS)
+#    error "IO_EXPANDER_MATRIX_ADDRESS, IO_EXPANDER_MATRIX_ROW_BITS and IO_EXPANDER_MATRIX_COL_BITS must be defined"
+#endif
+
+#ifndef IO_EXPANDER_MATRIX_ROW_PORT
+#    define IO_EXPANDER_MATRIX_ROW_PORT 0
+#endif
+#define IO_EXPANDER_MATRIX_COL_PORT (1 - IO_EXPANDER_MATRIX_ROW_PORT)
+
+#ifndef IO_EXPANDER_MATRIX_TIMEOUT
+#    define IO_EXPANDER_MATRIX_TIMEOUT 100
+#endif
+
+#ifndef IO_EXPANDER_MATRIX_RETRY_INTERVAL
+#    define IO_EXPANDER_MATRIX_RETRY_INTERVAL 1000
+#endif
+
+#define SLAVE_TO_ADDR(n) (n << 1)
+#define EXPANDER_ADDR SLAVE_TO_ADDR(IO_EXPANDER_MATRIX_ADDRESS)
+
+// Register of port A/0, port B/1 is the next one
+#if defined(IO_EXPANDER_MATRIX_DRIVER_MCP23018)
+enum {
+    REG_IODIR   = 0x00,
+    REG_GPINTEN = 0x04,
+    REG_IOCON   = 0x0A,
+    REG_GPPU    = 0x0C,
+    REG_INPUT   = 0x12, // GPIO
+    REG_OUTPUT  = 0x12, // GPIO, writes modify OLAT
+};
+
+#    define IOCON_MIRROR 0x40 // INTA and INTB both reflect either port
+#    define IOCON_ODR 0x04    // open-drain INT outputs
+#elif defined(IO_EXPANDER_MATRIX_DRIVER_PCA9555)
+enum {
+    REG_INPUT  = 0x00,
+    REG_OUTPUT = 0x02,
+    REG_CONFIG = 0x06, // 1 = input
+};
+#else
+#    error "IO_EXPANDER_MATRIX_DRIVER must be mcp23018 or pca9555"
+#endif
+
+static const uint8_t row_bits[] = IO_EXPANDER_MATRIX_ROW_BITS;
+static const uint8_t col_bits[] = IO_EXPANDER_MATRIX_COL_BITS;
+
+#define EXPANDER_ROWS (sizeof(row_bits) / sizeof(row_bits[0]))
+#define EXPANDER_COLS (sizeof(col_bits) / sizeof(col_bits[0]))
+
+STATIC_ASSERT(EXPANDER_ROWS <= 8 && EXPANDER_COLS <= 8, "An expander port has 8 pins");
+STATIC_ASSERT(EXPANDER_COLS <= MATRIX_COLS, "More expander columns than MATRIX_COLS");
+
+typedef enum {
+    READ_DONE,
+    READ_PENDING,
+    READ_ERROR,
+} read_status_t;
+
+static uint8_t  row_mask;
+static uint8_t  col_mask;
+static bool     online;
+static bool     idle;
+static uint32_t retry_timer;
+
+static bool write_register(uint8_t reg, uint8_t port, uint8_t value) {
+    i2c_status_t ret = i2c_write_register(EXPANDER_ADDR, reg + port, &value, sizeof(value), IO_EXPANDER_MATRIX_TIMEOUT);
+    if (ret != I2C_STATUS_SUCCESS) {
+        dprintf("io_expander_matrix::write %02X FAILED::%d\n", reg + port, ret);
+        return false;
+    }
+    return true;
+}
+
+static bool read_register(uint8_t reg, uint8_t port, uint8_t *value) {
+    i2c_status_t ret = i2c_read_register(EXPANDER_ADDR, reg + port, value, sizeof(*value), IO_EXPANDER_MATRIX_TIMEOUT);
+    if (ret != I2C_STATUS_SUCCESS) {
+        dprintf("io_expander_matrix::read %02X FAILED::%d\n", reg + port, ret);
+        return false;
+    }
+    return true;
+}
+
+static bool init_expander(void) {
+    // Rows are driven high before they become outputs, so that no row is
+    // selected in between
+#if defined(IO_EXPANDER_MATRIX_DRIVER_MCP23018)
+#    ifdef IO_EXPANDER_MATRIX_INT_PIN
+    if (!write_register(REG_IOCON, 0, IOCON_MIRROR | IOCON_ODR) || !write_register(REG_GPINTEN, IO_EXPANDER_MATRIX_COL_PORT, col_mask)) {
+        return false;
+    }
+#    endif
+    return write_register(REG_OUTPUT, IO_EXPANDER_MATRIX_ROW_PORT, 0xFF) && write_register(REG_IODIR, IO_EXPANDER_MATRIX_ROW_PORT, ~row_mask) && write_register(REG_IODIR, IO_EXPANDER_MATRIX_COL_PORT, 0xFF) && write_register(REG_GPPU, IO_EXPANDER_MATRIX_COL_PORT, col_mask);
+#elif defined(IO_EXPANDER_MATRIX_DRIVER_PCA9555)
+    // The PCA9555 has built in pull-ups, and always drives its INT output
+    return write_register(REG_OUTPUT, IO_EXPANDER_MATRIX_ROW_PORT, 0xFF) && write_register(REG_CONFIG, IO_EXPANDER_MATRIX_ROW_PORT, ~row_mask) && write_register(REG_CONFIG, IO_EXPANDER_MATRIX_COL_PORT, 0xFF);
+#endif
+}
+
+#ifdef I2C_ASYNC_ENABLE
+static volatile bool         batch_done;
+static volatile i2c_status_t batch_status;
+static bool                  batch_queued;
+static uint8_t               batch_input[EXPANDER_ROWS];
+
+// arg is only set for the last read of a batch
+static void batch_callback(i2c_status_t status, void *arg) {
+    if (status != I2C_STATUS_SUCCESS && batch_status == I2C_STATUS_SUCCESS) {
+        batch_status = status;
+    }
+    if (arg) {
+        batch_done = true;
+    }
+}
+
+/**
+ * \brief Queue the select and read of every row, to be run by the I2C thread
+ * while the previous reading is processed.
+ */
+static bool start_read(void) {
+    batch_status = I2C_STATUS_SUCCESS;
+    batch_done   = false;
+    batch_queued = true;
+
+    for (uint8_t row = 0; row < EXPANDER_ROWS; row++) {
+        uint8_t      select = ~(1 << row_bits[row]);
+        i2c_status_t ret    = i2c_write_register_async(EXPANDER_ADDR, REG_OUTPUT + IO_EXPANDER_MATRIX_ROW_PORT, &select, sizeof(select), IO_EXPANDER_MATRIX_TIMEOUT, batch_callback, NULL);
+        if (ret == I2C_STATUS_SUCCESS) {
+            ret = i2c_read_register_async(EXPANDER_ADDR, REG_INPUT + IO_EXPANDER_MATRIX_COL_PORT, &batch_input[row], sizeof(batch_input[row]), IO_EXPANDER_MATRIX_TIMEOUT, batch_callback, row == EXPANDER_ROWS - 1 ? batch_input : NULL);
+        }
+        if (ret != I2C_STATUS_SUCCESS) {
+            dprintf("io_expander_matrix::queue FAILED::%d\n", ret);
+            // Let the part of the batch that made it into the queue finish
+            i2c_wait_all(IO_EXPANDER_MATRIX_TIMEOUT);
+            batch_queued = false;
+            return false;
+        }
+    }
+    return true;
+}
+
+static read_status_t finish_read(uint8_t input[]) {
+    if (!batch_queued && !start_read()) {
+        return READ_ERROR;
+    }
+    if (!batch_done) {
+        return READ_PENDING;
+    }
+
+    batch_queued = false;
+    if (batch_status != I2C_STATUS_SUCCESS) {
+        dprintf("io_expander_matrix::scan FAILED::%d\n", batch_status);
+        return READ_ERROR;
+    }
+    for (uint8_t row = 0; row < EXPANDER_ROWS; row++) {
+        input[row] = batch_input[row];
+    }
+    return READ_DONE;
+}
+
+static void cancel_read(void) {
+    if (batch_queued) {
+        i2c_wait_all(IO_EXPANDER_MATRIX_TIMEOUT);
+        batch_queued = false;
+    }
+}
+#else
+static bool start_read(void) {
+    return true;
+}
+
+static read_status_t finish_read(uint8_t input[]) {
+    for (uint8_t row = 0; row < EXPANDER_ROWS; row++) {
+        if (!write_register(REG_OUTPUT, IO_EXPANDER_MATRIX_ROW_PORT, ~(1 << row_bits[row])) || !read_register(REG_INPUT, IO_EXPANDER_MATRIX_COL_PORT, &input[row])) {
+            return READ_ERROR;
+        }
+    }
+    return READ_DONE;
+}
+
+static void cancel_read(void) {}
+#endif
+
+/**
+ * \brief Select every row and check that no column is pulled low. The read
+ * also clears the interrupt, which then fires on the next press.
+ */
+static bool enter_idle(void) {
+#ifdef IO_EXPANDER_MATRIX_INT_PIN
+    uint8_t input;
+    if (!write_register(REG_OUTPUT, IO_EXPANDER_MATRIX_ROW_PORT, ~row_mask) || !read_register(REG_INPUT, IO_EXPANDER_MATRIX_COL_PORT, &input)) {
+        return false;
+    }
+    idle = (~input & col_mask) == 0;
+#endif
+    return true;
+}
+
+static bool interrupt_pending(void) {
+#ifdef IO_EXPANDER_MATRIX_INT_PIN
+    return !gpio_read_pin(IO_EXPANDER_MATRIX_INT_PIN);
+#else
+    return true;
+#endif
+}
+
+static bool go_offline(matrix_row_t rows[]) {
+    bool changed = false;
+
+    cancel_read();
+    online      = false;
+    idle        = false;
+    retry_timer = timer_read32();
+    for (uint8_t row = 0; row < EXPANDER_ROWS; row++) {
+        changed |= rows[row] != 0;
+        rows[row] = 0;
+    }
+    return changed;
+}
+
+void io_expander_matrix_init(void) {
+    row_mask = 0;
+    for (uint8_t row = 0; row < EXPANDER_ROWS; row++) {
+        row_mask |= 1 << row_bits[row];
+    }
+    col_mask = 0;
+    for (uint8_t col = 0; col < EXPANDER_COLS; col++) {
+        col_mask |= 1 << col_bits[col];
+    }
+
+#ifdef IO_EXPANDER_MATRIX_INT_PIN
+    gpio_set_pin_input_high(IO_EXPANDER_MATRIX_INT_PIN);
+#endif
+
+    i2c_init();
+    online      = init_expander();
+    retry_timer = timer_read32();
+}
+
+bool io_expander_matrix_scan(matrix_row_t rows[]) {
+    if (!online) {
+        if (timer_elapsed32(retry_timer) < IO_EXPANDER_MATRIX_RETRY_INTERVAL) {
+            return false;
+        }
+        retry_timer = timer_read32();
+        if (!init_expander()) {
+            return false;
+        }
+        online = true;
+    }
+
+    if (idle) {
+        if (!interrupt_pending()) {
+            return false;
+        }
+        idle = false;
+    }
+
+    uint8_t       input[EXPANDER_ROWS];
+    read_status_t status = finish_read(input);
+    if (status == READ_PENDING) {
+        return false;
+    }
+    if (status == READ_ERROR) {
+        return go_offline(rows);
+    }
+
+    bool         changed = false;
+    matrix_row_t any     = 0;
+    for (uint8_t row = 0; row < EXPANDER_ROWS; row++) {
+        matrix_row_t current = 0;
+        for (uint8_t col = 0; col < EXPANDER_COLS; col++) {
+            if (!(input[row] & (1 << col_bits[col]))) {
+                current |= MATRIX_ROW_SHIFTER << col;
+            }
+        }
+        changed |= rows[row] != current;
+        rows[row] = current;
+        any |= current;
+    }
+
+    if (!any && !enter_idle()) {
+        return go_offline(rows) || changed;
+    }
+    // Overlap the next reading with the processing of this one
+    if (!idle && !start_read()) {
+        return go_offline(rows) || changed;
+    }
+    return changed;
+}
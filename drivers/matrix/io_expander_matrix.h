@@ -0,0 +1,35 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/**
+ * Matrix rows and columns wired to the two ports of an I2C I/O expander
+ * (MCP23018 or PCA9555), one port driving the rows and the other reading
+ * the columns.
+ *
+ * With `I2C_ASYNC_ENABLE`, the transactions of a whole scan are queued at
+ * once and run by the I2C thread while the keyboard processes the previous
+ * scan. With `IO_EXPANDER_MATRIX_INT_PIN`, an idle matrix is not read at all
+ * until the expander raises its interrupt output.
+ */
+
+/**
+ * \brief Set up the expander. Call from `matrix_init_custom()`.
+ */
+void io_expander_matrix_init(void);
+
+/**
+ * \brief Read the expander rows into `rows`.
+ *
+ * Fills one entry per row of `IO_EXPANDER_MATRIX_ROW_BITS`. Rows are left
+ * untouched when no new reading is available yet, and cleared if the
+ * expander stops responding.
+ *
+ * \return true if `rows` changed.
+ */
+bool io_expander_matrix_scan(matrix_row_t rows[]);
@@ -158,6 +158,12 @@ uint8_t         oled_rotation_width = 0;
 uint8_t         oled_scroll_speed   = 0; // this holds the speed after being remapped to ssd1306 internal values
 uint8_t         oled_scroll_start   = 0;
 uint8_t         oled_scroll_end     = 7;
+
+// Byte range still to be sent within each dirty block, kept as the number of
+// clean bytes before and after it so the zeroed state means "whole block".
+// Only used when a block fits on a single page without rotation.
+static uint8_t oled_dirty_head[OLED_BLOCK_COUNT];
+static uint8_t oled_dirty_tail[OLED_BLOCK_COUNT];
 #if OLED_TIMEOUT > 0
 uint32_t oled_timeout;
 #endif
@@ -202,6 +208,11 @@ __attribute__((weak)) bool oled_send_cmd(const uint8_t *data, uint16_t size) {
     }
     spi_stop();
     return true;
+#elif defined(OLED_TRANSPORT_I2C) && defined(I2C_ASYNC_ENABLE)
+    // Queued behind any pending data so the addressing commands of the next
+    // block don't have to wait for the previous block to hit the bus.
+    i2c_status_t status = i2c_transmit_async((OLED_DISPLAY_ADDRESS << 1), data, size, OLED_I2C_TIMEOUT, NULL, NULL);
+    return (status == I2C_STATUS_SUCCESS);
 #elif defined(OLED_TRANSPORT_I2C)
     i2c_status_t status = i2c_transmit((OLED_DISPLAY_ADDRESS << 1), data, size, OLED_I2C_TIMEOUT);
 
@@ -249,6 +260,11 @@ __attribute__((weak)) bool oled_send_data(const uint8_t *data, uint16_t size) {
     }
     spi_stop();
     return true;
+#elif defined(OLED_TRANSPORT_I2C) && defined(I2C_ASYNC_ENABLE)
+    // The data is copied into the I2C queue, so rendering can carry on with
+    // the next block while this one is on the bus.
+    i2c_status_t status = i2c_write_register_async((OLED_DISPLAY_ADDRESS << 1), I2C_DATA, data, size, OLED_I2C_TIMEOUT, NULL, NULL);
+    return (status == I2C_STATUS_SUCCESS);
 #elif defined(OLED_TRANSPORT_I2C)
     i2c_status_t status = i2c_write_register((OLED_DISPLAY_ADDRESS << 1), I2C_DATA, data, size, OLED_I2C_TIMEOUT);
     return (status == I2C_STATUS_SUCCESS);
@@ -372,16 +388,38 @@ __attribute__((weak)) oled_rotation_t oled_init_user(oled_rotation_t rotation) {
     return rotation;
 }
 
+// Marks the buffer bytes from start to end (inclusive) as changed
+static void oled_mark_dirty(uint16_t start, uint16_t end) {
+    if (end >= OLED_MATRIX_SIZE) end = OLED_MATRIX_SIZE - 1;
+    for (uint8_t block = start / OLED_BLOCK_SIZE; block <= end / OLED_BLOCK_SIZE; ++block) {
+        OLED_BLOCK_TYPE bit = (OLED_BLOCK_TYPE)1 << block;
+        if (OLED_BLOCK_SIZE <= OLED_DISPLAY_WIDTH) {
+            uint16_t base = OLED_BLOCK_SIZE * block;
+            uint8_t  head = start > base ? start - base : 0;
+            uint8_t  tail = end < base + OLED_BLOCK_SIZE - 1 ? base + OLED_BLOCK_SIZE - 1 - end : 0;
+            if (!(oled_dirty & bit)) {
+                oled_dirty_head[block] = head;
+                oled_dirty_tail[block] = tail;
+            } else {
+                if (head < oled_dirty_head[block]) oled_dirty_head[block] = head;
+                if (tail < oled_dirty_tail[block]) oled_dirty_tail[block] = tail;
+            }
+        }
+        oled_dirty |= bit;
+    }
+}
+
 void oled_clear(void) {
     memset(oled_buffer, 0, sizeof(oled_buffer));
     oled_cursor = &oled_buffer[0];
-    oled_dirty  = OLED_ALL_BLOCKS_MASK;
+    oled_mark_dirty(0, OLED_MATRIX_SIZE - 1);
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
-    // Calculate commands to set memory addressing bounds.
+static void calc_bounds(uint8_t update_start, uint8_t offset, uint16_t length, uint8_t *cmd_array) {
+    // Calculate commands to set memory addressing bounds for `length` bytes
+    // starting `offset` bytes into the block.
     uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH + offset;
 #if !OLED_IC_HAS_HORIZONTAL_MODE
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
@@ -392,8 +430,8 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     // Commands for use in Horizontal Addressing mode.
     cmd_array[1] = start_column + OLED_COLUMN_OFFSET;
     cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1 + cmd_array[4];
+    cmd_array[2] = (length + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
+    cmd_array[5] = (length + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1 + cmd_array[4];
 #endif
 }
 
@@ -427,19 +465,35 @@ static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
 #endif
 }
 
-uint8_t crot(uint8_t a, int8_t n) {
-    const uint8_t mask = 0x7;
-    n &= mask;
-    return a << n | a >> (-n & mask);
-}
-
+// Rotates an 8x8 pixel tile: bit i of src[j] becomes bit 7 - j of dest[i].
+// The tile is transposed as two 32-bit words with three masked swaps rather
+// than moving the 64 pixels one at a time.
 static void rotate_90(const uint8_t *src, uint8_t *dest) {
-    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
-        uint8_t selector = (1 << i);
-        for (uint8_t j = 0; j < 8; ++j) {
-            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
-        }
-    }
+    uint32_t x = (uint32_t)src[0] << 24 | (uint32_t)src[1] << 16 | (uint32_t)src[2] << 8 | src[3];
+    uint32_t y = (uint32_t)src[4] << 24 | (uint32_t)src[5] << 16 | (uint32_t)src[6] << 8 | src[7];
+    uint32_t t;
+
+    // Swap bits within 2x2, then 2x2 blocks within 4x4, then 4x4 quadrants
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x ^= t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x ^= t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y ^= t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    dest[0] |= y;
+    dest[1] |= y >> 8;
+    dest[2] |= y >> 16;
+    dest[3] |= y >> 24;
+    dest[4] |= x;
+    dest[5] |= x >> 8;
+    dest[6] |= x >> 16;
+    dest[7] |= x >> 24;
 }
 
 void oled_render_dirty(bool all) {
@@ -466,8 +520,16 @@ void oled_render_dirty(bool all) {
 #else
         static uint8_t display_start[] = {I2C_CMD, PAM_PAGE_ADDR, PAM_SETCOLUMN_LSB, PAM_SETCOLUMN_MSB};
 #endif
+        // Without rotation only the changed byte range of the block is sent
+        uint8_t  offset = 0;
+        uint16_t length = OLED_BLOCK_SIZE;
+        if (OLED_BLOCK_SIZE <= OLED_DISPLAY_WIDTH) {
+            offset = oled_dirty_head[update_start];
+            length = OLED_BLOCK_SIZE - offset - oled_dirty_tail[update_start];
+        }
+
         if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-            calc_bounds(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
+            calc_bounds(update_start, offset, length, &display_start[1]); // Offset from I2C_CMD byte at the start
         } else {
             calc_bounds_90(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
         }
@@ -480,7 +542,7 @@ void oled_render_dirty(bool all) {
 
         if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
             // Send render data chunk as is
-            if (!oled_send_data(&oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE)) {
+            if (!oled_send_data(&oled_buffer[OLED_BLOCK_SIZE * update_start + offset], length)) {
                 print("oled_render data failed\n");
                 return;
             }
@@ -525,6 +587,8 @@ void oled_render_dirty(bool all) {
 
         // Clear dirty flag of just rendered block
         oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
+        oled_dirty_head[update_start] = 0;
+        oled_dirty_tail[update_start] = 0;
     }
 }
 
@@ -616,9 +680,7 @@ void oled_write_char(const char data, bool invert) {
     // Dirty check
     if (memcmp(&oled_temp_buffer, oled_cursor, OLED_FONT_WIDTH)) {
         uint16_t index = oled_cursor - &oled_buffer[0];
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
-        // Edgecase check if the written data spans the 2 chunks
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << ((index + OLED_FONT_WIDTH - 1) / OLED_BLOCK_SIZE));
+        oled_mark_dirty(index, index + OLED_FONT_WIDTH - 1);
     }
 
     // Finally move to the next char
@@ -653,7 +715,7 @@ void oled_pan(bool left) {
             }
         }
     }
-    oled_dirty = OLED_ALL_BLOCKS_MASK;
+    oled_mark_dirty(0, OLED_MATRIX_SIZE - 1);
 }
 
 oled_buffer_reader_t oled_read_raw(uint16_t start_index) {
@@ -668,7 +730,7 @@ void oled_write_raw_byte(const char data, uint16_t index) {
     if (index > OLED_MATRIX_SIZE) index = OLED_MATRIX_SIZE;
     if (oled_buffer[index] == data) return;
     oled_buffer[index] = data;
-    oled_dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
+    oled_mark_dirty(index, index);
 }
 
 void oled_write_raw(const char *data, uint16_t size) {
@@ -678,7 +740,7 @@ void oled_write_raw(const char *data, uint16_t size) {
         uint8_t c = *data++;
         if (oled_buffer[i] == c) continue;
         oled_buffer[i] = c;
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
+        oled_mark_dirty(i, i);
     }
 }
 
@@ -698,7 +760,7 @@ void oled_write_pixel(uint8_t x, uint8_t y, bool on) {
     }
     if (oled_buffer[index] != data) {
         oled_buffer[index] = data;
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
+        oled_mark_dirty(index, index);
     }
 }
 
@@ -723,7 +785,7 @@ void oled_write_raw_P(const char *data, uint16_t size) {
         uint8_t c = pgm_read_byte(data++);
         if (oled_buffer[i] == c) continue;
         oled_buffer[i] = c;
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
+        oled_mark_dirty(i, i);
     }
 }
 #endif // defined(__AVR__)
@@ -873,7 +935,7 @@ bool oled_scroll_off(void) {
             return oled_scrolling;
         }
         oled_scrolling = false;
-        oled_dirty     = OLED_ALL_BLOCKS_MASK;
+        oled_mark_dirty(0, OLED_MATRIX_SIZE - 1);
     }
     return !oled_scrolling;
 }
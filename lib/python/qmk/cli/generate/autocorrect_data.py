@@ -13,8 +13,8 @@
 # limitations under the License.
 """Python program to make autocorrect_data.h.
 This program reads from a prepared dictionary file and generates a C source file
-"autocorrect_data.h" with a serialized trie embedded as an array. Run this
-program and pass it as the first argument like:
+"autocorrect_data.h" with a serialized Aho-Corasick automaton embedded as an
+array. Run this program and pass it as the first argument like:
 $ qmk generate-autocorrect-data autocorrect_dict.txt
 Each line of the dict file defines one typo and its correction with the syntax
 "typo -> correction". Blank lines or lines starting with '#' are ignored.
@@ -24,10 +24,14 @@ Example:
   lenght        -> length
   ouput         -> output
   widht         -> width
+With --flash, the automaton is written to a binary image for external flash
+instead, and autocorrect_data.h only describes it.
 For full documentation, see QMK Docs
 """
 
 import textwrap
+import zlib
+from collections import deque
 from typing import Any, Dict, Iterator, List, Tuple
 
 from milc import cli
@@ -49,6 +53,20 @@ TYPO_CHARS = dict([
 ] + [(chr(c), c + KC_A - ord('a')) for c in range(ord('a'),
                                                   ord('z') + 1)])  # Characters a-z.
 
+# Bit of each character in the child bitmap of a node, see autocorrect_symbol_bit()
+SYMBOL_BITS = {c: i for i, c in enumerate("abcdefghijklmnopqrstuvwxyz':")}
+
+AUTOCORRECT_FORMAT = 2
+NODE_LEAF = 0x80
+NODE_BITMAP = 0x40
+NODE_FAIL_ROOT = 0x10
+NODE_FAIL_LAST = 0x20  # The root's child for the last typed character
+NODE_CHAIN = 0x08
+NODE_CHAIN_LEAF = 0x04
+SORTED_MAX_CHILDREN = 4
+NODE_READ_SIZE = 8
+FLASH_MAGIC = b'QKAC'
+
 
 def parse_file(file_name: str) -> List[Tuple[str, str]]:
     """Parses autocorrections dictionary file.
@@ -79,9 +97,9 @@ def parse_file(file_name: str) -> List[Tuple[str, str]]:
         correct_words = ('information', 'available', 'international', 'language', 'loosest', 'reference', 'wealthier', 'entertainment', 'association', 'provides', 'technology', 'statehood')
 
     autocorrections = []
-    typos = set()
+    line_numbers = {}
     for line_number, typo, correction in parse_file_lines(file_name):
-        if typo in typos:
+        if typo in line_numbers:
             cli.log.warning('{fg_red}Error:%d:{fg_reset} Ignoring duplicate typo: "{fg_cyan}%s{fg_reset}"', line_number, typo)
             continue
 
@@ -89,39 +107,87 @@ def parse_file(file_name: str) -> List[Tuple[str, str]]:
         if not (all([c in TYPO_CHARS for c in typo])):
             cli.log.error('{fg_red}Error:%d:{fg_reset} Typo "{fg_cyan}%s{fg_reset}" has characters other than a-z, \' and :.', line_number, typo)
             maybe_exit(1)
-        for other_typo in typos:
-            if typo in other_typo or other_typo in typo:
-                cli.log.error('{fg_red}Error:%d:{fg_reset} Typos may not be substrings of one another, otherwise the longer typo would never trigger: "{fg_cyan}%s{fg_reset}" vs. "{fg_cyan}%s{fg_reset}".', line_number, typo, other_typo)
-                maybe_exit(1)
         if len(typo) < 5:
             cli.log.warning('{fg_yellow}Warning:%d:{fg_reset} It is suggested that typos are at least 5 characters long to avoid false triggers: "{fg_cyan}%s{fg_reset}"', line_number, typo)
         if len(typo) > 127:
             cli.log.error('{fg_red}Error:%d:{fg_reset} Typo exceeds 127 chars: "{fg_cyan}%s{fg_reset}"', line_number, typo)
             maybe_exit(1)
 
-        check_typo_against_dictionary(typo, line_number, correct_words)
-
         autocorrections.append((typo, correction))
-        typos.add(typo)
+        line_numbers[typo] = line_number
+
+    # Both checks search with the automaton, so that they stay fast for large
+    # dictionaries.
+    automaton = make_automaton(autocorrections)
+    for typo, other_typo in find_substring_typos(autocorrections, automaton):
+        cli.log.error('{fg_red}Error:%d:{fg_reset} Typos may not be substrings of one another, otherwise the longer typo would never trigger: "{fg_cyan}%s{fg_reset}" vs. "{fg_cyan}%s{fg_reset}".', line_numbers[typo], typo, other_typo)
+        maybe_exit(1)
+    check_typos_against_dictionary(automaton, line_numbers, correct_words)
 
     return autocorrections
 
 
-def make_trie(autocorrections: List[Tuple[str, str]]) -> Dict[str, Any]:
-    """Makes a trie from the the typos, writing in reverse.
+def make_automaton(autocorrections: List[Tuple[str, str]]) -> List[Dict[str, Any]]:
+    """Makes an Aho-Corasick automaton from the typos.
+  Each node is a prefix of one or more typos. A typo ends at its leaf node, and
+  the failure link of a node points to the node of its longest proper suffix.
   Args:
     autocorrections: List of (typo, correction) tuples.
   Returns:
-    Dict of dict, representing the trie.
+    List of nodes, beginning with the root. Each node is a dict with
+    'children' (char to node index), 'fail' (node index), 'leaf'
+    ((typo, correction) or None) and 'depth'.
   """
-    trie = {}
+    nodes = [{'children': {}, 'fail': 0, 'leaf': None, 'depth': 0}]
     for typo, correction in autocorrections:
-        node = trie
-        for letter in typo[::-1]:
-            node = node.setdefault(letter, {})
-        node['LEAF'] = (typo, correction)
-
-    return trie
+        node = 0
+        for letter in typo:
+            if letter not in nodes[node]['children']:
+                nodes[node]['children'][letter] = len(nodes)
+                nodes.append({'children': {}, 'fail': 0, 'leaf': None, 'depth': nodes[node]['depth'] + 1})
+            node = nodes[node]['children'][letter]
+        nodes[node]['leaf'] = (typo, correction)
+
+    # Compute failure links level by level, parents before children.
+    queue = deque([0])
+    while queue:
+        node = queue.popleft()
+        for letter, child in nodes[node]['children'].items():
+            fail = nodes[node]['fail']
+            while fail and letter not in nodes[fail]['children']:
+                fail = nodes[fail]['fail']
+            if node and letter in nodes[fail]['children']:
+                nodes[child]['fail'] = nodes[fail]['children'][letter]
+            queue.append(child)
+
+    return nodes
+
+
+def step(automaton: List[Dict[str, Any]], node: int, letter: str) -> int:
+    """Follows `letter` from `node`, taking failure links where needed."""
+    while node and letter not in automaton[node]['children']:
+        node = automaton[node]['fail']
+    return automaton[node]['children'].get(letter, 0)
+
+
+def find_typos(automaton: List[Dict[str, Any]], text: str) -> Iterator[Tuple[int, str]]:
+    """Yields (end position, typo) for every typo found in `text`."""
+    node = 0
+    for i, letter in enumerate(text):
+        node = step(automaton, node, letter)
+        suffix = node
+        while suffix:
+            if automaton[suffix]['leaf']:
+                yield i + 1, automaton[suffix]['leaf'][0]
+            suffix = automaton[suffix]['fail']
+
+
+def find_substring_typos(autocorrections: List[Tuple[str, str]], automaton: List[Dict[str, Any]]) -> Iterator[Tuple[str, str]]:
+    """Yields (typo, other typo) for every typo that contains another typo."""
+    for typo, _ in autocorrections:
+        for _, other_typo in find_typos(automaton, typo):
+            if other_typo != typo:
+                yield typo, other_typo
 
 
 def parse_file_lines(file_name: str) -> Iterator[Tuple[int, str, str]]:
@@ -145,100 +211,104 @@ def parse_file_lines(file_name: str) -> Iterator[Tuple[int, str, str]]:
             yield line_number, typo, correction
 
 
-def check_typo_against_dictionary(typo: str, line_number: int, correct_words) -> None:
-    """Checks `typo` against English dictionary words."""
-
-    if typo.startswith(':') and typo.endswith(':'):
-        if typo[1:-1] in correct_words:
-            cli.log.warning('{fg_yellow}Warning:%d:{fg_reset} Typo "{fg_cyan}%s{fg_reset}" is a correctly spelled dictionary word.', line_number, typo)
-    elif typo.startswith(':') and not typo.endswith(':'):
-        for word in correct_words:
-            if word.startswith(typo[1:]):
-                cli.log.warning('{fg_yellow}Warning:%d: {fg_reset}Typo "{fg_cyan}%s{fg_reset}" would falsely trigger on correctly spelled word "{fg_cyan}%s{fg_reset}".', line_number, typo, word)
-    elif not typo.startswith(':') and typo.endswith(':'):
-        for word in correct_words:
-            if word.endswith(typo[:-1]):
-                cli.log.warning('{fg_yellow}Warning:%d:{fg_reset} Typo "{fg_cyan}%s{fg_reset}" would falsely trigger on correctly spelled word "{fg_cyan}%s{fg_reset}".', line_number, typo, word)
-    elif not typo.startswith(':') and not typo.endswith(':'):
-        for word in correct_words:
-            if typo in word:
-                cli.log.warning('{fg_yellow}Warning:%d:{fg_reset} Typo "{fg_cyan}%s{fg_reset}" would falsely trigger on correctly spelled word "{fg_cyan}%s{fg_reset}".', line_number, typo, word)
-
-
-def serialize_trie(autocorrections: List[Tuple[str, str]], trie: Dict[str, Any]) -> List[int]:
-    """Serializes trie and correction data in a form readable by the C code.
+def check_typos_against_dictionary(automaton: List[Dict[str, Any]], line_numbers: Dict[str, int], correct_words) -> None:
+    """Checks the typos against English dictionary words.
+  Each word is searched between word breaks, so that ":typo" only matches the
+  start of a word, "typo:" its end and ":typo:" the whole word.
+  """
+    for word in sorted(correct_words):
+        for _, typo in find_typos(automaton, f':{word}:'):
+            if typo.startswith(':') and typo.endswith(':'):
+                cli.log.warning('{fg_yellow}Warning:%d:{fg_reset} Typo "{fg_cyan}%s{fg_reset}" is a correctly spelled dictionary word.', line_numbers[typo], typo)
+            else:
+                cli.log.warning('{fg_yellow}Warning:%d:{fg_reset} Typo "{fg_cyan}%s{fg_reset}" would falsely trigger on correctly spelled word "{fg_cyan}%s{fg_reset}".', line_numbers[typo], typo, word)
+
+
+def serialize_leaf(typo: str, correction: str) -> List[int]:
+    """Serializes the backspaces and replacement text of a typo."""
+    word_boundary_ending = typo[-1] == ':'
+    typo = typo.strip(':')
+    i = 0  # Make the autocorrection data for this entry and serialize it.
+    while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
+        i += 1
+    backspaces = len(typo) - i - 1 + word_boundary_ending
+    assert 0 <= backspaces <= 63
+    return [backspaces + NODE_LEAF] + list(bytes(correction[i:], 'ascii')) + [0]
+
+
+def serialize_automaton(automaton: List[Dict[str, Any]]) -> Tuple[List[int], int]:
+    """Serializes the automaton in a form readable by the C code.
   Args:
-    autocorrections: List of (typo, correction) tuples.
-    trie: Dict of dicts.
+    automaton: List of nodes, see make_automaton().
   Returns:
-    List of ints in the range 0-255.
+    List of ints in the range 0-255, and the size of a node link in bytes.
   """
-    table = []
-
-    # Traverse trie in depth first order.
-    def traverse(trie_node):
-        if 'LEAF' in trie_node:  # Handle a leaf trie node.
-            typo, correction = trie_node['LEAF']
-            word_boundary_ending = typo[-1] == ':'
-            typo = typo.strip(':')
-            i = 0  # Make the autocorrection data for this entry and serialize it.
-            while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
-                i += 1
-            backspaces = len(typo) - i - 1 + word_boundary_ending
-            assert 0 <= backspaces <= 63
-            correction = correction[i:]
-            bs_count = [backspaces + 128]
-            data = bs_count + list(bytes(correction, 'ascii')) + [0]
-
-            entry = {'data': data, 'links': [], 'byte_offset': 0}
-            table.append(entry)
-        elif len(trie_node) == 1:  # Handle trie node with a single child.
-            c, trie_node = next(iter(trie_node.items()))
-            entry = {'chars': c, 'byte_offset': 0}
-
-            # It's common for a trie to have long chains of single-child nodes. We
-            # find the whole chain so that we can serialize it more efficiently.
-            while len(trie_node) == 1 and 'LEAF' not in trie_node:
-                c, trie_node = next(iter(trie_node.items()))
-                entry['chars'] += c
-
-            table.append(entry)
-            entry['links'] = [traverse(trie_node)]
-        else:  # Handle trie node with multiple children.
-            entry = {'chars': ''.join(sorted(trie_node.keys())), 'byte_offset': 0}
-            table.append(entry)
-            entry['links'] = [traverse(trie_node[c]) for c in entry['chars']]
-        return entry
-
-    traverse(trie)
-
-    def serialize(e: Dict[str, Any]) -> List[int]:
-        if not e['links']:  # Handle a leaf table entry.
-            return e['data']
-        elif len(e['links']) == 1:  # Handle a chain table entry.
-            return [TYPO_CHARS[c] for c in e['chars']] + [0]  # + encode_link(e['links'][0]))
-        else:  # Handle a branch table entry.
-            data = []
-            for c, link in zip(e['chars'], e['links']):
-                data += [TYPO_CHARS[c] | (0 if data else 64)] + encode_link(link)
-            return data + [0]
-
-    byte_offset = 0
-    for e in table:  # To encode links, first compute byte offset of each entry.
-        e['byte_offset'] = byte_offset
-        byte_offset += len(serialize(e))
-        assert 0 <= byte_offset <= 0xffff
-
-    return [b for e in table for b in serialize(e)]  # Serialize final table.
-
-
-def encode_link(link: Dict[str, Any]) -> List[int]:
-    """Encodes a node link as two bytes."""
-    byte_offset = link['byte_offset']
-    if not (0 <= byte_offset <= 0xffff):
-        cli.log.error('{fg_red}Error:{fg_reset} The autocorrection table is too large, a node link exceeds 64KB limit. Try reducing the autocorrection dict to fewer entries.')
+    def children(node):
+        if len(node['children']) <= SORTED_MAX_CHILDREN:
+            return sorted(node['children'].items(), key=lambda child: TYPO_CHARS[child[0]])
+        return sorted(node['children'].items(), key=lambda child: SYMBOL_BITS[child[0]])
+
+    # Depth first order, so that the only child of a node can be stored right
+    # after it without a link.
+    order = []
+    stack = [0]
+    while stack:
+        node = stack.pop()
+        order.append(node)
+        stack += [child for _, child in reversed(children(automaton[node]))]
+
+    def encode_link(node, byte_offset, link_size):
+        leaf_flag = 1 << (link_size * 8 - 1)
+        value = byte_offset[node] | (leaf_flag if automaton[node]['leaf'] else 0)
+        return list(value.to_bytes(link_size, 'little'))
+
+    def serialize(node, byte_offset, link_size):
+        if automaton[node]['leaf']:
+            return serialize_leaf(*automaton[node]['leaf'])
+
+        items = children(automaton[node])
+        header = 0
+        data = []
+        fail = automaton[node]['fail']
+        if not fail:
+            header |= NODE_FAIL_ROOT
+        elif automaton[fail]['depth'] == 1:
+            header |= NODE_FAIL_LAST
+        else:
+            data += encode_link(fail, byte_offset, link_size)
+        if len(items) <= SORTED_MAX_CHILDREN:
+            header |= len(items) - 1
+            data += [TYPO_CHARS[c] for c, _ in items]
+        else:
+            header |= NODE_BITMAP
+            data += list(sum(1 << SYMBOL_BITS[c] for c, _ in items).to_bytes(4, 'little'))
+        if len(items) == 1:
+            header |= NODE_CHAIN | (NODE_CHAIN_LEAF if automaton[items[0][1]]['leaf'] else 0)
+        else:
+            for _, child in items:
+                data += encode_link(child, byte_offset, link_size)
+        return [header] + data
+
+    # Use 16-bit links if the table is small enough, 24-bit otherwise. The
+    # highest bit of a link marks links to leaves.
+    for link_size in (2, 3):
+        # To encode links, first compute byte offset of each node. The size of
+        # a node does not depend on the value of its links.
+        no_offsets = [0] * len(automaton)
+        byte_offset = [0] * len(automaton)
+        size = 0
+        for node in order:
+            byte_offset[node] = size
+            size += len(serialize(node, no_offsets, link_size))
+        if size < 1 << (link_size * 8 - 1):
+            break
+    else:
+        cli.log.error('{fg_red}Error:{fg_reset} The autocorrection table is too large, a node link exceeds 8MB limit. Try reducing the autocorrection dict to fewer entries.')
         maybe_exit(1)
-    return [byte_offset & 255, byte_offset >> 8]
+
+    data = [b for node in order for b in serialize(node, byte_offset, link_size)]  # Serialize final table.
+    # Nodes are read NODE_READ_SIZE bytes at a time, pad the last ones.
+    return data + [0] * (NODE_READ_SIZE - 1), link_size
 
 
 def typo_len(e: Tuple[str, str]) -> int:
@@ -253,12 +323,13 @@ def to_hex(b: int) -> str:
 @cli.argument('-kb', '--keyboard', type=keyboard_folder, completer=keyboard_completer, help='The keyboard to build a firmware for. Ignored when a output file is supplied.')
 @cli.argument('-km', '--keymap', completer=keymap_completer, help='The keymap to build a firmware for. Ignored when a output file is supplied.')
 @cli.argument('-o', '--output', arg_only=True, type=normpath, help='File to write to')
+@cli.argument('-f', '--flash', arg_only=True, type=normpath, help='Write the automaton to this binary image for external flash, instead of into the header')
 @cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
 @cli.subcommand('Generate the autocorrection data file from a dictionary file.')
 def generate_autocorrect_data(cli):
     autocorrections = parse_file(cli.args.filename)
-    trie = make_trie(autocorrections)
-    data = serialize_trie(autocorrections, trie)
+    automaton = make_automaton(autocorrections)
+    data, link_size = serialize_automaton(automaton)
 
     current_keyboard = cli.args.keyboard or cli.config.user.keyboard or cli.config.generate_autocorrect_data.keyboard
     current_keymap = cli.args.keymap or cli.config.user.keymap or cli.config.generate_autocorrect_data.keymap
@@ -281,11 +352,28 @@ def generate_autocorrect_data(cli):
     autocorrect_data_h_lines.append('')
     autocorrect_data_h_lines.append(f'#define AUTOCORRECT_MIN_LENGTH {len(min_typo)} // "{min_typo}"')
     autocorrect_data_h_lines.append(f'#define AUTOCORRECT_MAX_LENGTH {len(max_typo)} // "{max_typo}"')
+    autocorrect_data_h_lines.append(f'#define AUTOCORRECT_FORMAT {AUTOCORRECT_FORMAT}')
+    autocorrect_data_h_lines.append(f'#define AUTOCORRECT_LINK_SIZE {link_size}')
     autocorrect_data_h_lines.append(f'#define DICTIONARY_SIZE {len(data)}')
     autocorrect_data_h_lines.append('')
-    autocorrect_data_h_lines.append('static const uint8_t autocorrect_data[DICTIONARY_SIZE] PROGMEM = {')
-    autocorrect_data_h_lines.append(textwrap.fill('    %s' % (', '.join(map(to_hex, data))), width=100, subsequent_indent='    '))
-    autocorrect_data_h_lines.append('};')
+
+    if cli.args.flash:
+        # The image starts with a magic number and a checksum of the data, so
+        # that the firmware can tell whether it matches this header.
+        checksum = zlib.crc32(bytes(data))
+        cli.args.flash.write_bytes(FLASH_MAGIC + checksum.to_bytes(4, 'little') + bytes(data))
+        if not cli.args.quiet:
+            cli.log.info('Wrote the automaton to {fg_cyan}%s{fg_reset}, write it to external flash at AUTOCORRECT_FLASH_ADDRESS.', cli.args.flash)
+
+        max_correction = max(len(correction) for _, correction in autocorrections)
+        autocorrect_data_h_lines.append('// The automaton is stored in external flash, at AUTOCORRECT_FLASH_ADDRESS.')
+        autocorrect_data_h_lines.append('#define AUTOCORRECT_DATA_EXTERNAL')
+        autocorrect_data_h_lines.append(f'#define AUTOCORRECT_DATA_CHECKSUM 0x{checksum:08X}')
+        autocorrect_data_h_lines.append(f'#define AUTOCORRECT_MAX_CORRECTION_LENGTH {max_correction}')
+    else:
+        autocorrect_data_h_lines.append('static const uint8_t autocorrect_data[DICTIONARY_SIZE] PROGMEM = {')
+        autocorrect_data_h_lines.append(textwrap.fill('    %s' % (', '.join(map(to_hex, data))), width=100, subsequent_indent='    '))
+        autocorrect_data_h_lines.append('};')
 
     # Show the results
     dump_lines(cli.args.output, autocorrect_data_h_lines, cli.args.quiet)
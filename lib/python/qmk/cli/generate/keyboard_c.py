@@ -25,6 +25,92 @@ def _gen_led_configs(info_data):
     return lines
 
 
+def _sqrt16(x):
+    """Integer square root, matching lib8tion's sqrt16() on 16-bit input
+    """
+    x &= 0xFFFF
+    if x <= 1:
+        return x
+
+    low = 1
+    hi = 255 if x > 7904 else (x >> 5) + 8
+    while hi >= low:
+        mid = (low + hi) >> 1
+        if mid * mid > x:
+            hi = mid - 1
+        else:
+            if mid == 255:
+                return 255
+            low = mid + 1
+
+    return low - 1
+
+
+def _atan2_8(dy, dx):
+    """Angle approximation, matching lib8tion's atan2_8()
+    """
+    if dy == 0:
+        return 0 if dx >= 0 else 128
+
+    abs_y = abs(dy)
+
+    # C division truncates towards zero
+    def div(a, b):
+        return int(a / b)
+
+    if dx >= 0:
+        a = 32 - div(32 * (dx - abs_y), dx + abs_y)
+    else:
+        a = 96 - div(32 * (dx + abs_y), abs_y - dx)
+
+    # Stored as int8_t, then negated in quadrants III and IV
+    a = ((a + 128) & 0xFF) - 128
+    if dy < 0:
+        a = -a
+    return a & 0xFF
+
+
+def _led_distance(a, b):
+    dx = a[0] - b[0]
+    dy = a[1] - b[1]
+    return _sqrt16(dx * dx + dy * dy)
+
+
+def _gen_led_geometry(info_data, config_type, points, keys):
+    """Precompute polar coordinates and neighbour lists for the LED effects
+    """
+    center = info_data[config_type].get('center_point', [112, 32])
+    radius = info_data[config_type].get('neighbour_radius', 40)
+
+    polar = []
+    neighbour_start = ['0']
+    neighbours = []
+    for index, point in enumerate(points):
+        dx = point[0] - center[0]
+        dy = point[1] - center[1]
+        polar.append(f'{{{_atan2_8(dy, dx)}, {_sqrt16(dx * dx + dy * dy)}}}')
+
+        for other, other_point in enumerate(points):
+            distance = _led_distance(point, other_point)
+            if other != index and distance <= radius:
+                neighbours.append(f'{{{other}, {distance}}}')
+        neighbour_start.append(str(len(neighbours)))
+
+    # Avoid a zero sized array on boards without any neighbours in range
+    if not neighbours:
+        neighbours.append('{NO_LED, 0}')
+
+    lines = []
+    lines.append(f'#ifdef {config_type.upper()}_LED_GEOMETRY')
+    lines.append(f'const led_polar_t g_led_polar[] PROGMEM = {{ {", ".join(polar)} }};')
+    lines.append(f'const led_key_t g_led_key[] PROGMEM = {{ {", ".join(keys)} }};')
+    lines.append(f'const uint16_t g_led_neighbour_start[] PROGMEM = {{ {", ".join(neighbour_start)} }};')
+    lines.append(f'const led_neighbour_t g_led_neighbours[] PROGMEM = {{ {", ".join(neighbours)} }};')
+    lines.append('#endif')
+
+    return lines
+
+
 def _gen_led_config(info_data, config_type):
     """Convert info.json content to g_led_config
     """
@@ -36,14 +122,20 @@ def _gen_led_config(info_data, config_type):
     matrix = [['NO_LED'] * cols for _ in range(rows)]
     pos = []
     flags = []
+    points = []
+    keys = []
 
     led_layout = info_data[config_type]['layout']
     for index, led_data in enumerate(led_layout):
         if 'matrix' in led_data:
             row, col = led_data['matrix']
             matrix[row][col] = str(index)
+            keys.append(f'{{{row}, {col}}}')
+        else:
+            keys.append('{NO_LED, NO_LED}')
         pos.append(f'{{{led_data.get("x", 0)}, {led_data.get("y", 0)}}}')
         flags.append(str(led_data.get('flags', 0)))
+        points.append((led_data.get('x', 0), led_data.get('y', 0)))
 
     if config_type == 'rgb_matrix':
         lines.append('#ifdef RGB_MATRIX_ENABLE')
@@ -60,6 +152,7 @@ def _gen_led_config(info_data, config_type):
     lines.append(f'  {{ {", ".join(pos)} }},')
     lines.append(f'  {{ {", ".join(flags)} }},')
     lines.append('};')
+    lines.extend(_gen_led_geometry(info_data, config_type, points, keys))
     lines.append('#endif')
     lines.append('')
 
@@ -38,3 +38,11 @@ typedef uint8_t pin_t;
 #define gpio_read_pin(pin) ((bool)(PINx_ADDRESS(pin) & _BV((pin) & 0xF)))
 
 #define gpio_toggle_pin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin) & 0xF))
+
+/* Operation of GPIO by port. */
+
+typedef uint8_t gpio_port_t;
+
+#define gpio_pin_port(pin) ((pin) & 0xF0)
+#define gpio_pin_bit(pin) ((pin) & 0xF)
+#define gpio_read_port(port) PINx_ADDRESS(port)
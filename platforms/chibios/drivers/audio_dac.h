@@ -16,6 +16,9 @@
  */
 #pragma once
 
+#include <stdint.h>
+#include <stddef.h>
+
 #ifndef A4
 #    define A4 PAL_LINE(GPIOA, 4)
 #endif
@@ -146,5 +149,20 @@
 
 /**
  *user overridable sample generation/processing
+ * implementing dac_value_generate() replaces the mixer output sample by sample,
+ * overriding dac_value_generate_block() replaces it block by block
  */
+void     dac_value_generate_block(uint16_t *samples, size_t count);
 uint16_t dac_value_generate(void);
+
+#ifdef AUDIO_DRIVER_DAC_ADDITIVE
+#    include "audio_mixer.h"
+
+/**
+ * Play a PCM clip through the additive DAC driver, mixed with any playing tones.
+ * Starts the DAC output if nothing was playing.
+ *
+ * @return false if all clip voices are busy
+ */
+bool audio_dac_play_clip(const audio_mixer_clip_t *clip);
+#endif
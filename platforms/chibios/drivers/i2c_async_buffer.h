@@ -0,0 +1,81 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Space for the transmit payloads of queued I2C transactions, used as a ring:
+ * payloads are reserved at the head and released in the same order. A
+ * payload is never split. When it does not fit before the end of the buffer
+ * it goes to the start instead, once the oldest payload has moved past the
+ * space it needs, and the bytes skipped at the end are released with it.
+ */
+typedef struct i2c_async_buffer_t {
+    uint16_t size; // capacity in bytes
+    uint16_t head; // offset of the next payload
+    uint16_t used; // bytes held by queued payloads, including skipped ones
+} i2c_async_buffer_t;
+
+/**
+ * \brief Find contiguous room for a payload.
+ *
+ * \param buffer The buffer state.
+ * \param length The payload length in bytes.
+ * \param offset Set to where the payload goes.
+ * \param span Set to the bytes to reserve, the payload plus any skipped ones.
+ *
+ * \return false if there is no room until older payloads are released.
+ */
+static inline bool i2c_async_buffer_find(const i2c_async_buffer_t *buffer, uint16_t length, uint16_t *offset, uint16_t *span) {
+    // Nothing queued: start over at the beginning
+    if (buffer->used == 0) {
+        *offset = 0;
+        *span   = length;
+        return length <= buffer->size;
+    }
+    if (buffer->used >= buffer->size) {
+        return false;
+    }
+
+    uint16_t tail = (buffer->head + buffer->size - buffer->used) % buffer->size;
+    if (buffer->head > tail) {
+        // Free space is after the head, and before the tail
+        if (length <= buffer->size - buffer->head) {
+            *offset = buffer->head;
+            *span   = length;
+            return true;
+        }
+        if (length <= tail) {
+            *offset = 0;
+            *span   = buffer->size - buffer->head + length;
+            return true;
+        }
+        return false;
+    }
+
+    // Free space is between the head and the tail
+    if (length <= tail - buffer->head) {
+        *offset = buffer->head;
+        *span   = length;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * \brief Reserve the room found by i2c_async_buffer_find().
+ */
+static inline void i2c_async_buffer_reserve(i2c_async_buffer_t *buffer, uint16_t offset, uint16_t length, uint16_t span) {
+    buffer->head = (offset + length) % buffer->size;
+    buffer->used += span;
+}
+
+/**
+ * \brief Release the oldest payload, given the span it was reserved with.
+ */
+static inline void i2c_async_buffer_release(i2c_async_buffer_t *buffer, uint16_t span) {
+    buffer->used -= span;
+}
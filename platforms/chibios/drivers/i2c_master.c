@@ -29,6 +29,7 @@
 #include "i2c_master.h"
 #include "gpio.h"
 #include "chibios_config.h"
+#include <string.h>
 #include <ch.h>
 #include <hal.h>
 
@@ -128,6 +129,192 @@ static i2c_status_t i2c_epilogue(const msg_t status) {
     return status == MSG_TIMEOUT ? I2C_STATUS_TIMEOUT : I2C_STATUS_ERROR;
 }
 
+#ifdef I2C_ASYNC_ENABLE
+#    include "i2c_async_buffer.h"
+
+#    ifndef I2C_ASYNC_QUEUE_SIZE
+#        define I2C_ASYNC_QUEUE_SIZE 16
+#    endif
+#    ifndef I2C_ASYNC_BUFFER_SIZE
+#        define I2C_ASYNC_BUFFER_SIZE 512
+#    endif
+#    ifndef I2C_ASYNC_THREAD_STACK_SIZE
+#        define I2C_ASYNC_THREAD_STACK_SIZE 512
+#    endif
+
+typedef struct i2c_async_transaction_t {
+    uint8_t              address;
+    uint16_t             tx_offset;
+    uint16_t             tx_length;
+    uint16_t             tx_span; // tx_length plus any bytes skipped to wrap the payload buffer
+    uint8_t*             rx_data;
+    uint16_t             rx_length;
+    uint16_t             timeout;
+    i2c_async_callback_t callback;
+    void*                arg;
+} i2c_async_transaction_t;
+
+static i2c_async_transaction_t i2c_async_queue[I2C_ASYNC_QUEUE_SIZE];
+static uint8_t                 i2c_async_queue_head  = 0; // next slot to fill
+static uint8_t                 i2c_async_queue_tail  = 0; // transaction in flight or next to run
+static uint8_t                 i2c_async_queue_count = 0; // queued transactions, including the one in flight
+
+// Transmit payloads are copied here so callers may reuse their buffers as soon as the call returns.
+static uint8_t            i2c_async_buffer[I2C_ASYNC_BUFFER_SIZE];
+static i2c_async_buffer_t i2c_async_buffer_state = {.size = I2C_ASYNC_BUFFER_SIZE};
+
+static i2c_status_t       i2c_async_error = I2C_STATUS_SUCCESS;
+static semaphore_t        i2c_async_pending;
+static binary_semaphore_t i2c_async_progress;
+static thread_t*          i2c_async_thread = NULL;
+static THD_WORKING_AREA(waI2cAsyncThread, I2C_ASYNC_THREAD_STACK_SIZE);
+
+/**
+ * @brief Runs queued transactions back to back. The thread sleeps while the
+ * peripheral's interrupt/DMA handlers move the data, so the main loop keeps
+ * scanning during the transfer.
+ */
+static THD_FUNCTION(I2cAsyncThread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_async");
+
+    while (true) {
+        chSemWait(&i2c_async_pending);
+
+        i2c_async_transaction_t* transaction = &i2c_async_queue[i2c_async_queue_tail];
+
+        i2cStart(&I2C_DRIVER, &i2cconfig);
+        msg_t        msg    = i2cMasterTransmitTimeout(&I2C_DRIVER, (transaction->address >> 1), &i2c_async_buffer[transaction->tx_offset], transaction->tx_length, transaction->rx_data, transaction->rx_length, TIME_MS2I(transaction->timeout));
+        i2c_status_t status = i2c_epilogue(msg);
+
+        if (transaction->callback) {
+            transaction->callback(status, transaction->arg);
+        }
+
+        chSysLock();
+        if (status != I2C_STATUS_SUCCESS && i2c_async_error == I2C_STATUS_SUCCESS) {
+            i2c_async_error = status;
+        }
+        i2c_async_buffer_release(&i2c_async_buffer_state, transaction->tx_span);
+        i2c_async_queue_tail = (i2c_async_queue_tail + 1) % I2C_ASYNC_QUEUE_SIZE;
+        i2c_async_queue_count--;
+        chBSemSignalI(&i2c_async_progress);
+        chSchRescheduleS();
+        chSysUnlock();
+    }
+}
+
+static i2c_status_t i2c_async_enqueue(uint8_t address, const uint8_t* prefix, uint8_t prefix_length, const uint8_t* data, uint16_t length, uint8_t* rx_data, uint16_t rx_length, uint16_t timeout, i2c_async_callback_t callback, void* arg) {
+    uint16_t tx_length = prefix_length + length;
+    if (tx_length > I2C_ASYNC_BUFFER_SIZE) {
+        return I2C_STATUS_ERROR;
+    }
+
+    if (i2c_async_thread == NULL) {
+        chSemObjectInit(&i2c_async_pending, 0);
+        chBSemObjectInit(&i2c_async_progress, false);
+        i2c_async_thread = chThdCreateStatic(waI2cAsyncThread, sizeof(waI2cAsyncThread), NORMALPRIO + 1, I2cAsyncThread, NULL);
+    }
+
+    // Wait for the I2C thread to free up a slot and contiguous payload space.
+    // Only this function moves the head, so the room found stays valid once
+    // the lock is released.
+    uint16_t  offset = 0;
+    uint16_t  span   = 0;
+    systime_t start  = chVTGetSystemTime();
+    while (true) {
+        chSysLock();
+        bool has_room = i2c_async_queue_count < I2C_ASYNC_QUEUE_SIZE && i2c_async_buffer_find(&i2c_async_buffer_state, tx_length, &offset, &span);
+        chSysUnlock();
+        if (has_room) {
+            break;
+        }
+        if (timeout != I2C_TIMEOUT_INFINITE && chVTTimeElapsedSinceX(start) >= TIME_MS2I(timeout)) {
+            return I2C_STATUS_TIMEOUT;
+        }
+        chBSemWaitTimeout(&i2c_async_progress, TIME_MS2I(1));
+    }
+
+    if (prefix_length) {
+        memcpy(&i2c_async_buffer[offset], prefix, prefix_length);
+    }
+    if (length) {
+        memcpy(&i2c_async_buffer[offset + prefix_length], data, length);
+    }
+
+    i2c_async_transaction_t* transaction = &i2c_async_queue[i2c_async_queue_head];
+    transaction->address                 = address;
+    transaction->tx_offset               = offset;
+    transaction->tx_length               = tx_length;
+    transaction->tx_span                 = span;
+    transaction->rx_data                 = rx_data;
+    transaction->rx_length               = rx_length;
+    transaction->timeout                 = timeout;
+    transaction->callback                = callback;
+    transaction->arg                     = arg;
+    i2c_async_queue_head                 = (i2c_async_queue_head + 1) % I2C_ASYNC_QUEUE_SIZE;
+
+    chSysLock();
+    i2c_async_buffer_reserve(&i2c_async_buffer_state, offset, tx_length, span);
+    i2c_async_queue_count++;
+    chSemSignalI(&i2c_async_pending);
+    chSchRescheduleS();
+    chSysUnlock();
+
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_async_callback_t callback, void* arg) {
+    return i2c_async_enqueue(address, NULL, 0, data, length, NULL, 0, timeout, callback, arg);
+}
+
+i2c_status_t i2c_write_register_async(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_async_callback_t callback, void* arg) {
+    return i2c_async_enqueue(devaddr, &regaddr, 1, data, length, NULL, 0, timeout, callback, arg);
+}
+
+i2c_status_t i2c_read_register_async(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout, i2c_async_callback_t callback, void* arg) {
+    return i2c_async_enqueue(devaddr, &regaddr, 1, NULL, 0, data, length, timeout, callback, arg);
+}
+
+static bool i2c_async_wait_idle(uint16_t timeout) {
+    // Called from a completion callback: the queue cannot drain until it returns.
+    if (i2c_async_thread == NULL || chThdGetSelfX() == i2c_async_thread) {
+        return true;
+    }
+
+    systime_t start = chVTGetSystemTime();
+    while (true) {
+        chSysLock();
+        bool idle = i2c_async_queue_count == 0;
+        chSysUnlock();
+        if (idle) {
+            return true;
+        }
+        if (timeout != I2C_TIMEOUT_INFINITE && chVTTimeElapsedSinceX(start) >= TIME_MS2I(timeout)) {
+            return false;
+        }
+        chBSemWaitTimeout(&i2c_async_progress, TIME_MS2I(1));
+    }
+}
+
+i2c_status_t i2c_wait_all(uint16_t timeout) {
+    if (!i2c_async_wait_idle(timeout)) {
+        return I2C_STATUS_TIMEOUT;
+    }
+
+    chSysLock();
+    i2c_status_t status = i2c_async_error;
+    i2c_async_error     = I2C_STATUS_SUCCESS;
+    chSysUnlock();
+    return status;
+}
+
+// Blocking transfers must not overtake queued ones on the bus.
+#    define i2c_async_barrier() i2c_async_wait_idle(I2C_TIMEOUT_INFINITE)
+#else
+#    define i2c_async_barrier()
+#endif
+
 __attribute__((weak)) void i2c_init(void) {
     static bool is_initialised = false;
     if (!is_initialised) {
@@ -149,24 +336,28 @@ __attribute__((weak)) void i2c_init(void) {
 }
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_barrier();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
     return i2c_epilogue(status);
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_barrier();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (address >> 1), data, length, TIME_MS2I(timeout));
     return i2c_epilogue(status);
 }
 
 i2c_status_t i2c_transmit_and_receive(uint8_t address, const uint8_t* tx_data, uint16_t tx_length, uint8_t* rx_data, uint16_t rx_length, uint16_t timeout) {
+    i2c_async_barrier();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (address >> 1), tx_data, tx_length, rx_data, rx_length, TIME_MS2I(timeout));
     return i2c_epilogue(status);
 }
 
 i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_barrier();
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
     uint8_t complete_packet[length + 1];
@@ -180,6 +371,7 @@ i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t*
 }
 
 i2c_status_t i2c_write_register16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_barrier();
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
     uint8_t complete_packet[length + 2];
@@ -194,12 +386,14 @@ i2c_status_t i2c_write_register16(uint8_t devaddr, uint16_t regaddr, const uint8
 }
 
 i2c_status_t i2c_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_barrier();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (devaddr >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
     return i2c_epilogue(status);
 }
 
 i2c_status_t i2c_read_register16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_barrier();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
     msg_t   status             = i2cMasterTransmitTimeout(&I2C_DRIVER, (devaddr >> 1), register_packet, 2, data, length, TIME_MS2I(timeout));
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "ws2812.h"
 #include "gpio.h"
 #include "util.h"
@@ -113,59 +114,84 @@
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
 #define PREAMBLE_SIZE 4
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+// Without WS2812_SPI_SYNC a frame is encoded into one buffer while DMA sends the other.
+#if defined(WS2812_SPI_USE_CIRCULAR_BUFFER) || defined(WS2812_SPI_SYNC)
+#    define WS2812_SPI_BUFFER_COUNT 1
+#else
+#    define WS2812_SPI_BUFFER_COUNT 2
+#endif
+
+static uint8_t txbuf[WS2812_SPI_BUFFER_COUNT][PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+
+// LEDs whose colour has changed since each buffer was last encoded.
+static uint8_t dirty[WS2812_SPI_BUFFER_COUNT][(WS2812_LED_COUNT + 7) / 8];
 
 /*
  * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
- * the ws2812b protocol, we use this helper function to translate bytes into
- * 0s and 1s for the LED (with the appropriate timing).
+ * the ws2812b protocol, each SPI byte carries two LED bits, MSB first, as
+ * 0b1000 for a 0 and 0b1110 for a 1. A colour byte is expanded one nibble
+ * at a time through this table.
  */
-static uint8_t get_protocol_eq(uint8_t data, int pos) {
-    uint8_t eq = 0;
-    if (data & (1 << (2 * (3 - pos))))
-        eq = 0b1110;
-    else
-        eq = 0b1000;
-    if (data & (2 << (2 * (3 - pos))))
-        eq += 0b11100000;
-    else
-        eq += 0b10000000;
-    return eq;
-}
+#define WS2812_SPI_BIT_PAIR(bits) ((((bits) & 2) ? 0b11100000 : 0b10000000) | (((bits) & 1) ? 0b1110 : 0b1000))
+#define WS2812_SPI_NIBBLE(nibble) {WS2812_SPI_BIT_PAIR((nibble) >> 2), WS2812_SPI_BIT_PAIR((nibble) & 3)}
 
-static void set_led_color_rgb(ws2812_led_t color, int pos) {
-    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
-
-#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.b, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.r, j);
-#endif
-#ifdef WS2812_RGBW
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 3 + j] = get_protocol_eq(color.w, j);
-#endif
+static const uint8_t protocol_eq[16][2] = {
+    WS2812_SPI_NIBBLE(0),  WS2812_SPI_NIBBLE(1),  WS2812_SPI_NIBBLE(2),  WS2812_SPI_NIBBLE(3),  //
+    WS2812_SPI_NIBBLE(4),  WS2812_SPI_NIBBLE(5),  WS2812_SPI_NIBBLE(6),  WS2812_SPI_NIBBLE(7),  //
+    WS2812_SPI_NIBBLE(8),  WS2812_SPI_NIBBLE(9),  WS2812_SPI_NIBBLE(10), WS2812_SPI_NIBBLE(11), //
+    WS2812_SPI_NIBBLE(12), WS2812_SPI_NIBBLE(13), WS2812_SPI_NIBBLE(14), WS2812_SPI_NIBBLE(15), //
+};
+
+// ws2812_led_t is laid out in wire order, so its bytes are sent as they are.
+static void set_led_color_rgb(uint8_t* buffer, const ws2812_led_t* color, int pos) {
+    const uint8_t* src = (const uint8_t*)color;
+    uint8_t*       dst = &buffer[PREAMBLE_SIZE + BYTES_FOR_LED * pos];
+
+    for (int i = 0; i < WS2812_CHANNELS; i++) {
+        const uint8_t* high = protocol_eq[src[i] >> 4];
+        const uint8_t* low  = protocol_eq[src[i] & 0x0F];
+        *dst++              = high[0];
+        *dst++              = high[1];
+        *dst++              = low[0];
+        *dst++              = low[1];
+    }
 }
 
 ws2812_led_t ws2812_leds[WS2812_LED_COUNT];
 
+static uint32_t skipped_frames = 0;
+
+#if WS2812_SPI_BUFFER_COUNT > 1
+static uint8_t       back_buffer = 0;     // the buffer flush() encodes into
+static volatile bool sending     = false; // the other buffer is on the bus
+static volatile bool pending     = false; // the back buffer holds a frame waiting for the bus
+
+static void start_send_i(uint8_t buffer) {
+    sending     = true;
+    back_buffer = buffer ^ 1;
+    spiStartSendI(&WS2812_SPI_DRIVER, sizeof(txbuf[buffer]), txbuf[buffer]);
+}
+
+// Runs from the DMA completion interrupt; starts the frame queued meanwhile, if any.
+static void spi_send_complete_cb(SPIDriver* spip) {
+    (void)spip;
+    chSysLockFromISR();
+    sending = false;
+    if (pending) {
+        pending = false;
+        start_send_i(back_buffer);
+    }
+    chSysUnlockFromISR();
+}
+#    define WS2812_SPI_COMPLETE_CB spi_send_complete_cb
+#else
+#    define WS2812_SPI_COMPLETE_CB NULL
+#endif
+
+uint32_t ws2812_spi_skipped_frames(void) {
+    return skipped_frames;
+}
+
 void ws2812_init(void) {
     palSetLineMode(WS2812_DI_PIN, WS2812_MOSI_OUTPUT_MODE);
 
@@ -180,7 +206,7 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_CIRCULAR == TRUE
         WS2812_SPI_BUFFER_MODE,
 #    endif
-        NULL, // end_cb
+        WS2812_SPI_COMPLETE_CB, // end_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
 #    if defined(WB32F3G71xx) || defined(WB32FQ95xx)
@@ -198,7 +224,7 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_SLAVE_MODE == TRUE
         false,
 #    endif
-        NULL, // data_cb
+        WS2812_SPI_COMPLETE_CB, // data_cb
         NULL, // error_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
@@ -215,21 +241,32 @@ void ws2812_init(void) {
 #endif
     };
 
+    // Every LED must be encoded once before the first frame goes out.
+    memset(dirty, 0xFF, sizeof(dirty));
+
     spiAcquireBus(&WS2812_SPI_DRIVER);     /* Acquire ownership of the bus.    */
     spiStart(&WS2812_SPI_DRIVER, &spicfg); /* Setup transfer parameters.       */
     spiSelect(&WS2812_SPI_DRIVER);         /* Slave Select assertion.          */
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiStartSend(&WS2812_SPI_DRIVER, sizeof(txbuf[0]), txbuf[0]);
 #endif
 }
 
 void ws2812_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    ws2812_led_t led = ws2812_leds[index];
+
     ws2812_leds[index].r = red;
     ws2812_leds[index].g = green;
     ws2812_leds[index].b = blue;
 #if defined(WS2812_RGBW)
     ws2812_rgb_to_rgbw(&ws2812_leds[index]);
 #endif
+
+    if (memcmp(&led, &ws2812_leds[index], sizeof(led)) != 0) {
+        for (int i = 0; i < WS2812_SPI_BUFFER_COUNT; i++) {
+            dirty[i][index / 8] |= 1 << (index % 8);
+        }
+    }
 }
 
 void ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
@@ -238,18 +275,47 @@ void ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
     }
 }
 
+static void encode_dirty_leds(uint8_t buffer) {
+    for (int i = 0; i < WS2812_LED_COUNT; i += 8) {
+        uint8_t bits = dirty[buffer][i / 8];
+        if (!bits) continue;
+        dirty[buffer][i / 8] = 0;
+
+        for (int j = i; bits && j < WS2812_LED_COUNT; j++, bits >>= 1) {
+            if (bits & 1) {
+                set_led_color_rgb(txbuf[buffer], &ws2812_leds[j], j);
+            }
+        }
+    }
+}
+
 void ws2812_flush(void) {
-    for (int i = 0; i < WS2812_LED_COUNT; i++) {
-        set_led_color_rgb(ws2812_leds[i], i);
+#if defined(WS2812_SPI_USE_CIRCULAR_BUFFER)
+    // The buffer is streamed continuously; changes show up on the next pass.
+    encode_dirty_leds(0);
+#elif defined(WS2812_SPI_SYNC)
+    encode_dirty_leds(0);
+    spiSend(&WS2812_SPI_DRIVER, sizeof(txbuf[0]), txbuf[0]);
+#else
+    // Never touch the buffer on the bus: encode into the back buffer and
+    // either start it now or leave it for the completion callback. A frame
+    // still waiting when the next one is flushed is replaced by it.
+    chSysLock();
+    if (pending) {
+        pending = false;
+        skipped_frames++;
     }
+    uint8_t buffer = back_buffer;
+    chSysUnlock();
 
-    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
-#    ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
-#    else
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
-#    endif
+    encode_dirty_leds(buffer);
+
+    chSysLock();
+    if (sending) {
+        pending = true;
+    } else {
+        start_send_i(buffer);
+    }
+    chSysUnlock();
 #endif
 }
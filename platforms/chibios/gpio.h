@@ -43,3 +43,25 @@ typedef ioline_t pin_t;
 #define gpio_read_pin(pin) palReadLine(pin)
 
 #define gpio_toggle_pin(pin) palToggleLine(pin)
+
+/* Operation of GPIO by port. */
+
+typedef ioportid_t gpio_port_t;
+
+#define gpio_pin_port(pin) PAL_PORT(pin)
+#define gpio_pin_bit(pin) PAL_PAD(pin)
+#define gpio_read_port(port) palReadPort(port)
+
+/* Pin change interrupts, callback is a palcallback_t. Pins with the same
+ * interrupt line cannot have one each, e.g. STM32 EXTI lines are shared by
+ * the pins of the same number on every port. */
+
+#if PAL_USE_CALLBACKS == TRUE
+#    define gpio_enable_pin_interrupt(pin, callback)              \
+        do {                                                      \
+            palEnableLineEvent((pin), PAL_EVENT_MODE_BOTH_EDGES); \
+            palSetLineCallback((pin), (callback), NULL);          \
+        } while (0)
+#    define gpio_disable_pin_interrupt(pin) palDisableLineEvent(pin)
+#    define gpio_pin_interrupt_line(pin) PAL_PAD(pin)
+#endif
@@ -0,0 +1,92 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "i2c_async_buffer.h"
+}
+
+class I2cAsyncBuffer : public ::testing::Test {
+   protected:
+    i2c_async_buffer_t buffer = {.size = 64};
+
+    // Reserves a payload, returning its offset, or -1 if there is no room
+    int reserve(uint16_t length, uint16_t *span = nullptr) {
+        uint16_t offset, reserved;
+        if (!i2c_async_buffer_find(&buffer, length, &offset, &reserved)) {
+            return -1;
+        }
+        i2c_async_buffer_reserve(&buffer, offset, length, reserved);
+        if (span) {
+            *span = reserved;
+        }
+        return offset;
+    }
+};
+
+TEST_F(I2cAsyncBuffer, PayloadsFollowEachOther) {
+    EXPECT_EQ(reserve(10), 0);
+    EXPECT_EQ(reserve(20), 10);
+    EXPECT_EQ(reserve(34), 30);
+    EXPECT_EQ(buffer.used, 64);
+    EXPECT_EQ(reserve(1), -1);
+}
+
+TEST_F(I2cAsyncBuffer, EmptyBufferStartsOver) {
+    uint16_t span;
+    EXPECT_EQ(reserve(40, &span), 0);
+    i2c_async_buffer_release(&buffer, span);
+
+    // Larger than the 24 bytes left before the end, but the buffer is empty
+    EXPECT_EQ(reserve(50, &span), 0);
+    EXPECT_EQ(span, 50);
+}
+
+TEST_F(I2cAsyncBuffer, PayloadWrapsOnceTailHasPassed) {
+    uint16_t first, second;
+    EXPECT_EQ(reserve(30, &first), 0);
+    EXPECT_EQ(reserve(20, &second), 30);
+
+    // 14 bytes left before the end, and the start is still taken
+    EXPECT_EQ(reserve(25), -1);
+
+    i2c_async_buffer_release(&buffer, first);
+    uint16_t span;
+    EXPECT_EQ(reserve(25, &span), 0);
+    EXPECT_EQ(span, 14 + 25);
+    EXPECT_EQ(buffer.used, 20 + 14 + 25);
+
+    // The skipped bytes go with the wrapped payload
+    i2c_async_buffer_release(&buffer, second);
+    i2c_async_buffer_release(&buffer, span);
+    EXPECT_EQ(buffer.used, 0);
+}
+
+TEST_F(I2cAsyncBuffer, PayloadLargerThanTheSpaceBeforeTheWrapPoint) {
+    uint16_t first, second;
+    EXPECT_EQ(reserve(50, &first), 0);
+    EXPECT_EQ(reserve(10, &second), 50);
+
+    // Needs more than both the 4 bytes before the end and the offset of the
+    // head, which a check on the total free bytes could never satisfy
+    EXPECT_EQ(reserve(62), -1);
+    i2c_async_buffer_release(&buffer, first);
+    EXPECT_EQ(reserve(62), -1);
+    i2c_async_buffer_release(&buffer, second);
+    EXPECT_EQ(reserve(62), 0);
+}
+
+TEST_F(I2cAsyncBuffer, PayloadFitsBetweenHeadAndTail) {
+    uint16_t first, second, third;
+    EXPECT_EQ(reserve(30, &first), 0);
+    EXPECT_EQ(reserve(30, &second), 30);
+    i2c_async_buffer_release(&buffer, first);
+    EXPECT_EQ(reserve(20, &third), 0);
+    EXPECT_EQ(third, 4 + 20);
+
+    // Head at 20, tail at 30
+    EXPECT_EQ(reserve(11), -1);
+    EXPECT_EQ(reserve(10), 20);
+    EXPECT_EQ(buffer.used, 64);
+}
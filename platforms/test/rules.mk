@@ -23,3 +23,8 @@ eeprom_legacy_emulated_flash_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_legacy_emulated_flash.c
 eeprom_legacy_emulated_flash_tiny_SRC := $(eeprom_legacy_emulated_flash_SRC)
 eeprom_legacy_emulated_flash_large_SRC := $(eeprom_legacy_emulated_flash_SRC)
+
+i2c_async_buffer_INC := $(PLATFORM_PATH)/chibios/drivers/
+
+i2c_async_buffer_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/i2c_async_buffer_tests.cpp
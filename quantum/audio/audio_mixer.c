@@ -0,0 +1,275 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "audio_mixer.h"
+#include "compiler_support.h"
+#include <string.h>
+
+/* one full period each, signed Q15, starting at the zero crossing */
+static const int16_t wavetable_sine[AUDIO_MIXER_WAVETABLE_LENGTH] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285, 32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571,
+    30273, 29956, 29621, 29268, 28898, 28510, 28105, 27683, 27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+    23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868, 18204, 17530, 16846, 16151, 15446, 14732, 14010, 13279,
+    12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179, 6393, 5602, 4808, 4011, 3212, 2410, 1608, 804,
+    0, -804, -1608, -2410, -3212, -4011, -4808, -5602, -6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+    -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790, -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+    -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+    -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683, -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+    -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179, -6393, -5602, -4808, -4011, -3212, -2410, -1608, -804,
+};
+
+static const int16_t wavetable_triangle[AUDIO_MIXER_WAVETABLE_LENGTH] = {
+    0, 512, 1024, 1536, 2048, 2560, 3072, 3584, 4096, 4608, 5120, 5632, 6144, 6656, 7168, 7680,
+    8192, 8704, 9216, 9728, 10240, 10752, 11264, 11776, 12288, 12800, 13312, 13824, 14336, 14848, 15360, 15872,
+    16384, 16895, 17407, 17919, 18431, 18943, 19455, 19967, 20479, 20991, 21503, 22015, 22527, 23039, 23551, 24063,
+    24575, 25087, 25599, 26111, 26623, 27135, 27647, 28159, 28671, 29183, 29695, 30207, 30719, 31231, 31743, 32255,
+    32767, 32255, 31743, 31231, 30719, 30207, 29695, 29183, 28671, 28159, 27647, 27135, 26623, 26111, 25599, 25087,
+    24575, 24063, 23551, 23039, 22527, 22015, 21503, 20991, 20479, 19967, 19455, 18943, 18431, 17919, 17407, 16895,
+    16384, 15872, 15360, 14848, 14336, 13824, 13312, 12800, 12288, 11776, 11264, 10752, 10240, 9728, 9216, 8704,
+    8192, 7680, 7168, 6656, 6144, 5632, 5120, 4608, 4096, 3584, 3072, 2560, 2048, 1536, 1024, 512,
+    0, -512, -1024, -1536, -2048, -2560, -3072, -3584, -4096, -4608, -5120, -5632, -6144, -6656, -7168, -7680,
+    -8192, -8704, -9216, -9728, -10240, -10752, -11264, -11776, -12288, -12800, -13312, -13824, -14336, -14848, -15360, -15872,
+    -16384, -16895, -17407, -17919, -18431, -18943, -19455, -19967, -20479, -20991, -21503, -22015, -22527, -23039, -23551, -24063,
+    -24575, -25087, -25599, -26111, -26623, -27135, -27647, -28159, -28671, -29183, -29695, -30207, -30719, -31231, -31743, -32255,
+    -32767, -32255, -31743, -31231, -30719, -30207, -29695, -29183, -28671, -28159, -27647, -27135, -26623, -26111, -25599, -25087,
+    -24575, -24063, -23551, -23039, -22527, -22015, -21503, -20991, -20479, -19967, -19455, -18943, -18431, -17919, -17407, -16895,
+    -16384, -15872, -15360, -14848, -14336, -13824, -13312, -12800, -12288, -11776, -11264, -10752, -10240, -9728, -9216, -8704,
+    -8192, -7680, -7168, -6656, -6144, -5632, -5120, -4608, -4096, -3584, -3072, -2560, -2048, -1536, -1024, -512,
+};
+
+static const int16_t wavetable_square[AUDIO_MIXER_WAVETABLE_LENGTH] = {
+    0, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    0, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+};
+
+static const int16_t wavetable_trapezoid[AUDIO_MIXER_WAVETABLE_LENGTH] = {
+    0, 1024, 2048, 3072, 4096, 5120, 6144, 7168, 8192, 9216, 10240, 11264, 12288, 13312, 14336, 15360,
+    16384, 17407, 18431, 19455, 20479, 21503, 22527, 23551, 24575, 25599, 26623, 27647, 28671, 29695, 30719, 31743,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 31743, 30719, 29695, 28671, 27647, 26623, 25599, 24575, 23551, 22527, 21503, 20479, 19455, 18431, 17407,
+    16384, 15360, 14336, 13312, 12288, 11264, 10240, 9216, 8192, 7168, 6144, 5120, 4096, 3072, 2048, 1024,
+    0, -1024, -2048, -3072, -4096, -5120, -6144, -7168, -8192, -9216, -10240, -11264, -12288, -13312, -14336, -15360,
+    -16384, -17407, -18431, -19455, -20479, -21503, -22527, -23551, -24575, -25599, -26623, -27647, -28671, -29695, -30719, -31743,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -31743, -30719, -29695, -28671, -27647, -26623, -25599, -24575, -23551, -22527, -21503, -20479, -19455, -18431, -17407,
+    -16384, -15360, -14336, -13312, -12288, -11264, -10240, -9216, -8192, -7168, -6144, -5120, -4096, -3072, -2048, -1024,
+};
+
+static const int16_t *const wavetable_bank[AUDIO_MIXER_WAVE_COUNT] = {
+    [AUDIO_MIXER_WAVE_SINE]      = wavetable_sine,
+    [AUDIO_MIXER_WAVE_TRIANGLE]  = wavetable_triangle,
+    [AUDIO_MIXER_WAVE_SQUARE]    = wavetable_square,
+    [AUDIO_MIXER_WAVE_TRAPEZOID] = wavetable_trapezoid,
+};
+
+// phase is a 0.32 fixed-point fraction of one period, the top bits index the wavetable
+#define WAVETABLE_INDEX_SHIFT (32 - 8)
+STATIC_ASSERT(AUDIO_MIXER_WAVETABLE_LENGTH == (1 << (32 - WAVETABLE_INDEX_SHIFT)), "wavetable length does not match the phase index width");
+
+typedef struct {
+    uint32_t phase;
+    uint32_t increment;
+} tone_voice_t;
+
+typedef struct {
+    const int8_t *samples;
+    uint32_t      position;  // 16.16 fixed-point sample index
+    uint32_t      increment; // 16.16 fixed-point step per output sample
+    uint16_t      length;
+} clip_voice_t;
+
+static tone_voice_t tone_voices[AUDIO_MIXER_TONE_VOICES];
+static uint8_t      tone_voice_count = 0;
+static clip_voice_t clip_voices[AUDIO_MIXER_CLIP_VOICES];
+
+static const int16_t *wavetable        = wavetable_sine;
+static uint32_t       mixer_rate       = 1;
+static float          phase_per_hz     = 0.0f;
+static int32_t        output_center    = 0;
+static int32_t        output_amplitude = 0;
+static uint16_t       output_off       = 0;
+
+/* Q8 gain applied to the sum of all voices, so that the mix is normalized by the
+ * number of active voices - same as the division in the previous per-sample synthesis */
+static volatile int32_t mix_gain = 0;
+
+static uint8_t clip_voices_active(void) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < AUDIO_MIXER_CLIP_VOICES; i++) {
+        if (clip_voices[i].samples) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void update_gain(void) {
+    uint8_t voices = tone_voice_count + clip_voices_active();
+    mix_gain       = voices ? (256 / voices) : 0;
+}
+
+void audio_mixer_init(uint32_t sample_rate, uint16_t sample_max, uint16_t off_value) {
+    mixer_rate       = sample_rate ? sample_rate : 1;
+    phase_per_hz     = 4294967296.0f / (float)mixer_rate;
+    output_center    = (sample_max + 1) / 2;
+    output_amplitude = sample_max / 2;
+    output_off       = off_value;
+
+    memset(tone_voices, 0, sizeof(tone_voices));
+    memset(clip_voices, 0, sizeof(clip_voices));
+    tone_voice_count = 0;
+    update_gain();
+}
+
+void audio_mixer_reset(void) {
+    for (uint8_t i = 0; i < AUDIO_MIXER_TONE_VOICES; i++) {
+        tone_voices[i].phase = 0;
+    }
+}
+
+void audio_mixer_set_waveform(audio_mixer_wave_t wave) {
+    if (wave < AUDIO_MIXER_WAVE_COUNT) {
+        wavetable = wavetable_bank[wave];
+    }
+}
+
+void audio_mixer_set_tones(const float *frequencies, uint8_t count) {
+    uint8_t voices = 0;
+    for (uint8_t i = 0; i < count && voices < AUDIO_MIXER_TONE_VOICES; i++) {
+        // disregard 'rest' notes, they would only lower the resulting volume
+        if (frequencies[i] > 0.0f) {
+            tone_voices[voices++].increment = (uint32_t)(frequencies[i] * phase_per_hz);
+        }
+    }
+    tone_voice_count = voices;
+    update_gain();
+}
+
+bool audio_mixer_play_clip(const audio_mixer_clip_t *clip) {
+    if (!clip || !clip->samples || !clip->length) {
+        return false;
+    }
+    for (uint8_t i = 0; i < AUDIO_MIXER_CLIP_VOICES; i++) {
+        clip_voice_t *voice = &clip_voices[i];
+        if (voice->samples) {
+            continue;
+        }
+        voice->position  = 0;
+        voice->increment = ((uint32_t)clip->sample_rate << 16) / mixer_rate;
+        voice->length    = clip->length;
+        // setting the sample pointer last hands the voice over to the renderer,
+        // keep the compiler from moving the stores above past it
+        __asm__ volatile("" ::: "memory");
+        voice->samples = clip->samples;
+        update_gain();
+        return true;
+    }
+    return false;
+}
+
+void audio_mixer_stop_clips(void) {
+    for (uint8_t i = 0; i < AUDIO_MIXER_CLIP_VOICES; i++) {
+        clip_voices[i].samples = NULL;
+    }
+    update_gain();
+}
+
+uint8_t audio_mixer_active_voices(void) {
+    return tone_voice_count + clip_voices_active();
+}
+
+bool audio_mixer_is_playing_clip(void) {
+    return clip_voices_active() > 0;
+}
+
+static void render_tone(int32_t *acc, size_t count, tone_voice_t *voice) {
+    const int16_t *table     = wavetable;
+    uint32_t       phase     = voice->phase;
+    const uint32_t increment = voice->increment;
+
+    for (size_t i = 0; i < count; i++) {
+        acc[i] += table[phase >> WAVETABLE_INDEX_SHIFT];
+        phase += increment;
+    }
+    voice->phase = phase;
+}
+
+// returns false once the clip ran out of samples
+static bool render_clip(int32_t *acc, size_t count, clip_voice_t *voice) {
+    const int8_t  *samples   = voice->samples;
+    uint32_t       position  = voice->position;
+    const uint32_t increment = voice->increment;
+    const uint32_t end       = (uint32_t)voice->length << 16;
+
+    for (size_t i = 0; i < count; i++) {
+        if (position >= end) {
+            return false;
+        }
+        acc[i] += (int32_t)samples[position >> 16] * 256;
+        position += increment;
+    }
+    voice->position = position;
+    return true;
+}
+
+void audio_mixer_render(uint16_t *buffer, size_t count) {
+    int32_t acc[AUDIO_MIXER_CHUNK_SIZE];
+
+    while (count) {
+        size_t chunk = count < AUDIO_MIXER_CHUNK_SIZE ? count : AUDIO_MIXER_CHUNK_SIZE;
+
+        if (mix_gain == 0) {
+            for (size_t i = 0; i < chunk; i++) {
+                buffer[i] = output_off;
+            }
+        } else {
+            memset(acc, 0, chunk * sizeof(acc[0]));
+
+            for (uint8_t v = 0; v < tone_voice_count; v++) {
+                render_tone(acc, chunk, &tone_voices[v]);
+            }
+            for (uint8_t v = 0; v < AUDIO_MIXER_CLIP_VOICES; v++) {
+                if (clip_voices[v].samples && !render_clip(acc, chunk, &clip_voices[v])) {
+                    clip_voices[v].samples = NULL;
+                    update_gain();
+                }
+            }
+
+            const int32_t gain = mix_gain;
+            for (size_t i = 0; i < chunk; i++) {
+                int32_t value = output_center + ((((acc[i] * gain) >> 8) * output_amplitude) >> 15);
+                buffer[i]     = value < 0 ? 0 : (uint16_t)value;
+            }
+        }
+
+        buffer += chunk;
+        count -= chunk;
+    }
+}
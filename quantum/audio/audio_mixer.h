@@ -0,0 +1,131 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+  Audio mixer
+
+  hardware agnostic, fixed-point block renderer used by the additive DAC driver.
+  Tones are synthesised from a bank of fixed-size wavetables, each voice keeping
+  its own 32bit phase accumulator, and short signed 8bit PCM clips (stored in
+  flash) can be mixed on top of them.
+
+  Samples are rendered a block at a time into the DAC buffer, so the per-sample
+  cost is a table lookup and an add per voice - no floating point in the ISR.
+*/
+
+/**
+ * Number of entries of each wavetable in the bank. The top bits of the phase
+ * accumulator are used as the index, so this has to stay a power of two.
+ */
+#define AUDIO_MIXER_WAVETABLE_LENGTH 256
+
+/**
+ * Number of simultaneous wavetable voices.
+ */
+#ifndef AUDIO_MIXER_TONE_VOICES
+#    ifdef AUDIO_MAX_SIMULTANEOUS_TONES
+#        define AUDIO_MIXER_TONE_VOICES AUDIO_MAX_SIMULTANEOUS_TONES
+#    else
+#        define AUDIO_MIXER_TONE_VOICES 8
+#    endif
+#endif
+
+/**
+ * Number of PCM clips that can be played back at the same time.
+ */
+#ifndef AUDIO_MIXER_CLIP_VOICES
+#    define AUDIO_MIXER_CLIP_VOICES 2
+#endif
+
+/**
+ * Samples rendered per inner pass; bounds the stack used by the renderer.
+ */
+#ifndef AUDIO_MIXER_CHUNK_SIZE
+#    define AUDIO_MIXER_CHUNK_SIZE 32
+#endif
+
+typedef enum {
+    AUDIO_MIXER_WAVE_SINE,
+    AUDIO_MIXER_WAVE_TRIANGLE,
+    AUDIO_MIXER_WAVE_SQUARE,
+    AUDIO_MIXER_WAVE_TRAPEZOID,
+    AUDIO_MIXER_WAVE_COUNT,
+} audio_mixer_wave_t;
+
+/**
+ * A short PCM sound, mono signed 8bit samples.
+ *
+ * Clips are played back at their own sample rate, resampled (nearest neighbour)
+ * to the mixer output rate. At most 65535 samples are supported per clip.
+ */
+typedef struct {
+    const int8_t *samples;
+    uint16_t      length;
+    uint16_t      sample_rate;
+} audio_mixer_clip_t;
+
+/**
+ * \brief Initialize the mixer.
+ *
+ * \param sample_rate effective output rate, in Hz, at which the render function is consumed
+ * \param sample_max the highest output value; the output is centered on half of it
+ * \param off_value value rendered while no voice is active
+ */
+void audio_mixer_init(uint32_t sample_rate, uint16_t sample_max, uint16_t off_value);
+
+/**
+ * \brief Reset the phase of all tone voices. Clips keep playing.
+ */
+void audio_mixer_reset(void);
+
+/**
+ * \brief Select the wavetable used by all tone voices.
+ */
+void audio_mixer_set_waveform(audio_mixer_wave_t wave);
+
+/**
+ * \brief Replace the set of playing tones.
+ *
+ * Voices keep their phase across calls, so a changed frequency does not introduce
+ * a discontinuity. Frequencies <= 0 (rests) are skipped.
+ *
+ * \param frequencies array of frequencies in Hz
+ * \param count number of entries, anything above AUDIO_MIXER_TONE_VOICES is dropped
+ */
+void audio_mixer_set_tones(const float *frequencies, uint8_t count);
+
+/**
+ * \brief Start playing a PCM clip.
+ *
+ * Call with the renderer locked out if it runs from an interrupt.
+ *
+ * \return false if all clip voices are busy
+ */
+bool audio_mixer_play_clip(const audio_mixer_clip_t *clip);
+
+/**
+ * \brief Stop all playing clips.
+ */
+void audio_mixer_stop_clips(void);
+
+/**
+ * \brief Number of tone voices plus playing clips.
+ */
+uint8_t audio_mixer_active_voices(void);
+
+/**
+ * \brief Whether any clip is still playing.
+ */
+bool audio_mixer_is_playing_clip(void);
+
+/**
+ * \brief Render the next block of samples.
+ *
+ * Safe to call from the DAC ISR; the output is in the range [0, sample_max].
+ */
+void audio_mixer_render(uint16_t *buffer, size_t count);
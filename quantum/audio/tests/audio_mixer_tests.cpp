@@ -0,0 +1,153 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "audio/audio_mixer.h"
+}
+
+static const uint32_t SAMPLE_RATE = 24576;
+static const uint16_t SAMPLE_MAX  = 4095;
+static const uint16_t OFF_VALUE   = SAMPLE_MAX / 2;
+static const uint16_t CENTER      = (SAMPLE_MAX + 1) / 2;
+
+class AudioMixerTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        audio_mixer_init(SAMPLE_RATE, SAMPLE_MAX, OFF_VALUE);
+        audio_mixer_set_waveform(AUDIO_MIXER_WAVE_SINE);
+    }
+
+    std::vector<uint16_t> render(size_t count) {
+        std::vector<uint16_t> buffer(count);
+        audio_mixer_render(buffer.data(), count);
+        return buffer;
+    }
+
+    static size_t rising_crossings(const std::vector<uint16_t> &samples) {
+        size_t crossings = 0;
+        for (size_t i = 1; i < samples.size(); i++) {
+            if (samples[i - 1] < CENTER && samples[i] >= CENTER) {
+                crossings++;
+            }
+        }
+        return crossings;
+    }
+};
+
+TEST_F(AudioMixerTest, SilentWithoutVoices) {
+    auto samples = render(100);
+    for (auto sample : samples) {
+        EXPECT_EQ(sample, OFF_VALUE);
+    }
+    EXPECT_EQ(audio_mixer_active_voices(), 0);
+}
+
+TEST_F(AudioMixerTest, ToneFrequency) {
+    float frequency = 440.0f;
+    audio_mixer_set_tones(&frequency, 1);
+
+    // one second of output
+    auto samples = render(SAMPLE_RATE);
+    EXPECT_NEAR(rising_crossings(samples), 440, 1);
+}
+
+TEST_F(AudioMixerTest, ToneStaysInRange) {
+    float frequency = 1000.0f;
+    audio_mixer_set_tones(&frequency, 1);
+
+    auto     samples = render(SAMPLE_RATE / 10);
+    uint16_t lowest  = SAMPLE_MAX;
+    uint16_t highest = 0;
+    for (auto sample : samples) {
+        lowest  = std::min(lowest, sample);
+        highest = std::max(highest, sample);
+    }
+    EXPECT_LE(highest, SAMPLE_MAX);
+    EXPECT_GT(highest, SAMPLE_MAX - SAMPLE_MAX / 50);
+    EXPECT_LT(lowest, SAMPLE_MAX / 50);
+}
+
+TEST_F(AudioMixerTest, ChordIsNormalized) {
+    float frequencies[] = {261.63f, 329.63f, 392.0f, 523.25f};
+    audio_mixer_set_tones(frequencies, 4);
+    EXPECT_EQ(audio_mixer_active_voices(), 4);
+
+    auto samples = render(SAMPLE_RATE);
+    for (auto sample : samples) {
+        EXPECT_LE(sample, SAMPLE_MAX);
+    }
+}
+
+TEST_F(AudioMixerTest, RestsAreSkipped) {
+    float frequencies[] = {0.0f, 440.0f, -1.0f};
+    audio_mixer_set_tones(frequencies, 3);
+    EXPECT_EQ(audio_mixer_active_voices(), 1);
+
+    auto samples = render(SAMPLE_RATE);
+    EXPECT_NEAR(rising_crossings(samples), 440, 1);
+}
+
+TEST_F(AudioMixerTest, PhaseIsKeptAcrossToneChanges) {
+    float frequency = 500.0f;
+    audio_mixer_set_tones(&frequency, 1);
+    render(7);
+
+    // same tone again: the waveform continues where it left off
+    audio_mixer_set_tones(&frequency, 1);
+    auto second = render(1);
+
+    audio_mixer_init(SAMPLE_RATE, SAMPLE_MAX, OFF_VALUE);
+    audio_mixer_set_tones(&frequency, 1);
+    auto reference = render(8);
+    EXPECT_EQ(second[0], reference[7]);
+}
+
+TEST_F(AudioMixerTest, ClipPlaysToCompletion) {
+    static const int8_t      pcm[] = {127, 127, 127, 127, -128, -128, -128, -128};
+    const audio_mixer_clip_t clip  = {.samples = pcm, .length = sizeof(pcm), .sample_rate = (uint16_t)SAMPLE_RATE};
+
+    EXPECT_TRUE(audio_mixer_play_clip(&clip));
+    EXPECT_TRUE(audio_mixer_is_playing_clip());
+
+    auto samples = render(sizeof(pcm));
+    EXPECT_GT(samples[0], CENTER);
+    EXPECT_LT(samples[4], CENTER);
+
+    // rendering past the end releases the clip voice and goes silent
+    samples = render(4);
+    EXPECT_FALSE(audio_mixer_is_playing_clip());
+    EXPECT_EQ(render(1)[0], OFF_VALUE);
+}
+
+TEST_F(AudioMixerTest, ClipIsResampled) {
+    static int8_t pcm[64];
+    for (auto &sample : pcm) {
+        sample = 100;
+    }
+    const audio_mixer_clip_t clip = {.samples = pcm, .length = sizeof(pcm), .sample_rate = (uint16_t)(SAMPLE_RATE / 2)};
+
+    EXPECT_TRUE(audio_mixer_play_clip(&clip));
+    // half the sample rate, twice the duration
+    render(2 * sizeof(pcm) - 1);
+    EXPECT_TRUE(audio_mixer_is_playing_clip());
+    render(2);
+    EXPECT_FALSE(audio_mixer_is_playing_clip());
+}
+
+TEST_F(AudioMixerTest, ClipVoicesAreLimited) {
+    static const int8_t      pcm[] = {1, 2, 3, 4};
+    const audio_mixer_clip_t clip  = {.samples = pcm, .length = sizeof(pcm), .sample_rate = (uint16_t)SAMPLE_RATE};
+
+    for (int i = 0; i < AUDIO_MIXER_CLIP_VOICES; i++) {
+        EXPECT_TRUE(audio_mixer_play_clip(&clip));
+    }
+    EXPECT_FALSE(audio_mixer_play_clip(&clip));
+
+    audio_mixer_stop_clips();
+    EXPECT_FALSE(audio_mixer_is_playing_clip());
+    EXPECT_TRUE(audio_mixer_play_clip(&clip));
+}
@@ -0,0 +1,5 @@
+audio_mixer_DEFS := -DAUDIO_MIXER_TONE_VOICES=8 -DAUDIO_MIXER_CLIP_VOICES=2
+
+audio_mixer_SRC := \
+	$(QUANTUM_PATH)/audio/tests/audio_mixer_tests.cpp \
+	$(QUANTUM_PATH)/audio/audio_mixer.c
@@ -15,6 +15,7 @@
  */
 
 #include "color.h"
+#include "compiler_support.h"
 #include "led_tables.h"
 #include "progmem.h"
 #include "util.h"
@@ -53,7 +54,8 @@ rgb_t hsv_to_rgb_impl(hsv_t hsv, bool use_cie) {
     v = hsv.v;
 #endif
 
-    region    = h * 6 / 255;
+    // h * 6 / 255, without a division: exact for every h * 6 up to 1530
+    region    = (h * 6 + 1 + (h * 6 >> 8)) >> 8;
     remainder = (h * 2 - region * 85) * 3;
 
     p = (v * (255 - s)) >> 8;
@@ -108,3 +110,41 @@ rgb_t hsv_to_rgb(hsv_t hsv) {
 rgb_t hsv_to_rgb_nocie(hsv_t hsv) {
     return hsv_to_rgb_impl(hsv, false);
 }
+
+#if HSV_TO_RGB_CACHE_SIZE > 0
+STATIC_ASSERT((HSV_TO_RGB_CACHE_SIZE & (HSV_TO_RGB_CACHE_SIZE - 1)) == 0, "HSV_TO_RGB_CACHE_SIZE must be a power of two");
+
+typedef struct PACKED hsv_to_rgb_cache_entry_t {
+    hsv_t hsv;
+    rgb_t rgb;
+} hsv_to_rgb_cache_entry_t;
+
+// Zero initialised entries are valid: black converts to black with or
+// without the CIE curve.
+static hsv_to_rgb_cache_entry_t hsv_to_rgb_cache[HSV_TO_RGB_CACHE_SIZE];
+#endif
+
+rgb_t hsv_to_rgb_cached(hsv_t hsv) {
+#if HSV_TO_RGB_CACHE_SIZE > 0
+    hsv_to_rgb_cache_entry_t *entry = &hsv_to_rgb_cache[(hsv.h ^ hsv.s ^ hsv.v) & (HSV_TO_RGB_CACHE_SIZE - 1)];
+    if (entry->hsv.h == hsv.h && entry->hsv.s == hsv.s && entry->hsv.v == hsv.v) {
+        return entry->rgb;
+    }
+    rgb_t rgb  = hsv_to_rgb(hsv);
+    entry->hsv = hsv;
+    entry->rgb = rgb;
+    return rgb;
+#else
+    return hsv_to_rgb(hsv);
+#endif
+}
+
+void hsv_to_rgb_batch(const hsv_t *hsv, rgb_t *rgb, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        if (i > 0 && hsv[i].h == hsv[i - 1].h && hsv[i].s == hsv[i - 1].s && hsv[i].v == hsv[i - 1].v) {
+            rgb[i] = rgb[i - 1];
+        } else {
+            rgb[i] = hsv_to_rgb_cached(hsv[i]);
+        }
+    }
+}
@@ -93,5 +93,31 @@ typedef struct PACKED hsv_t {
 // DEPRECATED
 typedef hsv_t HSV;
 
+// Number of conversions remembered by the memoised functions below; must be a
+// power of two, or 0 to disable memoisation.
+#ifndef HSV_TO_RGB_CACHE_SIZE
+#    define HSV_TO_RGB_CACHE_SIZE 8
+#endif
+
 rgb_t hsv_to_rgb(hsv_t hsv);
 rgb_t hsv_to_rgb_nocie(hsv_t hsv);
+
+/**
+ * \brief Memoised hsv_to_rgb().
+ *
+ * Recent conversions are kept in a small direct-mapped cache, so effects that
+ * give many LEDs the same colour only pay for the conversion once.
+ */
+rgb_t hsv_to_rgb_cached(hsv_t hsv);
+
+/**
+ * \brief Convert an array of colours with hsv_to_rgb().
+ *
+ * Runs of identical colours are converted once, and other colours go through
+ * the cache used by hsv_to_rgb_cached().
+ *
+ * \param hsv The colours to convert.
+ * \param rgb The buffer to write `count` converted colours to.
+ * \param count The number of colours to convert.
+ */
+void hsv_to_rgb_batch(const hsv_t *hsv, rgb_t *rgb, uint16_t count);
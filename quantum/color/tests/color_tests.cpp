@@ -0,0 +1,89 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "color.h"
+}
+
+// The conversion as it was before the division was removed from the region
+// calculation, without the CIE curve.
+static rgb_t reference_hsv_to_rgb(hsv_t hsv) {
+    if (hsv.s == 0) {
+        return (rgb_t){hsv.v, hsv.v, hsv.v};
+    }
+
+    uint16_t h = hsv.h, s = hsv.s, v = hsv.v;
+    uint8_t  region    = h * 6 / 255;
+    uint8_t  remainder = (h * 2 - region * 85) * 3;
+    uint8_t  p         = (v * (255 - s)) >> 8;
+    uint8_t  q         = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    uint8_t  t         = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            return (rgb_t){(uint8_t)v, t, p};
+        case 1:
+            return (rgb_t){q, (uint8_t)v, p};
+        case 2:
+            return (rgb_t){p, (uint8_t)v, t};
+        case 3:
+            return (rgb_t){p, q, (uint8_t)v};
+        case 4:
+            return (rgb_t){t, p, (uint8_t)v};
+        default:
+            return (rgb_t){(uint8_t)v, p, q};
+    }
+}
+
+static bool rgb_equal(rgb_t a, rgb_t b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+class ColorTest : public ::testing::Test {};
+
+TEST_F(ColorTest, MatchesReferenceConversion) {
+    for (uint16_t h = 0; h < 256; h++) {
+        for (uint16_t s = 0; s < 256; s++) {
+            for (uint16_t v = 0; v < 256; v += 17) {
+                hsv_t hsv = {(uint8_t)h, (uint8_t)s, (uint8_t)v};
+                ASSERT_TRUE(rgb_equal(hsv_to_rgb_nocie(hsv), reference_hsv_to_rgb(hsv))) << "h=" << h << " s=" << s << " v=" << v;
+            }
+        }
+    }
+}
+
+TEST_F(ColorTest, CachedMatchesUncached) {
+    // Go round twice so that the second pass is served from the cache
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint16_t h = 0; h < 256; h += 3) {
+            for (uint16_t s = 0; s < 256; s += 5) {
+                hsv_t hsv = {(uint8_t)h, (uint8_t)s, (uint8_t)(255 - h)};
+                ASSERT_TRUE(rgb_equal(hsv_to_rgb_cached(hsv), hsv_to_rgb(hsv)));
+            }
+        }
+    }
+}
+
+TEST_F(ColorTest, BatchMatchesScalar) {
+    hsv_t hsv[120];
+    rgb_t rgb[120];
+
+    for (uint8_t i = 0; i < 120; i++) {
+        // Runs of repeated colours mixed with distinct ones
+        hsv[i] = (hsv_t){(uint8_t)((i / 4) * 9), (uint8_t)(255 - i), (uint8_t)(i % 3 ? 200 : i * 2)};
+    }
+    hsv_to_rgb_batch(hsv, rgb, 120);
+
+    for (uint8_t i = 0; i < 120; i++) {
+        EXPECT_TRUE(rgb_equal(rgb[i], hsv_to_rgb(hsv[i]))) << "led " << (int)i;
+    }
+}
+
+TEST_F(ColorTest, BatchOfZeroIsNoop) {
+    rgb_t rgb = {1, 2, 3};
+    hsv_to_rgb_batch(nullptr, &rgb, 0);
+    EXPECT_TRUE(rgb_equal(rgb, (rgb_t){1, 2, 3}));
+}
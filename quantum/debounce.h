@@ -16,3 +16,25 @@
 bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed);
 
 void debounce_init(void);
+
+#ifdef DEBOUNCE_STATS_ENABLE
+/*
+ * Statistics for diagnosing chattering switches, kept by the per-key (*_pk)
+ * algorithms when DEBOUNCE_STATS_ENABLE is defined.
+ */
+
+/**
+ * @brief Returns the largest number of keys that were debouncing at the same time.
+ */
+uint16_t debounce_stats_peak_active(void);
+
+/**
+ * @brief Returns how often a key changed state again while it was still debouncing, up to 255.
+ */
+uint8_t debounce_stats_bounces(uint8_t row, uint8_t col);
+
+/**
+ * @brief Resets the statistics.
+ */
+void debounce_stats_clear(void);
+#endif
@@ -0,0 +1,111 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Unordered list of the keys whose counter is running, for the *_pk debounce
+// algorithms, so that updating the counters only visits those keys instead of
+// the whole matrix. debounce_active_mask holds the same keys as a bitmap per
+// row. Included by exactly one debounce algorithm.
+
+#pragma once
+
+#include <string.h>
+#include "matrix.h"
+#include "bitwise.h"
+
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+} debounce_active_key_t;
+
+// Uses MATRIX_ROWS_PER_HAND instead of MATRIX_ROWS to support split keyboards
+static debounce_active_key_t debounce_active_keys[MATRIX_ROWS_PER_HAND * MATRIX_COLS];
+static uint16_t              debounce_active_count;
+static matrix_row_t          debounce_active_mask[MATRIX_ROWS_PER_HAND];
+
+#ifdef DEBOUNCE_STATS_ENABLE
+static uint16_t     debounce_peak_active;
+static uint8_t      debounce_bounces[MATRIX_ROWS_PER_HAND * MATRIX_COLS];
+static matrix_row_t debounce_last_raw[MATRIX_ROWS_PER_HAND];
+#endif
+
+/**
+ * @brief Adds a key to the active list. The key must not be in it already.
+ */
+static inline void debounce_active_add(uint8_t row, uint8_t col) {
+    debounce_active_mask[row] |= MATRIX_ROW_SHIFTER << col;
+    debounce_active_keys[debounce_active_count++] = (debounce_active_key_t){row, col};
+#ifdef DEBOUNCE_STATS_ENABLE
+    if (debounce_active_count > debounce_peak_active) {
+        debounce_peak_active = debounce_active_count;
+    }
+#endif
+}
+
+/**
+ * @brief Removes the key at position i of the active list, moving the last key into its place.
+ */
+static inline void debounce_active_remove_at(uint16_t i) {
+    debounce_active_key_t key = debounce_active_keys[i];
+
+    debounce_active_mask[key.row] &= ~(MATRIX_ROW_SHIFTER << key.col);
+    debounce_active_keys[i] = debounce_active_keys[--debounce_active_count];
+}
+
+/**
+ * @brief Removes a key from the active list.
+ */
+static inline void debounce_active_remove(uint8_t row, uint8_t col) {
+    for (uint16_t i = 0; i < debounce_active_count; i++) {
+        if (debounce_active_keys[i].row == row && debounce_active_keys[i].col == col) {
+            debounce_active_remove_at(i);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Returns the highest column set in bits and clears it.
+ */
+static inline uint8_t debounce_next_col(matrix_row_t *bits) {
+    uint8_t col = biton32(*bits);
+    *bits &= ~(MATRIX_ROW_SHIFTER << col);
+    return col;
+}
+
+/**
+ * @brief Counts the raw changes of keys that are still debouncing, when statistics are enabled.
+ *
+ * Must be called with every changed raw matrix, before the counters are started or stopped.
+ */
+static inline void debounce_active_count_bounces(matrix_row_t raw[]) {
+#ifdef DEBOUNCE_STATS_ENABLE
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        matrix_row_t bounced   = (raw[row] ^ debounce_last_raw[row]) & debounce_active_mask[row];
+        debounce_last_raw[row] = raw[row];
+
+        while (bounced) {
+            uint16_t index = row * MATRIX_COLS + debounce_next_col(&bounced);
+            if (debounce_bounces[index] < UINT8_MAX) {
+                debounce_bounces[index]++;
+            }
+        }
+    }
+#else
+    (void)raw;
+#endif
+}
+
+#ifdef DEBOUNCE_STATS_ENABLE
+uint16_t debounce_stats_peak_active(void) {
+    return debounce_peak_active;
+}
+
+uint8_t debounce_stats_bounces(uint8_t row, uint8_t col) {
+    return row < MATRIX_ROWS_PER_HAND && col < MATRIX_COLS ? debounce_bounces[row * MATRIX_COLS + col] : 0;
+}
+
+void debounce_stats_clear(void) {
+    debounce_peak_active = debounce_active_count;
+    memset(debounce_bounces, 0, sizeof(debounce_bounces));
+}
+#endif
@@ -24,6 +24,8 @@
 #define DEBOUNCE_ELAPSED 0
 
 #if DEBOUNCE > 0
+#    include "active_keys.h"
+
 typedef struct {
     bool    pressed : 1;
     uint8_t time : 7;
@@ -63,6 +65,9 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
             last_time = timer_read_fast();
         }
 
+        if (changed) {
+            debounce_active_count_bounces(raw);
+        }
         transfer_matrix_values(raw, cooked);
     }
 
@@ -72,54 +77,52 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
 /**
  * @brief Processes per-key debounce counters and updates the debounced matrix state.
  *
- * This function iterates through each key in the matrix and updates its debounce counter
- * based on the elapsed time. If the debounce period has expired, the debounced state is
- * updated accordingly for key-down (eager) and key-up (defer) events.
+ * This function iterates through the keys with a running debounce counter and updates it
+ * based on the elapsed time. If the debounce period has expired, the key leaves the active
+ * list and the debounced state is updated accordingly for key-down (eager) and key-up (defer)
+ * events.
  *
  * @param raw The current raw key state matrix.
  * @param cooked The debounced key state matrix to be updated.
  * @param elapsed_time The time elapsed since the last debounce update, in milliseconds.
  */
 static inline void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time) {
-    counters_need_update = false;
-    matrix_need_update   = false;
-
-    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
-        uint16_t row_offset = row * MATRIX_COLS;
-
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            uint16_t index = row_offset + col;
+    matrix_need_update = false;
 
-            if (debounce_counters[index].time != DEBOUNCE_ELAPSED) {
-                if (debounce_counters[index].time <= elapsed_time) {
-                    debounce_counters[index].time = DEBOUNCE_ELAPSED;
-
-                    if (debounce_counters[index].pressed) {
-                        // key-down: eager
-                        matrix_need_update = true;
-                    } else {
-                        // key-up: defer
-                        matrix_row_t col_mask    = (MATRIX_ROW_SHIFTER << col);
-                        matrix_row_t cooked_next = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
-                        cooked_changed |= cooked_next ^ cooked[row];
-                        cooked[row] = cooked_next;
-                    }
-                } else {
-                    debounce_counters[index].time -= elapsed_time;
-                    counters_need_update = true;
-                }
+    for (uint16_t i = 0; i < debounce_active_count;) {
+        debounce_active_key_t key   = debounce_active_keys[i];
+        uint16_t              index = key.row * MATRIX_COLS + key.col;
+
+        if (debounce_counters[index].time <= elapsed_time) {
+            debounce_counters[index].time = DEBOUNCE_ELAPSED;
+
+            if (debounce_counters[index].pressed) {
+                // key-down: eager
+                matrix_need_update = true;
+            } else {
+                // key-up: defer
+                matrix_row_t col_mask    = (MATRIX_ROW_SHIFTER << key.col);
+                matrix_row_t cooked_next = (cooked[key.row] & ~col_mask) | (raw[key.row] & col_mask);
+                cooked_changed |= cooked_next ^ cooked[key.row];
+                cooked[key.row] = cooked_next;
             }
+            debounce_active_remove_at(i);
+        } else {
+            debounce_counters[index].time -= elapsed_time;
+            i++;
         }
     }
+    counters_need_update = debounce_active_count > 0;
 }
 
 /**
  * @brief Applies debounced changes to the matrix state based on per-key counters.
  *
  * This function compares the raw and cooked key state matrices to detect changes.
- * For each key, it updates the debounce counter and the debounced state according
- * to the debounce algorithm. Key-down events are handled eagerly, while key-up
- * events are deferred until the debounce period has elapsed.
+ * Changed keys whose debounce counter has elapsed start it; key-down events are
+ * handled eagerly, while key-up events are deferred until the debounce period has
+ * elapsed. Key-up counters of keys that went back to their debounced state are
+ * cleared. Only those keys are visited.
  *
  * @param raw The current raw key state matrix.
  * @param cooked The debounced key state matrix to be updated.
@@ -130,28 +133,33 @@ static inline void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooke
     for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
         uint16_t     row_offset = row * MATRIX_COLS;
         matrix_row_t delta      = raw[row] ^ cooked[row];
+        matrix_row_t start      = delta & ~debounce_active_mask[row];
+        matrix_row_t cancel     = debounce_active_mask[row] & ~delta;
+
+        while (start) {
+            uint8_t  col     = debounce_next_col(&start);
+            uint16_t index   = row_offset + col;
+            bool     pressed = raw[row] & (MATRIX_ROW_SHIFTER << col);
+
+            debounce_counters[index].pressed = pressed;
+            debounce_counters[index].time    = DEBOUNCE;
+            debounce_active_add(row, col);
+            counters_need_update = true;
+
+            if (pressed) {
+                // key-down: eager
+                cooked[row] ^= MATRIX_ROW_SHIFTER << col;
+                cooked_changed = true;
+            }
+        }
+        while (cancel) {
+            uint8_t  col   = debounce_next_col(&cancel);
+            uint16_t index = row_offset + col;
 
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            uint16_t     index    = row_offset + col;
-            matrix_row_t col_mask = (MATRIX_ROW_SHIFTER << col);
-
-            if (delta & col_mask) {
-                if (debounce_counters[index].time == DEBOUNCE_ELAPSED) {
-                    debounce_counters[index].pressed = (raw[row] & col_mask);
-                    debounce_counters[index].time    = DEBOUNCE;
-                    counters_need_update             = true;
-
-                    if (debounce_counters[index].pressed) {
-                        // key-down: eager
-                        cooked[row] ^= col_mask;
-                        cooked_changed = true;
-                    }
-                }
-            } else if (debounce_counters[index].time != DEBOUNCE_ELAPSED) {
-                if (!debounce_counters[index].pressed) {
-                    // key-up: defer
-                    debounce_counters[index].time = DEBOUNCE_ELAPSED;
-                }
+            if (!debounce_counters[index].pressed) {
+                // key-up: defer
+                debounce_counters[index].time = DEBOUNCE_ELAPSED;
+                debounce_active_remove(row, col);
             }
         }
     }
@@ -0,0 +1,132 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Asymetric per-key algorithm, with the same behaviour as asym_eager_defer_pk.
+// Uses vertical counters so that a whole row is updated at once.
+// After pressing a key, it immediately changes state, with no further inputs
+// accepted until DEBOUNCE milliseconds have occurred. After releasing a key,
+// that state is pushed after no changes occur for DEBOUNCE milliseconds.
+
+#include "debounce.h"
+#include "timer.h"
+#include "util.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 127ms
+#if DEBOUNCE > 127
+#    undef DEBOUNCE
+#    define DEBOUNCE 127
+#endif
+
+#if DEBOUNCE > 0
+#    include "vertical_counter.h"
+
+// Uses MATRIX_ROWS_PER_HAND instead of MATRIX_ROWS to support split keyboards
+static debounce_vc_row_t debounce_counters[MATRIX_ROWS_PER_HAND];
+// Keys whose counter was started by a key-down
+static matrix_row_t debounce_pressed[MATRIX_ROWS_PER_HAND];
+static bool         counters_need_update;
+static bool         matrix_need_update;
+static bool         cooked_changed;
+
+static inline void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time);
+static inline void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[]);
+
+void debounce_init(void) {}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
+    static fast_timer_t last_time;
+    bool                updated_last = false;
+    cooked_changed                   = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+
+        if (elapsed_time > 0) {
+            // Update debounce counters with elapsed timer clamped to 127 (maximum debounce)
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, MIN(elapsed_time, 127));
+        }
+    }
+
+    if (changed || matrix_need_update) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        transfer_matrix_values(raw, cooked);
+    }
+
+    return cooked_changed;
+}
+
+/**
+ * @brief Processes per-key debounce counters and updates the debounced matrix state.
+ *
+ * Counts down every running counter of a row at once. Expired key-up counters push the raw
+ * state (defer), expired key-down counters mark the matrix for update (eager).
+ *
+ * @param raw The current raw key state matrix.
+ * @param cooked The debounced key state matrix to be updated.
+ * @param elapsed_time The time elapsed since the last debounce update, in milliseconds.
+ */
+static inline void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time) {
+    counters_need_update = false;
+    matrix_need_update   = false;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        matrix_row_t expired = debounce_vc_elapse(&debounce_counters[row], elapsed_time);
+
+        // key-down: eager
+        matrix_need_update |= (expired & debounce_pressed[row]) != 0;
+
+        // key-up: defer
+        matrix_row_t deferred    = expired & ~debounce_pressed[row];
+        matrix_row_t cooked_next = (cooked[row] & ~deferred) | (raw[row] & deferred);
+        cooked_changed |= cooked_next ^ cooked[row];
+        cooked[row] = cooked_next;
+
+        counters_need_update |= debounce_vc_active(&debounce_counters[row]) != 0;
+    }
+}
+
+/**
+ * @brief Applies debounced changes to the matrix state based on per-key counters.
+ *
+ * Keys that changed and are not counting start their counters, and key-downs are pushed
+ * immediately. Key-up counters of keys that went back to their debounced state are stopped.
+ *
+ * @param raw The current raw key state matrix.
+ * @param cooked The debounced key state matrix to be updated.
+ */
+static inline void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[]) {
+    matrix_need_update = false;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        matrix_row_t delta  = raw[row] ^ cooked[row];
+        matrix_row_t active = debounce_vc_active(&debounce_counters[row]);
+        matrix_row_t start  = delta & ~active;
+
+        debounce_pressed[row] = (debounce_pressed[row] & ~start) | (raw[row] & start);
+        debounce_vc_load(&debounce_counters[row], start);
+        counters_need_update |= start != 0;
+
+        // key-down: eager
+        matrix_row_t eager = start & raw[row];
+        cooked[row] ^= eager;
+        cooked_changed |= eager != 0;
+
+        // key-up: defer
+        debounce_vc_clear(&debounce_counters[row], ~delta & active & ~debounce_pressed[row]);
+    }
+}
+
+#else
+#    include "none.c"
+#endif
@@ -23,6 +23,8 @@
 #define DEBOUNCE_ELAPSED 0
 
 #if DEBOUNCE > 0
+#    include "active_keys.h"
+
 typedef uint8_t debounce_counter_t;
 // Uses MATRIX_ROWS_PER_HAND instead of MATRIX_ROWS to support split keyboards
 static debounce_counter_t debounce_counters[MATRIX_ROWS_PER_HAND * MATRIX_COLS] = {DEBOUNCE_ELAPSED};
@@ -57,6 +59,7 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
             last_time = timer_read_fast();
         }
 
+        debounce_active_count_bounces(raw);
         start_debounce_counters(raw, cooked);
     }
 
@@ -66,44 +69,40 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
 /**
  * @brief Updates debounce counters and transfers debounced key states if the debounce period has expired.
  *
- * Iterates through each key in the matrix and checks its debounce counter. If the debounce period has expired
- * for a key, the debounced state is updated to match the raw state. Otherwise, the debounce counter is decremented
- * by the elapsed time and marked for further updates.
+ * Iterates through the keys with a running debounce counter. If the debounce period has expired
+ * for a key, the debounced state is updated to match the raw state and the key leaves the active
+ * list. Otherwise, the debounce counter is decremented by the elapsed time.
  *
  * @param raw The current raw key state matrix.
  * @param cooked The debounced key state matrix to be updated.
  * @param elapsed_time The time elapsed since the last debounce update, in milliseconds.
  */
 static inline void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time) {
-    counters_need_update = false;
-    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
-        uint16_t row_offset = row * MATRIX_COLS;
-
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            uint16_t index = row_offset + col;
-
-            if (debounce_counters[index] != DEBOUNCE_ELAPSED) {
-                if (debounce_counters[index] <= elapsed_time) {
-                    debounce_counters[index] = DEBOUNCE_ELAPSED;
-                    matrix_row_t col_mask    = (MATRIX_ROW_SHIFTER << col);
-                    matrix_row_t cooked_next = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
-                    cooked_changed |= cooked[row] ^ cooked_next;
-                    cooked[row] = cooked_next;
-                } else {
-                    debounce_counters[index] -= elapsed_time;
-                    counters_need_update = true;
-                }
-            }
+    for (uint16_t i = 0; i < debounce_active_count;) {
+        debounce_active_key_t key   = debounce_active_keys[i];
+        uint16_t              index = key.row * MATRIX_COLS + key.col;
+
+        if (debounce_counters[index] <= elapsed_time) {
+            debounce_counters[index] = DEBOUNCE_ELAPSED;
+            matrix_row_t col_mask    = (MATRIX_ROW_SHIFTER << key.col);
+            matrix_row_t cooked_next = (cooked[key.row] & ~col_mask) | (raw[key.row] & col_mask);
+            cooked_changed |= cooked[key.row] ^ cooked_next;
+            cooked[key.row] = cooked_next;
+            debounce_active_remove_at(i);
+        } else {
+            debounce_counters[index] -= elapsed_time;
+            i++;
         }
     }
+    counters_need_update = debounce_active_count > 0;
 }
 
 /**
  * @brief Initializes debounce counters for keys with changed states.
  *
- * For each key in the matrix, this function checks if the raw state differs from the debounced state.
- * If a change is detected and the debounce counter has elapsed, the counter is set to the debounce period
- * and marked for update. Otherwise, the counter is cleared.
+ * Keys whose raw state differs from the debounced state and whose debounce counter has elapsed
+ * get their counter set to the debounce period. Keys that went back to their debounced state
+ * before their counter elapsed have it cleared. Only those keys are visited.
  *
  * @param raw The current raw key state matrix.
  * @param cooked The debounced key state matrix.
@@ -112,20 +111,21 @@ static inline void start_debounce_counters(matrix_row_t raw[], matrix_row_t cook
     for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
         uint16_t     row_offset = row * MATRIX_COLS;
         matrix_row_t delta      = raw[row] ^ cooked[row];
+        matrix_row_t start      = delta & ~debounce_active_mask[row];
+        matrix_row_t cancel     = debounce_active_mask[row] & ~delta;
 
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            uint16_t index = row_offset + col;
-
-            if (delta & (MATRIX_ROW_SHIFTER << col)) {
-                if (debounce_counters[index] == DEBOUNCE_ELAPSED) {
-                    debounce_counters[index] = DEBOUNCE;
-                    counters_need_update     = true;
-                }
-            } else {
-                debounce_counters[index] = DEBOUNCE_ELAPSED;
-            }
+        while (start) {
+            uint8_t col                         = debounce_next_col(&start);
+            debounce_counters[row_offset + col] = DEBOUNCE;
+            debounce_active_add(row, col);
+        }
+        while (cancel) {
+            uint8_t col                         = debounce_next_col(&cancel);
+            debounce_counters[row_offset + col] = DEBOUNCE_ELAPSED;
+            debounce_active_remove(row, col);
         }
     }
+    counters_need_update = debounce_active_count > 0;
 }
 
 #else
@@ -36,6 +36,8 @@ No further inputs are accepted until DEBOUNCE milliseconds have occurred.
 #define DEBOUNCE_ELAPSED 0
 
 #if DEBOUNCE > 0
+#    include "active_keys.h"
+
 typedef uint8_t debounce_counter_t;
 // Uses MATRIX_ROWS_PER_HAND instead of MATRIX_ROWS to support split keyboards
 static debounce_counter_t debounce_counters[MATRIX_ROWS_PER_HAND * MATRIX_COLS] = {DEBOUNCE_ELAPSED};
@@ -71,6 +73,9 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
             last_time = timer_read_fast();
         }
 
+        if (changed) {
+            debounce_active_count_bounces(raw);
+        }
         transfer_matrix_values(raw, cooked);
     }
 
@@ -80,41 +85,36 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
 /**
  * @brief Updates per-key debounce counters and determines if matrix needs updating.
  *
- * Iterates through each key in the matrix and checks its debounce counter. If the debounce
- * period has elapsed, the counter is reset and the matrix is marked for update. Otherwise,
- * the counter is decremented by the elapsed time and marked for further updates if needed.
+ * Iterates through the keys with a running debounce counter. If the debounce period has
+ * elapsed, the key leaves the active list and the matrix is marked for update. Otherwise,
+ * the counter is decremented by the elapsed time.
  *
  * @param elapsed_time The time elapsed since the last debounce update, in milliseconds.
  */
 static inline void update_debounce_counters(uint8_t elapsed_time) {
-    counters_need_update = false;
-    matrix_need_update   = false;
+    matrix_need_update = false;
 
-    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
-        uint16_t row_offset = row * MATRIX_COLS;
-
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            uint16_t index = row_offset + col;
-
-            if (debounce_counters[index] != DEBOUNCE_ELAPSED) {
-                if (debounce_counters[index] <= elapsed_time) {
-                    debounce_counters[index] = DEBOUNCE_ELAPSED;
-                    matrix_need_update       = true;
-                } else {
-                    debounce_counters[index] -= elapsed_time;
-                    counters_need_update = true;
-                }
-            }
+    for (uint16_t i = 0; i < debounce_active_count;) {
+        debounce_active_key_t key   = debounce_active_keys[i];
+        uint16_t              index = key.row * MATRIX_COLS + key.col;
+
+        if (debounce_counters[index] <= elapsed_time) {
+            debounce_counters[index] = DEBOUNCE_ELAPSED;
+            matrix_need_update       = true;
+            debounce_active_remove_at(i);
+        } else {
+            debounce_counters[index] -= elapsed_time;
+            i++;
         }
     }
+    counters_need_update = debounce_active_count > 0;
 }
 
 /**
  * @brief Transfers debounced key states from the raw matrix to the cooked matrix.
  *
- * For each key in the matrix, this function checks if its state has changed and if its
- * debounce counter has elapsed. If so, the debounce counter is reset, the cooked matrix
- * is updated to reflect the new state, and the matrix is marked for further updates.
+ * Keys whose state has changed and whose debounce counter has elapsed are flipped in the
+ * cooked matrix and start their debounce counter. Only those keys are visited.
  *
  * @param raw The current raw key state matrix.
  * @param cooked The debounced key state matrix to be updated.
@@ -123,24 +123,19 @@ static inline void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooke
     matrix_need_update = false;
 
     for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
-        uint16_t     row_offset   = row * MATRIX_COLS;
-        matrix_row_t delta        = raw[row] ^ cooked[row];
-        matrix_row_t existing_row = cooked[row];
-
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            uint16_t index = row_offset + col;
-
-            matrix_row_t col_mask = (MATRIX_ROW_SHIFTER << col);
-            if (delta & col_mask) {
-                if (debounce_counters[index] == DEBOUNCE_ELAPSED) {
-                    debounce_counters[index] = DEBOUNCE;
-                    counters_need_update     = true;
-                    existing_row ^= col_mask; // flip the bit.
-                    cooked_changed = true;
-                }
-            }
+        uint16_t     row_offset = row * MATRIX_COLS;
+        matrix_row_t flip       = (raw[row] ^ cooked[row]) & ~debounce_active_mask[row];
+
+        if (flip) {
+            cooked[row] ^= flip;
+            cooked_changed       = true;
+            counters_need_update = true;
+        }
+        while (flip) {
+            uint8_t col                         = debounce_next_col(&flip);
+            debounce_counters[row_offset + col] = DEBOUNCE;
+            debounce_active_add(row, col);
         }
-        cooked[row] = existing_row;
     }
 }
 
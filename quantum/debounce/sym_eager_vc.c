@@ -0,0 +1,108 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Basic symmetric per-key algorithm, with the same behaviour as sym_eager_pk.
+// Uses vertical counters so that a whole row is updated at once.
+// On any state change, the key changes state immediately, followed by DEBOUNCE
+// milliseconds of no further input for that key.
+
+#include "debounce.h"
+#include "timer.h"
+#include "util.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#if DEBOUNCE > 0
+#    include "vertical_counter.h"
+
+// Uses MATRIX_ROWS_PER_HAND instead of MATRIX_ROWS to support split keyboards
+static debounce_vc_row_t debounce_counters[MATRIX_ROWS_PER_HAND];
+static bool              counters_need_update;
+static bool              matrix_need_update;
+static bool              cooked_changed;
+
+static inline void update_debounce_counters(uint8_t elapsed_time);
+static inline void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[]);
+
+void debounce_init(void) {}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
+    static fast_timer_t last_time;
+    bool                updated_last = false;
+    cooked_changed                   = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+
+        if (elapsed_time > 0) {
+            // Update debounce counters with elapsed timer clamped to UINT8_MAX
+            update_debounce_counters(MIN(elapsed_time, UINT8_MAX));
+        }
+    }
+
+    if (changed || matrix_need_update) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        transfer_matrix_values(raw, cooked);
+    }
+
+    return cooked_changed;
+}
+
+/**
+ * @brief Updates per-key debounce counters and determines if matrix needs updating.
+ *
+ * Counts down every running counter of a row at once. If any counter expires, the matrix
+ * is marked for update so that changes held back during the debounce period are picked up.
+ *
+ * @param elapsed_time The time elapsed since the last debounce update, in milliseconds.
+ */
+static inline void update_debounce_counters(uint8_t elapsed_time) {
+    counters_need_update = false;
+    matrix_need_update   = false;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        matrix_need_update |= debounce_vc_elapse(&debounce_counters[row], elapsed_time) != 0;
+        counters_need_update |= debounce_vc_active(&debounce_counters[row]) != 0;
+    }
+}
+
+/**
+ * @brief Transfers debounced key states from the raw matrix to the cooked matrix.
+ *
+ * Keys that changed and are not counting are flipped immediately and start their counters.
+ *
+ * @param raw The current raw key state matrix.
+ * @param cooked The debounced key state matrix to be updated.
+ */
+static inline void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[]) {
+    matrix_need_update = false;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        matrix_row_t flip  = delta & ~debounce_vc_active(&debounce_counters[row]);
+
+        debounce_vc_load(&debounce_counters[row], flip);
+        cooked[row] ^= flip;
+        counters_need_update |= flip != 0;
+        cooked_changed |= flip != 0;
+    }
+}
+
+#else
+#    include "none.c"
+#endif
@@ -0,0 +1,8 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Builds asym_eager_defer_vc under its own name, so that the benchmark can link every algorithm.
+
+#define debounce_init asym_eager_defer_vc_init
+#define debounce asym_eager_defer_vc
+#include "asym_eager_defer_vc.c"
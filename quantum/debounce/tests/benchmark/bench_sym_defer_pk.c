@@ -0,0 +1,8 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Builds sym_defer_pk under its own name, so that the benchmark can link every algorithm.
+
+#define debounce_init sym_defer_pk_init
+#define debounce sym_defer_pk
+#include "sym_defer_pk.c"
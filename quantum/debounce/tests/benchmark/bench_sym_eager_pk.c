@@ -0,0 +1,8 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Builds sym_eager_pk under its own name, so that the benchmark can link every algorithm.
+
+#define debounce_init sym_eager_pk_init
+#define debounce sym_eager_pk
+#include "sym_eager_pk.c"
@@ -0,0 +1,8 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Builds sym_eager_vc under its own name, so that the benchmark can link every algorithm.
+
+#define debounce_init sym_eager_vc_init
+#define debounce sym_eager_vc
+#include "sym_eager_vc.c"
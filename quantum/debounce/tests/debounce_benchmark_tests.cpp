@@ -0,0 +1,124 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+extern "C" {
+#include "matrix.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+#define DEBOUNCE_ALGORITHM(name)                \
+    void name##_init(void);                     \
+    bool name(matrix_row_t raw[], matrix_row_t cooked[], bool changed);
+
+DEBOUNCE_ALGORITHM(sym_defer_pk)
+DEBOUNCE_ALGORITHM(sym_defer_vc)
+DEBOUNCE_ALGORITHM(sym_eager_pk)
+DEBOUNCE_ALGORITHM(sym_eager_vc)
+DEBOUNCE_ALGORITHM(asym_eager_defer_pk)
+DEBOUNCE_ALGORITHM(asym_eager_defer_vc)
+}
+
+typedef bool (*debounce_t)(matrix_row_t raw[], matrix_row_t cooked[], bool changed);
+
+struct Algorithm {
+    const char *name;
+    debounce_t  pk;
+    debounce_t  vc;
+};
+
+static const Algorithm algorithms[] = {
+    {"sym_defer", sym_defer_pk, sym_defer_vc},
+    {"sym_eager", sym_eager_pk, sym_eager_vc},
+    {"asym_eager_defer", asym_eager_defer_pk, asym_eager_defer_vc},
+};
+
+// Raw matrix for every scan of a workload, with contacts that chatter for a
+// few milliseconds after each change
+class Workload {
+   public:
+    Workload(uint8_t presses_per_second, uint8_t chatter) : presses_per_second_(presses_per_second), chatter_(chatter) {}
+
+    bool next(matrix_row_t raw[]) {
+        bool changed = false;
+
+        if (presses_per_second_ && random() % 1000 < presses_per_second_) {
+            uint8_t row = random() % MATRIX_ROWS;
+            uint8_t col = random() % MATRIX_COLS;
+            stable_[row] ^= (matrix_row_t)1 << col;
+            bouncing_[row] |= (matrix_row_t)1 << col;
+            bounce_left_ = chatter_;
+        }
+
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            matrix_row_t next = stable_[row];
+            if (bounce_left_) {
+                next ^= bouncing_[row] & (matrix_row_t)random();
+            } else {
+                bouncing_[row] = 0;
+            }
+            changed |= next != raw[row];
+            raw[row] = next;
+        }
+        if (bounce_left_) {
+            bounce_left_--;
+        }
+        return changed;
+    }
+
+   private:
+    uint32_t random() {
+        seed_ = seed_ * 1103515245 + 12345;
+        return seed_ >> 8;
+    }
+
+    uint8_t      presses_per_second_;
+    uint8_t      chatter_;
+    uint8_t      bounce_left_ = 0;
+    uint32_t     seed_        = 1;
+    matrix_row_t stable_[MATRIX_ROWS]   = {0};
+    matrix_row_t bouncing_[MATRIX_ROWS] = {0};
+};
+
+static const int scans = 200000;
+
+// Scan at 1 kHz, hashing every cooked matrix into `trace` so that
+// algorithms can be compared.
+static void run(debounce_t debounce, Workload workload, uint64_t *trace) {
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+
+    set_time(7777);
+    for (int scan = 0; scan < scans; scan++) {
+        bool changed = workload.next(raw);
+        debounce(raw, cooked, changed);
+
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            *trace = (*trace ^ cooked[row]) * 0x100000001B3;
+        }
+        advance_time(1);
+    }
+
+    // Release everything and let the counters run out for the next run
+    memset(raw, 0, sizeof(raw));
+    for (int scan = 0; scan < 4 * DEBOUNCE; scan++) {
+        debounce(raw, cooked, scan == 0);
+        advance_time(1);
+    }
+}
+
+// The vertical counters have to produce the same cooked matrix as the
+// per-key counters, scan for scan.
+TEST(DebounceBenchmark, Equivalence) {
+    for (auto &algorithm : algorithms) {
+        uint64_t pk = 0, vc = 0;
+        run(algorithm.pk, Workload(200, 4), &pk);
+        run(algorithm.vc, Workload(200, 4), &vc);
+        EXPECT_EQ(pk, vc) << algorithm.name;
+    }
+}
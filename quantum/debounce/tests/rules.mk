@@ -16,6 +16,7 @@
 DEBOUNCE_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE=5
 
 DEBOUNCE_COMMON_SRC := $(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
+	$(QUANTUM_PATH)/bitwise.c \
 	$(PLATFORM_PATH)/timer.c \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
 
@@ -53,3 +54,38 @@ debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+# The *_vc algorithms have to behave exactly like their *_pk counterparts
+debounce_sym_defer_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp
+
+debounce_sym_eager_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp
+
+debounce_asym_eager_defer_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_asym_eager_defer_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/asym_eager_defer_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+debounce_benchmark_DEFS := -DMATRIX_ROWS=6 -DMATRIX_COLS=20 -DDEBOUNCE=5
+debounce_benchmark_INC := $(QUANTUM_PATH)/debounce
+debounce_benchmark_SRC := \
+	$(QUANTUM_PATH)/bitwise.c \
+	$(PLATFORM_PATH)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/debounce/tests/benchmark/bench_sym_defer_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/benchmark/bench_sym_defer_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/benchmark/bench_sym_eager_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/benchmark/bench_sym_eager_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/benchmark/bench_asym_eager_defer_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/benchmark/bench_asym_eager_defer_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/debounce_benchmark_tests.cpp
+
+debounce_stats_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_STATS_ENABLE
+debounce_stats_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/stats_tests.cpp
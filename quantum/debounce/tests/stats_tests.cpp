@@ -0,0 +1,39 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include "debounce_test_common.h"
+
+extern "C" {
+#include "debounce.h"
+}
+
+TEST_F(DebounceTest, Stats) {
+    debounce_stats_clear();
+
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {}},
+        /* Chatter while the timer is running */
+        {1, {{0, 1, UP}, {0, 2, DOWN}}, {}},
+        {2, {{0, 1, DOWN}}, {}},
+
+        {6, {}, {{0, 2, DOWN}}},
+        {7, {}, {{0, 1, DOWN}}},
+
+        {20, {{0, 1, UP}, {0, 2, UP}}, {}},
+        {25, {}, {{0, 1, UP}, {0, 2, UP}}},
+    });
+    runEvents();
+
+    /* The events are run 20 times, with one bounce each */
+    EXPECT_EQ(debounce_stats_bounces(0, 1), 20);
+    EXPECT_EQ(debounce_stats_bounces(0, 2), 0);
+    EXPECT_EQ(debounce_stats_bounces(MATRIX_ROWS, 0), 0);
+    EXPECT_EQ(debounce_stats_peak_active(), 2);
+
+    debounce_stats_clear();
+    EXPECT_EQ(debounce_stats_bounces(0, 1), 0);
+    EXPECT_EQ(debounce_stats_peak_active(), 0);
+}
@@ -0,0 +1,97 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Per-key counters for the *_vc debounce algorithms, stored as vertical
+// counters: plane b of a row holds bit b of the counter of every key in
+// that row. A whole row of counters is loaded, cleared or advanced with a
+// few bitwise operations per plane instead of a branch per key.
+
+#pragma once
+
+#include "matrix.h"
+
+#if DEBOUNCE < 2
+#    define DEBOUNCE_VC_BITS 1
+#elif DEBOUNCE < 4
+#    define DEBOUNCE_VC_BITS 2
+#elif DEBOUNCE < 8
+#    define DEBOUNCE_VC_BITS 3
+#elif DEBOUNCE < 16
+#    define DEBOUNCE_VC_BITS 4
+#elif DEBOUNCE < 32
+#    define DEBOUNCE_VC_BITS 5
+#elif DEBOUNCE < 64
+#    define DEBOUNCE_VC_BITS 6
+#elif DEBOUNCE < 128
+#    define DEBOUNCE_VC_BITS 7
+#else
+#    define DEBOUNCE_VC_BITS 8
+#endif
+
+typedef struct {
+    matrix_row_t plane[DEBOUNCE_VC_BITS];
+} debounce_vc_row_t;
+
+/**
+ * @brief Returns the keys of a row whose counter is running.
+ */
+static inline matrix_row_t debounce_vc_active(const debounce_vc_row_t *counters) {
+    matrix_row_t active = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        active |= counters->plane[b];
+    }
+    return active;
+}
+
+/**
+ * @brief Starts the counters of the keys in mask at DEBOUNCE.
+ */
+static inline void debounce_vc_load(debounce_vc_row_t *counters, matrix_row_t mask) {
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        counters->plane[b] = (DEBOUNCE >> b) & 1 ? counters->plane[b] | mask : counters->plane[b] & ~mask;
+    }
+}
+
+/**
+ * @brief Stops the counters of the keys in mask.
+ */
+static inline void debounce_vc_clear(debounce_vc_row_t *counters, matrix_row_t mask) {
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        counters->plane[b] &= ~mask;
+    }
+}
+
+/**
+ * @brief Counts down the running counters of a row by the elapsed time.
+ *
+ * Subtracts elapsed_time from every counter at once with a ripple borrow
+ * across the planes, and stops the counters that reach zero.
+ *
+ * @param counters The counters of the row.
+ * @param elapsed_time The time elapsed since the last update, in milliseconds.
+ * @return The keys whose counter expired.
+ */
+static inline matrix_row_t debounce_vc_elapse(debounce_vc_row_t *counters, uint8_t elapsed_time) {
+    matrix_row_t active = debounce_vc_active(counters);
+    if (elapsed_time >= DEBOUNCE) {
+        debounce_vc_clear(counters, active);
+        return active;
+    }
+
+    matrix_row_t borrow = 0, remaining = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        matrix_row_t counter = counters->plane[b];
+        matrix_row_t elapsed = (elapsed_time >> b) & 1 ? (matrix_row_t)~0 : 0;
+
+        counters->plane[b] = counter ^ elapsed ^ borrow;
+        borrow             = (~counter & (elapsed | borrow)) | (counter & elapsed & borrow);
+        remaining |= counters->plane[b];
+    }
+
+    // Reached zero, or went past it
+    matrix_row_t expired = active & (borrow | ~remaining);
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        counters->plane[b] &= active & ~expired;
+    }
+    return expired;
+}
@@ -4,12 +4,22 @@
 #include <string.h>
 #include "action.h"
 #include "encoder.h"
+#include "timer.h"
 #include "wait.h"
 
 #ifndef ENCODER_MAP_KEY_DELAY
 #    define ENCODER_MAP_KEY_DELAY TAP_CODE_DELAY
 #endif
 
+#ifdef ENCODER_ACCELERATION_ENABLE
+#    ifndef ENCODER_ACCELERATION_INTERVAL
+#        define ENCODER_ACCELERATION_INTERVAL 40
+#    endif
+#    ifndef ENCODER_ACCELERATION_MAX
+#        define ENCODER_ACCELERATION_MAX 4
+#    endif
+#endif // ENCODER_ACCELERATION_ENABLE
+
 __attribute__((weak)) bool should_process_encoder(void) {
     return is_keyboard_master();
 }
@@ -17,21 +27,69 @@ __attribute__((weak)) bool should_process_encoder(void) {
 static encoder_events_t encoder_events;
 static bool             signal_queue_drain = false;
 
+// Ticks which did not fit into the queue, positive values are clockwise. They are
+// appended to the queue as soon as there is room again, instead of being dropped.
+static int16_t encoder_pending[NUM_ENCODERS];
+static bool    encoder_has_pending = false;
+
+#ifdef ENCODER_ACCELERATION_ENABLE
+static uint16_t encoder_last_tick[NUM_ENCODERS];
+static uint8_t  encoder_multiplier[NUM_ENCODERS];
+#endif // ENCODER_ACCELERATION_ENABLE
+
 void encoder_init(void) {
     memset(&encoder_events, 0, sizeof(encoder_events));
+    memset(encoder_pending, 0, sizeof(encoder_pending));
+    encoder_has_pending = false;
+#ifdef ENCODER_ACCELERATION_ENABLE
+    memset(encoder_multiplier, 0, sizeof(encoder_multiplier));
+#endif // ENCODER_ACCELERATION_ENABLE
     encoder_driver_init();
 }
 
 static void encoder_queue_drain(void) {
     encoder_events.tail     = encoder_events.head;
     encoder_events.dequeued = encoder_events.enqueued;
+    memset(encoder_pending, 0, sizeof(encoder_pending));
+    encoder_has_pending = false;
 }
 
-static bool encoder_handle_queue(void) {
-    bool    changed = false;
-    uint8_t index;
-    bool    clockwise;
-    while (encoder_dequeue_event(&index, &clockwise)) {
+static void encoder_flush_pending(void) {
+    if (!encoder_has_pending) {
+        return;
+    }
+
+    bool remaining = false;
+    for (uint8_t i = 0; i < NUM_ENCODERS; i++) {
+        while (encoder_pending[i] != 0 && !encoder_queue_full()) {
+            bool clockwise = encoder_pending[i] > 0;
+            encoder_queue_event_advanced(&encoder_events, i, clockwise);
+            encoder_pending[i] += clockwise ? -1 : 1;
+        }
+        remaining |= encoder_pending[i] != 0;
+    }
+    encoder_has_pending = remaining;
+}
+
+static uint16_t encoder_repeat_count(uint8_t index, uint8_t count) {
+#ifdef ENCODER_ACCELERATION_ENABLE
+    // Every detent arriving within the interval of the previous one speeds up, up to the maximum multiplier
+    if (encoder_multiplier[index] == 0 || timer_elapsed(encoder_last_tick[index]) > ENCODER_ACCELERATION_INTERVAL) {
+        encoder_multiplier[index] = 1;
+    } else {
+        encoder_multiplier[index] = MIN(encoder_multiplier[index] + count, ENCODER_ACCELERATION_MAX);
+    }
+    encoder_last_tick[index] = timer_read();
+    return (uint16_t)count * encoder_multiplier[index];
+#else
+    return count;
+#endif // ENCODER_ACCELERATION_ENABLE
+}
+
+static void encoder_handle_event(uint8_t index, bool clockwise, uint8_t count) {
+    uint16_t repeat = encoder_repeat_count(index, count);
+
+    for (uint16_t i = 0; i < repeat; i++) {
 #ifdef ENCODER_MAP_ENABLE
 
         // The delays below cater for Windows and its wonderful requirements.
@@ -50,7 +108,30 @@ static bool encoder_handle_queue(void) {
         encoder_update_kb(index, clockwise);
 
 #endif // ENCODER_MAP_ENABLE
+    }
+}
+
+static bool encoder_handle_queue(void) {
+    bool    changed = false;
+    uint8_t index;
+    bool    clockwise;
+
+    encoder_flush_pending();
+    while (encoder_dequeue_event(&index, &clockwise)) {
+        // Coalesce a run of identical events into a single, counted one
+        uint8_t         count = 1;
+        encoder_event_t next;
+        while (count < UINT8_MAX && !encoder_queue_empty_advanced(&encoder_events)) {
+            next = encoder_events.queue[encoder_events.tail];
+            if (next.index != index || next.clockwise != clockwise) {
+                break;
+            }
+            encoder_dequeue_event(&index, &clockwise);
+            count++;
+        }
 
+        encoder_handle_event(index, clockwise, count);
+        encoder_flush_pending();
         changed = true;
     }
     return changed;
@@ -74,6 +155,9 @@ bool encoder_task(void) {
     // Let the encoder driver produce events
     encoder_driver_task();
 
+    // Move anything that overflowed earlier into the queue, so it can be processed or retrieved by the other half
+    encoder_flush_pending();
+
     // Process any events that were enqueued
     if (should_process_encoder()) {
         changed |= encoder_handle_queue();
@@ -133,7 +217,22 @@ bool encoder_dequeue_event_advanced(encoder_events_t *events, uint8_t *index, bo
 }
 
 bool encoder_queue_event(uint8_t index, bool clockwise) {
-    return encoder_queue_event_advanced(&encoder_events, index, clockwise);
+    // Keep ordering intact: once anything is pending, newer ticks have to queue up behind it
+    if (!encoder_has_pending && encoder_queue_event_advanced(&encoder_events, index, clockwise)) {
+        return true;
+    }
+    if (index >= NUM_ENCODERS) {
+        return false;
+    }
+
+    // Queue is full, coalesce into the pending count for this encoder instead of dropping the tick
+    if (clockwise && encoder_pending[index] < INT16_MAX) {
+        encoder_pending[index]++;
+    } else if (!clockwise && encoder_pending[index] > INT16_MIN) {
+        encoder_pending[index]--;
+    }
+    encoder_has_pending = true;
+    return true;
 }
 
 bool encoder_dequeue_event(uint8_t *index, bool *clockwise) {
@@ -103,6 +103,10 @@ typedef struct encoder_events_t {
 void encoder_retrieve_events(encoder_events_t *events);
 
 // Encoder event queue management
+bool encoder_queue_full_advanced(encoder_events_t *events);
+bool encoder_queue_full(void);
+bool encoder_queue_empty_advanced(encoder_events_t *events);
+bool encoder_queue_empty(void);
 bool encoder_queue_event_advanced(encoder_events_t *events, uint8_t index, bool clockwise);
 bool encoder_dequeue_event_advanced(encoder_events_t *events, uint8_t *index, bool *clockwise);
 
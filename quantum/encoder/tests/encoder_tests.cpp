@@ -142,3 +142,26 @@ TEST_F(EncoderTest, TestHalfway) {
     EXPECT_EQ(updates[0].index, 0);
     EXPECT_EQ(updates[0].clockwise, true);
 }
+
+extern "C" void encoder_quadrature_handle_read(uint8_t index, uint8_t pin_a_state, uint8_t pin_b_state);
+
+TEST_F(EncoderTest, TestFastSpinIsNotDropped) {
+    updates_array_idx = 0;
+    encoder_init();
+    // spin 10 detents without the main loop getting a chance to process them,
+    // which is way more than the event queue can hold
+    for (int i = 0; i < 10; i++) {
+        encoder_quadrature_handle_read(0, 0, 1);
+        encoder_quadrature_handle_read(0, 0, 0);
+        encoder_quadrature_handle_read(0, 1, 0);
+        encoder_quadrature_handle_read(0, 1, 1);
+    }
+    EXPECT_EQ(updates_array_idx, 0);
+
+    encoder_task();
+    EXPECT_EQ(updates_array_idx, 10);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(updates[i].index, 0);
+        EXPECT_EQ(updates[i].clockwise, true);
+    }
+}
@@ -82,6 +82,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef KEY_OVERRIDE_ENABLE
 #    include "process_key_override.h"
 #endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#    include "process_dynamic_macro.h"
+#endif
 #ifdef SECURE_ENABLE
 #    include "secure.h"
 #endif
@@ -151,6 +154,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef CONNECTION_ENABLE
 #    include "connection.h"
 #endif
+#ifdef MATRIX_IDLE_ENABLE
+#    include "matrix_idle.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -595,6 +601,13 @@ static bool matrix_task(void) {
         return false;
     }
 
+#ifdef MATRIX_IDLE_ENABLE
+    if (!matrix_idle_task()) {
+        generate_tick_event();
+        return false;
+    }
+#endif
+
     matrix_scan();
     bool matrix_changed = false;
     for (uint8_t row = 0; row < MATRIX_ROWS && !matrix_changed; row++) {
@@ -664,6 +677,14 @@ void quantum_task(void) {
     key_override_task();
 #endif
 
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_task();
+#endif
+
+#if defined(UNICODE_COMMON_ENABLE) && defined(UNICODE_QUEUE_ENABLE)
+    unicode_task();
+#endif
+
 #ifdef SEQUENCER_ENABLE
     sequencer_task();
 #endif
@@ -680,6 +701,10 @@ void quantum_task(void) {
     leader_task();
 #endif
 
+#ifdef STENO_ENABLE
+    steno_task();
+#endif
+
 #ifdef WPM_ENABLE
     decay_wpm();
 #endif
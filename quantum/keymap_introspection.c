@@ -121,6 +121,45 @@ __attribute__((weak)) combo_t* combo_get(uint16_t combo_idx) {
 
 #endif // defined(COMBO_ENABLE)
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Leader sequences
+
+#if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCES_ENABLE)
+
+uint16_t leader_sequence_count_raw(void) {
+    return ARRAY_SIZE(leader_sequences);
+}
+
+__attribute__((weak)) uint16_t leader_sequence_count(void) {
+    return leader_sequence_count_raw();
+}
+
+STATIC_ASSERT(ARRAY_SIZE(leader_sequences) <= INT16_MAX, "Number of leader sequences exceeds maximum");
+
+uint16_t leader_sequence_key_raw(uint16_t sequence_idx, uint8_t pos) {
+    if (sequence_idx < leader_sequence_count_raw() && pos < LEADER_SEQUENCE_MAX_LENGTH) {
+        return pgm_read_word(&leader_sequences[sequence_idx].keys[pos]);
+    }
+    return KC_NO;
+}
+
+__attribute__((weak)) uint16_t leader_sequence_key(uint16_t sequence_idx, uint8_t pos) {
+    return leader_sequence_key_raw(sequence_idx, pos);
+}
+
+uint16_t leader_sequence_keycode_raw(uint16_t sequence_idx) {
+    if (sequence_idx < leader_sequence_count_raw()) {
+        return pgm_read_word(&leader_sequences[sequence_idx].keycode);
+    }
+    return KC_NO;
+}
+
+__attribute__((weak)) uint16_t leader_sequence_keycode(uint16_t sequence_idx) {
+    return leader_sequence_keycode_raw(sequence_idx);
+}
+
+#endif // defined(LEADER_ENABLE) && defined(LEADER_SEQUENCES_ENABLE)
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Tap Dance
 
@@ -175,6 +214,11 @@ __attribute__((weak)) const key_override_t* key_override_get(uint16_t key_overri
     return key_override_get_raw(key_override_idx);
 }
 
+uint8_t* key_override_index_storage_raw(void) {
+    static uint8_t key_override_index[ARRAY_SIZE(key_overrides)];
+    return key_override_index;
+}
+
 #endif // defined(KEY_OVERRIDE_ENABLE)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -68,6 +68,28 @@ combo_t* combo_get(uint16_t combo_idx);
 
 #endif // defined(COMBO_ENABLE)
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Leader sequences
+
+#if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCES_ENABLE)
+
+// Get the number of leader sequences defined in the user's keymap, stored in firmware rather than any other persistent storage
+uint16_t leader_sequence_count_raw(void);
+// Get the number of leader sequences defined in the user's keymap, potentially stored dynamically
+uint16_t leader_sequence_count(void);
+
+// Get the key at the given position of a leader sequence, stored in firmware rather than any other persistent storage
+uint16_t leader_sequence_key_raw(uint16_t sequence_idx, uint8_t pos);
+// Get the key at the given position of a leader sequence, potentially stored dynamically
+uint16_t leader_sequence_key(uint16_t sequence_idx, uint8_t pos);
+
+// Get the keycode sent by a leader sequence, stored in firmware rather than any other persistent storage
+uint16_t leader_sequence_keycode_raw(uint16_t sequence_idx);
+// Get the keycode sent by a leader sequence, potentially stored dynamically
+uint16_t leader_sequence_keycode(uint16_t sequence_idx);
+
+#endif // defined(LEADER_ENABLE) && defined(LEADER_SEQUENCES_ENABLE)
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Tap Dance
 
@@ -108,4 +130,7 @@ const key_override_t* key_override_get_raw(uint16_t key_override_idx);
 // Get the key override definitions, potentially stored dynamically
 const key_override_t* key_override_get(uint16_t key_override_idx);
 
+// Get storage for the key override lookup index, with room for key_override_count_raw() entries
+uint8_t* key_override_index_storage_raw(void);
+
 #endif // defined(KEY_OVERRIDE_ENABLE)
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "leader.h"
+#include "quantum.h"
+#include "keymap_introspection.h"
 #include "timer.h"
 #include "util.h"
 
@@ -12,10 +14,18 @@
 #endif
 
 // Leader key stuff
-bool     leading              = false;
-uint16_t leader_time          = 0;
-uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
-uint8_t  leader_sequence_size = 0;
+bool     leading                                     = false;
+uint16_t leader_time                                 = 0;
+uint16_t leader_sequence[LEADER_SEQUENCE_MAX_LENGTH] = {0};
+uint8_t  leader_sequence_size                        = 0;
+
+#if defined(LEADER_SEQUENCES_ENABLE)
+// The entries of the leader_sequences table starting with the sequence buffer
+// are [match_first, match_last). The table is sorted, so they form one range
+// that shrinks with each key, like walking down a trie.
+static uint16_t match_first = 0;
+static uint16_t match_last  = 0;
+#endif
 
 __attribute__((weak)) void leader_start_user(void) {}
 
@@ -25,6 +35,70 @@ __attribute__((weak)) bool leader_add_user(uint16_t keycode) {
     return false;
 }
 
+__attribute__((weak)) bool leader_sequence_user(uint16_t index, uint16_t keycode) {
+    return true;
+}
+
+#if defined(LEADER_SEQUENCES_ENABLE)
+static void leader_sequences_check_order(void) {
+    static bool checked = false;
+    if (checked) {
+        return;
+    }
+    checked = true;
+
+    for (uint16_t i = 1; i < leader_sequence_count(); i++) {
+        for (uint8_t pos = 0; pos < LEADER_SEQUENCE_MAX_LENGTH; pos++) {
+            uint16_t prev = leader_sequence_key(i - 1, pos);
+            uint16_t next = leader_sequence_key(i, pos);
+            if (prev < next) {
+                break;
+            }
+            if (prev > next) {
+                dprintf("leader: leader_sequences[%u] is out of order, sequences may not match\n", i);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * \brief Find the first entry of [first, last) whose key at pos is not below
+ * keycode, or with upper, above keycode.
+ */
+static uint16_t leader_sequences_bound(uint16_t first, uint16_t last, uint8_t pos, uint16_t keycode, bool upper) {
+    while (first < last) {
+        uint16_t middle = first + (last - first) / 2;
+        uint16_t key    = leader_sequence_key(middle, pos);
+        if (key < keycode || (upper && key == keycode)) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+#endif
+
+/**
+ * \brief Narrow the matching entries down to the ones continuing with the
+ * last key of the sequence buffer.
+ *
+ * \return `true` if a single entry is left and it is complete.
+ */
+static bool leader_sequences_advance(void) {
+#if defined(LEADER_SEQUENCES_ENABLE)
+    uint8_t  pos     = leader_sequence_size - 1;
+    uint16_t keycode = leader_sequence[pos];
+
+    match_first = leader_sequences_bound(match_first, match_last, pos, keycode, false);
+    match_last  = leader_sequences_bound(match_first, match_last, pos, keycode, true);
+    return match_last - match_first == 1 && leader_sequence_match() >= 0;
+#else
+    return false;
+#endif
+}
+
 void leader_start(void) {
     if (leading) {
         return;
@@ -34,10 +108,25 @@ void leader_start(void) {
     leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+#if defined(LEADER_SEQUENCES_ENABLE)
+    leader_sequences_check_order();
+    match_first = 0;
+    match_last  = leader_sequence_count();
+#endif
 }
 
 void leader_end(void) {
     leading = false;
+
+#if defined(LEADER_SEQUENCES_ENABLE)
+    int16_t index = leader_sequence_match();
+    if (index >= 0) {
+        uint16_t keycode = leader_sequence_keycode(index);
+        if (leader_sequence_user(index, keycode)) {
+            tap_code16(keycode);
+        }
+    }
+#endif
     leader_end_user();
 }
 
@@ -65,12 +154,23 @@ bool leader_sequence_add(uint16_t keycode) {
     leader_sequence[leader_sequence_size] = keycode;
     leader_sequence_size++;
 
-    if (leader_add_user(keycode)) {
+    bool unique = leader_sequences_advance();
+    if (leader_add_user(keycode) || unique) {
         leader_end();
     }
     return true;
 }
 
+int16_t leader_sequence_match(void) {
+#if defined(LEADER_SEQUENCES_ENABLE)
+    // Shorter sequences sort first, as they continue with KC_NO
+    if (leader_sequence_size > 0 && match_first < match_last && (leader_sequence_size == LEADER_SEQUENCE_MAX_LENGTH || leader_sequence_key(match_first, leader_sequence_size) == KC_NO)) {
+        return match_first;
+    }
+#endif
+    return -1;
+}
+
 bool leader_sequence_timed_out(void) {
 #if defined(LEADER_NO_TIMEOUT)
     return leader_sequence_size > 0 && timer_elapsed(leader_time) > LEADER_TIMEOUT;
@@ -84,7 +184,17 @@ void leader_reset_timer(void) {
 }
 
 bool leader_sequence_is(uint16_t kc1, uint16_t kc2, uint16_t kc3, uint16_t kc4, uint16_t kc5) {
-    return leader_sequence[0] == kc1 && leader_sequence[1] == kc2 && leader_sequence[2] == kc3 && leader_sequence[3] == kc4 && leader_sequence[4] == kc5;
+    const uint16_t keys[] = {kc1, kc2, kc3, kc4, kc5};
+
+    if (leader_sequence_size > ARRAY_SIZE(keys)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(keys); i++) {
+        if ((i < leader_sequence_size ? leader_sequence[i] : KC_NO) != keys[i]) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool leader_sequence_one_key(uint16_t kc) {
@@ -1,6 +1,8 @@
 // Copyright 2023 QMK
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#pragma once
+
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -11,6 +13,32 @@
  * \{
  */
 
+#ifndef LEADER_SEQUENCE_MAX_LENGTH
+#    define LEADER_SEQUENCE_MAX_LENGTH 5
+#endif
+
+/**
+ * \brief An entry of the `leader_sequences` table.
+ *
+ * Unused trailing keys are `KC_NO`. The table must be sorted by `keys`,
+ * compared keycode by keycode as unsigned numbers.
+ */
+typedef struct {
+    uint16_t keys[LEADER_SEQUENCE_MAX_LENGTH];
+    uint16_t keycode;
+} leader_sequence_t;
+
+/**
+ * \brief User callback, invoked when the leader sequence ends on an entry of
+ * the `leader_sequences` table, before `leader_end_user()`.
+ *
+ * \param index The index of the entry in the table.
+ * \param keycode The keycode of the entry.
+ *
+ * \return `true` to tap `keycode`, `false` to skip it.
+ */
+bool leader_sequence_user(uint16_t index, uint16_t keycode);
+
 /**
  * \brief User callback, invoked when the leader sequence begins.
  */
@@ -54,10 +82,20 @@ bool leader_sequence_active(void);
  *
  * \param keycode The keycode to add.
  *
+ * The leader sequence ends early once the buffer matches exactly one entry
+ * of the `leader_sequences` table and no longer entry starts with it.
+ *
  * \return `true` if the keycode was added, `false` if the buffer is full.
  */
 bool leader_sequence_add(uint16_t keycode);
 
+/**
+ * The entry of the `leader_sequences` table matching the sequence buffer.
+ *
+ * \return The index of the entry, or `-1` if there is none.
+ */
+int16_t leader_sequence_match(void);
+
 /**
  * Whether the leader sequence has reached the timeout.
  *
@@ -0,0 +1,16 @@
+#pragma once
+
+typedef LED_EFFECT_PIXEL_T (*dx_dy_f)(LED_EFFECT_PIXEL_T pixel, int16_t dx, int16_t dy, uint8_t time);
+
+bool effect_runner_dx_dy(effect_params_t* params, dx_dy_f effect_func) {
+    LED_EFFECT_USE_LIMITS(led_min, led_max);
+
+    uint8_t time = scale16by8(LED_EFFECT_TIMER, LED_EFFECT_SPEED / 2);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_EFFECT_TEST_LED_FLAGS();
+        int16_t dx = g_led_config.point[i].x - LED_EFFECT_CENTER.x;
+        int16_t dy = g_led_config.point[i].y - LED_EFFECT_CENTER.y;
+        LED_EFFECT_SET_PIXEL(i, effect_func(LED_EFFECT_PIXEL, dx, dy, time));
+    }
+    return LED_EFFECT_CHECK_FINISHED_LEDS(led_max);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+typedef LED_EFFECT_PIXEL_T (*i_f)(LED_EFFECT_PIXEL_T pixel, uint8_t i, uint8_t time);
+
+bool effect_runner_i(effect_params_t* params, i_f effect_func) {
+    LED_EFFECT_USE_LIMITS(led_min, led_max);
+
+    uint8_t time = scale16by8(LED_EFFECT_TIMER, qadd8(LED_EFFECT_SPEED / 4, 1));
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_EFFECT_TEST_LED_FLAGS();
+        LED_EFFECT_SET_PIXEL(i, effect_func(LED_EFFECT_PIXEL, i, time));
+    }
+    return LED_EFFECT_CHECK_FINISHED_LEDS(led_max);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+typedef LED_EFFECT_PIXEL_T (*polar_f)(LED_EFFECT_PIXEL_T pixel, uint8_t angle, uint8_t dist, uint8_t time);
+
+bool effect_runner_polar(effect_params_t* params, polar_f effect_func) {
+    LED_EFFECT_USE_LIMITS(led_min, led_max);
+
+    uint8_t time = scale16by8(LED_EFFECT_TIMER, LED_EFFECT_SPEED / 2);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_EFFECT_TEST_LED_FLAGS();
+        led_polar_t polar = LED_EFFECT_LED_POLAR(i);
+        LED_EFFECT_SET_PIXEL(i, effect_func(LED_EFFECT_PIXEL, polar.angle, polar.radius, time));
+    }
+    return LED_EFFECT_CHECK_FINISHED_LEDS(led_max);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#ifdef LED_EFFECT_KEYREACTIVE_ENABLED
+
+typedef LED_EFFECT_PIXEL_T (*reactive_f)(LED_EFFECT_PIXEL_T pixel, uint16_t offset);
+
+bool effect_runner_reactive(effect_params_t* params, reactive_f effect_func) {
+    LED_EFFECT_USE_LIMITS(led_min, led_max);
+
+    uint8_t  speed    = qadd8(LED_EFFECT_SPEED, 1);
+    uint16_t max_tick = 65535 / speed;
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_EFFECT_TEST_LED_FLAGS();
+        uint16_t tick = max_tick;
+        // Reverse search to find most recent key hit
+        for (int8_t j = g_last_hit_tracker.count - 1; j >= 0; j--) {
+            if (g_last_hit_tracker.index[j] == i && g_last_hit_tracker.tick[j] < tick) {
+                tick = g_last_hit_tracker.tick[j];
+                break;
+            }
+        }
+
+        uint16_t offset = scale16by8(tick, speed);
+        LED_EFFECT_SET_PIXEL(i, effect_func(LED_EFFECT_PIXEL, offset));
+    }
+    return LED_EFFECT_CHECK_FINISHED_LEDS(led_max);
+}
+
+#endif // LED_EFFECT_KEYREACTIVE_ENABLED
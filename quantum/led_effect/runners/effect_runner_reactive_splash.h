@@ -0,0 +1,29 @@
+#pragma once
+
+#ifdef LED_EFFECT_KEYREACTIVE_ENABLED
+
+typedef LED_EFFECT_PIXEL_T (*reactive_splash_f)(LED_EFFECT_PIXEL_T pixel, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
+
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+    LED_EFFECT_USE_LIMITS(led_min, led_max);
+
+    uint8_t count = g_last_hit_tracker.count;
+    uint8_t speed = qadd8(LED_EFFECT_SPEED, 1);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_EFFECT_TEST_LED_FLAGS();
+        LED_EFFECT_PIXEL_T pixel = LED_EFFECT_PIXEL;
+        LED_EFFECT_VALUE(pixel)  = 0;
+        for (uint8_t j = start; j < count; j++) {
+            int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
+            int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
+            uint8_t  dist = LED_EFFECT_LED_DISTANCE(i, g_last_hit_tracker.index[j]);
+            uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], speed);
+            pixel         = effect_func(pixel, dx, dy, dist, tick);
+        }
+        LED_EFFECT_VALUE(pixel) = scale8(LED_EFFECT_VALUE(pixel), LED_EFFECT_VALUE(LED_EFFECT_PIXEL));
+        LED_EFFECT_SET_PIXEL(i, pixel);
+    }
+    return LED_EFFECT_CHECK_FINISHED_LEDS(led_max);
+}
+
+#endif // LED_EFFECT_KEYREACTIVE_ENABLED
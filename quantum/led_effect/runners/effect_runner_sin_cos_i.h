@@ -0,0 +1,16 @@
+#pragma once
+
+typedef LED_EFFECT_PIXEL_T (*sin_cos_i_f)(LED_EFFECT_PIXEL_T pixel, int8_t sin, int8_t cos, uint8_t i, uint8_t time);
+
+bool effect_runner_sin_cos_i(effect_params_t* params, sin_cos_i_f effect_func) {
+    LED_EFFECT_USE_LIMITS(led_min, led_max);
+
+    uint16_t time      = scale16by8(LED_EFFECT_TIMER, LED_EFFECT_SPEED / 4);
+    int8_t   cos_value = cos8(time) - 128;
+    int8_t   sin_value = sin8(time) - 128;
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_EFFECT_TEST_LED_FLAGS();
+        LED_EFFECT_SET_PIXEL(i, effect_func(LED_EFFECT_PIXEL, cos_value, sin_value, i, time));
+    }
+    return LED_EFFECT_CHECK_FINISHED_LEDS(led_max);
+}
@@ -2,12 +2,12 @@
 LED_MATRIX_EFFECT(BAND_SPIRAL)
 #    ifdef LED_MATRIX_CUSTOM_EFFECT_IMPLS
 
-static uint8_t BAND_SPIRAL_math(uint8_t val, int16_t dx, int16_t dy, uint8_t dist, uint8_t time) {
-    return scale8(val + dist - time - atan2_8(dy, dx), val);
+static uint8_t BAND_SPIRAL_math(uint8_t val, uint8_t angle, uint8_t dist, uint8_t time) {
+    return scale8(val + dist - time - angle, val);
 }
 
 bool BAND_SPIRAL(effect_params_t* params) {
-    return effect_runner_dx_dy_dist(params, &BAND_SPIRAL_math);
+    return effect_runner_polar(params, &BAND_SPIRAL_math);
 }
 
 #    endif // LED_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -76,20 +76,6 @@ last_hit_t g_last_hit_tracker;
 static const uint8_t led_matrix_flag_steps[] = LED_MATRIX_FLAG_STEPS;
 #define LED_MATRIX_FLAG_STEPS_COUNT ARRAY_SIZE(led_matrix_flag_steps)
 
-// internals
-static bool            suspend_state      = false;
-static uint8_t         led_last_enable    = UINT8_MAX;
-static uint8_t         led_last_effect    = UINT8_MAX;
-static uint8_t         led_current_effect = 0;
-static effect_params_t led_effect_params  = {0, LED_FLAG_ALL, false};
-static led_task_states led_task_state     = SYNCING;
-
-// double buffers
-static uint32_t led_timer_buffer;
-#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-static last_hit_t last_hit_buffer;
-#endif // LED_MATRIX_KEYREACTIVE_ENABLED
-
 // split led matrix
 #if defined(LED_MATRIX_SPLIT)
 const uint8_t k_led_matrix_split[2] = LED_MATRIX_SPLIT;
@@ -97,6 +83,26 @@ const uint8_t k_led_matrix_split[2] = LED_MATRIX_SPLIT;
 
 EECONFIG_DEBOUNCE_HELPER(led_matrix, led_matrix_eeconfig);
 
+// Task scheduler
+#define LED_EFFECT_CONFIG led_matrix_eeconfig
+#define LED_EFFECT_TIMER g_led_timer
+#define LED_EFFECT_TASK_STATES led_task_states
+#define LED_EFFECT_NONE LED_MATRIX_NONE
+#define LED_EFFECT_FLUSH_LIMIT LED_MATRIX_LED_FLUSH_LIMIT
+#define LED_EFFECT_TIMEOUT LED_MATRIX_TIMEOUT
+#define LED_EFFECT_CLEAR() led_matrix_set_value_all(0)
+#define LED_EFFECT_FLUSH_EECONFIG() eeconfig_flush_led_matrix(false)
+#define LED_EFFECT_UPDATE_PWM_BUFFERS() led_matrix_update_pwm_buffers()
+#define LED_EFFECT_INDICATORS() led_matrix_indicators()
+#define LED_EFFECT_INDICATORS_ADVANCED(params) led_matrix_indicators_advanced(params)
+#define LED_EFFECT_MAP_ROW_COLUMN_TO_LED led_matrix_map_row_column_to_led
+#if defined(LED_MATRIX_KEYRELEASES)
+#    define LED_EFFECT_KEYRELEASES
+#elif defined(LED_MATRIX_KEYPRESSES)
+#    define LED_EFFECT_KEYPRESSES
+#endif
+#include "led_effect_task.inc"
+
 void eeconfig_force_flush_led_matrix(void) {
     eeconfig_flush_led_matrix(true);
 }
@@ -148,6 +154,46 @@ uint8_t led_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
     return led_count;
 }
 
+led_polar_t led_matrix_led_polar(uint8_t led_index) {
+    led_polar_t polar;
+#ifdef LED_MATRIX_LED_GEOMETRY
+    memcpy_P(&polar, &g_led_polar[led_index], sizeof(led_polar_t));
+#else
+    int16_t dx   = g_led_config.point[led_index].x - k_led_matrix_center.x;
+    int16_t dy   = g_led_config.point[led_index].y - k_led_matrix_center.y;
+    polar.angle  = atan2_8(dy, dx);
+    polar.radius = sqrt16(dx * dx + dy * dy);
+#endif
+    return polar;
+}
+
+uint8_t led_matrix_led_distance(uint8_t led_a, uint8_t led_b) {
+    int16_t dx = g_led_config.point[led_a].x - g_led_config.point[led_b].x;
+    int16_t dy = g_led_config.point[led_a].y - g_led_config.point[led_b].y;
+#ifdef LED_MATRIX_LED_GEOMETRY
+    // Neighbours are sorted by index, LEDs outside the box around the radius
+    // cannot be one and anything further away is computed below
+    if (abs(dx) <= LED_MATRIX_NEIGHBOUR_RADIUS && abs(dy) <= LED_MATRIX_NEIGHBOUR_RADIUS) {
+        uint16_t low  = pgm_read_word(&g_led_neighbour_start[led_a]);
+        uint16_t high = pgm_read_word(&g_led_neighbour_start[led_a + 1]);
+        while (low < high) {
+            uint16_t        mid = (low + high) / 2;
+            led_neighbour_t neighbour;
+            memcpy_P(&neighbour, &g_led_neighbours[mid], sizeof(led_neighbour_t));
+            if (neighbour.index == led_b) {
+                return neighbour.distance;
+            }
+            if (neighbour.index < led_b) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+    }
+#endif
+    return sqrt16(dx * dx + dy * dy);
+}
+
 void led_matrix_update_pwm_buffers(void) {
     led_matrix_driver.flush();
 }
@@ -186,36 +232,7 @@ void led_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed) {
     if (!is_keyboard_master()) return;
 #endif
 
-#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t led[LED_HITS_TO_REMEMBER];
-    uint8_t led_count = 0;
-
-#    if defined(LED_MATRIX_KEYRELEASES)
-    if (!pressed)
-#    elif defined(LED_MATRIX_KEYPRESSES)
-    if (pressed)
-#    endif // defined(LED_MATRIX_KEYRELEASES)
-    {
-        led_count = led_matrix_map_row_column_to_led(row, col, led);
-    }
-
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2); // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count = LED_HITS_TO_REMEMBER - led_count;
-    }
-
-    for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
-    }
-#endif // LED_MATRIX_KEYREACTIVE_ENABLED
+    led_effect_track_key_hit(row, col, pressed);
 
 #if defined(LED_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_LED_MATRIX_TYPING_HEATMAP)
     if (led_matrix_eeconfig.mode == LED_MATRIX_TYPING_HEATMAP) {
@@ -233,93 +250,36 @@ static bool led_matrix_none(effect_params_t *params) {
     return false;
 }
 
-static void led_task_timers(void) {
-#if defined(LED_MATRIX_KEYREACTIVE_ENABLED)
-    uint32_t deltaTime = sync_timer_elapsed32(led_timer_buffer);
-#endif // defined(LED_MATRIX_KEYREACTIVE_ENABLED)
-    led_timer_buffer = sync_timer_read32();
-
-    // Update double buffer last hit timers
-#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
-        }
-        last_hit_buffer.tick[i] += deltaTime;
-    }
-#endif // LED_MATRIX_KEYREACTIVE_ENABLED
-}
-
-static void led_task_sync(void) {
-    eeconfig_flush_led_matrix(false);
-    // next task
-    if (sync_timer_elapsed32(g_led_timer) >= LED_MATRIX_LED_FLUSH_LIMIT) led_task_state = STARTING;
-}
-
-static void led_task_start(void) {
-    // reset iter
-    led_effect_params.iter = 0;
+static bool led_effect_render(uint8_t effect, effect_params_t *params) {
+    bool rendering = false;
 
-    // update double buffers
-    g_led_timer = led_timer_buffer;
-#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker = last_hit_buffer;
-#endif // LED_MATRIX_KEYREACTIVE_ENABLED
-
-    // Ideally we would also stop sending zeros to the LED driver PWM buffers
-    // while suspended and just do a software shutdown. This is a cheap hack for now.
-    bool suspend_backlight = suspend_state ||
-#if LED_MATRIX_TIMEOUT > 0
-                             (last_input_activity_elapsed() > (uint32_t)LED_MATRIX_TIMEOUT) ||
-#endif // LED_MATRIX_TIMEOUT > 0
-                             false;
-
-    // Set effect to be renedered
-    led_current_effect = suspend_backlight || !led_matrix_eeconfig.enable ? 0 : led_matrix_eeconfig.mode;
-
-    // next task
-    led_task_state = RENDERING;
-}
-
-static void led_task_render(uint8_t effect) {
-    bool rendering         = false;
-    led_effect_params.init = (effect != led_last_effect) || (led_matrix_eeconfig.enable != led_last_enable);
-    if (led_effect_params.flags != led_matrix_eeconfig.flags) {
-        led_effect_params.flags = led_matrix_eeconfig.flags;
-        led_matrix_set_value_all(0);
-    }
-
-    // each effect can opt to do calculations
-    // and/or request PWM buffer updates.
     switch (effect) {
         case LED_MATRIX_NONE:
-            rendering = led_matrix_none(&led_effect_params);
+            rendering = led_matrix_none(params);
             break;
 
 // ---------------------------------------------
 // -----Begin led effect switch case macros-----
-#define LED_MATRIX_EFFECT(name, ...)          \
-    case LED_MATRIX_##name:                   \
-        rendering = name(&led_effect_params); \
+#define LED_MATRIX_EFFECT(name, ...) \
+    case LED_MATRIX_##name:          \
+        rendering = name(params);    \
         break;
 #include "led_matrix_effects.inc"
 #undef LED_MATRIX_EFFECT
 
 #ifdef COMMUNITY_MODULES_ENABLE
-#    define LED_MATRIX_EFFECT(name, ...)          \
-        case LED_MATRIX_COMMUNITY_MODULE_##name:  \
-            rendering = name(&led_effect_params); \
+#    define LED_MATRIX_EFFECT(name, ...)         \
+        case LED_MATRIX_COMMUNITY_MODULE_##name: \
+            rendering = name(params);            \
             break;
 #    include "led_matrix_community_modules.inc"
 #    undef LED_MATRIX_EFFECT
 #endif
 
 #if defined(LED_MATRIX_CUSTOM_KB) || defined(LED_MATRIX_CUSTOM_USER)
-#    define LED_MATRIX_EFFECT(name, ...)          \
-        case LED_MATRIX_CUSTOM_##name:            \
-            rendering = name(&led_effect_params); \
+#    define LED_MATRIX_EFFECT(name, ...) \
+        case LED_MATRIX_CUSTOM_##name:   \
+            rendering = name(params);    \
             break;
 #    ifdef LED_MATRIX_CUSTOM_KB
 #        include "led_matrix_kb.inc"
@@ -333,55 +293,11 @@ static void led_task_render(uint8_t effect) {
             // ---------------------------------------------
     }
 
-    led_effect_params.iter++;
-
-    // next task
-    if (!rendering) {
-        led_task_state = FLUSHING;
-        if (!led_effect_params.init && effect == LED_MATRIX_NONE) {
-            // We only need to flush once if we are LED_MATRIX_NONE
-            led_task_state = SYNCING;
-        }
-    }
-}
-
-static void led_task_flush(uint8_t effect) {
-    // update last trackers after the first full render so we can init over several frames
-    led_last_effect = effect;
-    led_last_enable = led_matrix_eeconfig.enable;
-
-    // update pwm buffers
-    led_matrix_update_pwm_buffers();
-
-    // next task
-    led_task_state = SYNCING;
+    return rendering;
 }
 
 void led_matrix_task(void) {
-    led_task_timers();
-
-    uint8_t effect = led_current_effect;
-
-    switch (led_task_state) {
-        case STARTING:
-            led_task_start();
-            break;
-        case RENDERING:
-            led_task_render(effect);
-            if (effect) {
-                if (led_task_state == FLUSHING) {
-                    led_matrix_indicators(); // ensure we only draw basic indicators once rendering is finished
-                }
-                led_matrix_indicators_advanced(&led_effect_params);
-            }
-            break;
-        case FLUSHING:
-            led_task_flush(effect);
-            break;
-        case SYNCING:
-            led_task_sync();
-            break;
-    }
+    led_effect_task();
 }
 
 __attribute__((weak)) bool led_matrix_indicators_modules(void) {
@@ -455,17 +371,7 @@ struct led_matrix_limits_t led_matrix_get_limits(uint8_t iter) {
 void led_matrix_init(void) {
     led_matrix_driver.init();
 
-#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        g_last_hit_tracker.tick[i] = UINT16_MAX;
-    }
-
-    last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
-#endif // LED_MATRIX_KEYREACTIVE_ENABLED
+    led_effect_clear_key_hits();
 
     eeconfig_init_led_matrix();
     if (!led_matrix_eeconfig.mode) {
@@ -478,8 +384,8 @@ void led_matrix_init(void) {
 void led_matrix_set_suspend_state(bool state) {
 #ifdef LED_MATRIX_SLEEP
     if (state && !suspend_state && is_keyboard_master()) { // only run if turning off, and only once
-        led_task_render(0);                                // turn off all LEDs when suspending
-        led_task_flush(0);                                 // and actually flash led state to LEDs
+        led_effect_task_render(0);                                // turn off all LEDs when suspending
+        led_effect_task_flush(0);                                 // and actually flash led state to LEDs
     }
     suspend_state = state;
 #endif
@@ -491,7 +397,7 @@ bool led_matrix_get_suspend_state(void) {
 
 void led_matrix_toggle_eeprom_helper(bool write_to_eeprom) {
     led_matrix_eeconfig.enable ^= 1;
-    led_task_state = STARTING;
+    led_effect_task_state = STARTING;
     eeconfig_flag_led_matrix(write_to_eeprom);
     dprintf("led matrix toggle [%s]: led_matrix_eeconfig.enable = %u\n", (write_to_eeprom) ? "EEPROM" : "NOEEPROM", led_matrix_eeconfig.enable);
 }
@@ -508,7 +414,7 @@ void led_matrix_enable(void) {
 }
 
 void led_matrix_enable_noeeprom(void) {
-    if (!led_matrix_eeconfig.enable) led_task_state = STARTING;
+    if (!led_matrix_eeconfig.enable) led_effect_task_state = STARTING;
     led_matrix_eeconfig.enable = 1;
 }
 
@@ -518,7 +424,7 @@ void led_matrix_disable(void) {
 }
 
 void led_matrix_disable_noeeprom(void) {
-    if (led_matrix_eeconfig.enable) led_task_state = STARTING;
+    if (led_matrix_eeconfig.enable) led_effect_task_state = STARTING;
     led_matrix_eeconfig.enable = 0;
 }
 
@@ -537,7 +443,7 @@ void led_matrix_mode_eeprom_helper(uint8_t mode, bool write_to_eeprom) {
     } else {
         led_matrix_eeconfig.mode = mode;
     }
-    led_task_state = STARTING;
+    led_effect_task_state = STARTING;
     eeconfig_flag_led_matrix(write_to_eeprom);
 #ifdef LED_MATRIX_MODE_NAME_ENABLE
     dprintf("led matrix mode [%s]: %u (%s)\n", (write_to_eeprom) ? "EEPROM" : "NOEEPROM", (unsigned)led_matrix_eeconfig.mode, led_matrix_get_mode_name(led_matrix_eeconfig.mode));
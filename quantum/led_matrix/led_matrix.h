@@ -127,6 +127,9 @@ void eeconfig_debug_led_matrix(void);
 uint8_t led_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i);
 uint8_t led_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i);
 
+led_polar_t led_matrix_led_polar(uint8_t led_index);
+uint8_t     led_matrix_led_distance(uint8_t led_a, uint8_t led_b);
+
 int led_matrix_led_index(int index);
 
 void led_matrix_set_value(int index, uint8_t value);
@@ -187,6 +190,7 @@ void        led_matrix_flags_step_noeeprom(void);
 void        led_matrix_flags_step(void);
 void        led_matrix_flags_step_reverse_noeeprom(void);
 void        led_matrix_flags_step_reverse(void);
+void        led_matrix_update_pwm_buffers(void);
 
 #ifdef LED_MATRIX_MODE_NAME_ENABLE
 const char *led_matrix_get_mode_name(uint8_t mode);
@@ -208,6 +212,13 @@ extern led_eeconfig_t led_matrix_eeconfig;
 
 extern uint32_t     g_led_timer;
 extern led_config_t g_led_config;
+#ifdef LED_MATRIX_LED_GEOMETRY
+// Generated from info.json along with g_led_config
+extern const led_polar_t     g_led_polar[LED_MATRIX_LED_COUNT];
+extern const led_key_t       g_led_key[LED_MATRIX_LED_COUNT];
+extern const uint16_t        g_led_neighbour_start[LED_MATRIX_LED_COUNT + 1];
+extern const led_neighbour_t g_led_neighbours[];
+#endif
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
 extern last_hit_t g_last_hit_tracker;
 #endif
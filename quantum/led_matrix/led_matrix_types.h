@@ -73,6 +73,21 @@ typedef struct PACKED {
     uint8_t     flags[LED_MATRIX_LED_COUNT];
 } led_config_t;
 
+typedef struct PACKED {
+    uint8_t angle;  // atan2_8() of the offset from the matrix centre
+    uint8_t radius; // sqrt16() of the distance from the matrix centre
+} led_polar_t;
+
+typedef struct PACKED {
+    uint8_t index;    // neighbouring LED
+    uint8_t distance; // sqrt16() of the distance between both LEDs
+} led_neighbour_t;
+
+typedef struct PACKED {
+    uint8_t row; // NO_LED if the LED has no key
+    uint8_t col;
+} led_key_t;
+
 typedef union led_eeconfig_t {
     uint32_t raw;
     struct PACKED {
@@ -17,3 +17,8 @@
     defined(ENABLE_LED_MATRIX_SOLID_MULTISPLASH)
 #    define LED_MATRIX_KEYPRESSES
 #endif
+
+// geometry
+#ifndef LED_MATRIX_NEIGHBOUR_RADIUS
+#    define LED_MATRIX_NEIGHBOUR_RADIUS 40
+#endif
@@ -58,6 +58,42 @@ static SPLIT_MUTABLE_COL pin_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
 #    endif // MATRIX_COL_PINS
 #endif
 
+#ifdef MATRIX_PORT_SCAN
+#    if defined(DIRECT_PINS) || !defined(MATRIX_ROW_PINS) || !defined(MATRIX_COL_PINS)
+#        error "MATRIX_PORT_SCAN requires MATRIX_ROW_PINS and MATRIX_COL_PINS"
+#    endif
+#    ifndef gpio_read_port
+#        error "MATRIX_PORT_SCAN is not supported on this platform"
+#    endif
+#    include "matrix_port_plan.h"
+#    if (DIODE_DIRECTION == COL2ROW)
+#        define MATRIX_INPUT_PINS col_pins
+#        define MATRIX_INPUT_COUNT MATRIX_COLS
+#    else
+#        define MATRIX_INPUT_PINS row_pins
+#        define MATRIX_INPUT_COUNT MATRIX_ROWS_PER_HAND
+#    endif
+
+// Input pins are read a port at a time when they fit in a plan, and one
+// at a time otherwise
+static matrix_port_plan_t input_plan;
+static bool               input_plan_ready = false;
+#endif
+
+#ifdef MATRIX_IDLE_ENABLE
+#    ifdef SPLIT_KEYBOARD
+#        error "MATRIX_IDLE_ENABLE is not supported on split keyboards"
+#    endif
+#    ifndef gpio_enable_pin_interrupt
+#        error "MATRIX_IDLE_ENABLE needs pin change interrupts, which this platform does not provide (set PAL_USE_CALLBACKS on ChibiOS)"
+#    endif
+#    ifndef gpio_pin_interrupt_line
+#        define gpio_pin_interrupt_line(pin) (pin)
+#    endif
+#    include "matrix_idle.h"
+#    include "debug.h"
+#endif
+
 /* matrix state(1:on, 0:off) */
 extern matrix_row_t raw_matrix[MATRIX_ROWS]; // raw values
 extern matrix_row_t matrix[MATRIX_ROWS];     // debounced values
@@ -100,6 +136,31 @@ static inline uint8_t readMatrixPin(pin_t pin) {
     }
 }
 
+#ifdef MATRIX_PORT_SCAN
+static void input_plan_init(void) {
+    uintptr_t ports[MATRIX_INPUT_COUNT];
+    uint8_t   bits[MATRIX_INPUT_COUNT];
+    for (uint8_t i = 0; i < MATRIX_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_INPUT_PINS[i];
+        ports[i]  = pin != NO_PIN ? (uintptr_t)gpio_pin_port(pin) : 0;
+        bits[i]   = pin != NO_PIN ? gpio_pin_bit(pin) : MATRIX_PORT_PLAN_NO_BIT;
+    }
+    input_plan_ready = matrix_port_plan_build(&input_plan, ports, bits, MATRIX_INPUT_COUNT);
+}
+
+// Returns the input pins with pressed ones set, pin i in bit i
+static uint32_t read_input_pins(void) {
+    uint32_t values[MATRIX_PORT_PLAN_MAX_PORTS];
+    for (uint8_t i = 0; i < input_plan.port_count; i++) {
+        values[i] = gpio_read_port((gpio_port_t)input_plan.ports[i]);
+#    if MATRIX_INPUT_PRESSED_STATE == 0
+        values[i] = ~values[i];
+#    endif
+    }
+    return matrix_port_plan_gather(&input_plan, values);
+}
+#endif
+
 // matrix code
 
 #ifdef DIRECT_PINS
@@ -177,13 +238,20 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
-    // For each col...
-    matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
-    for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
-        uint8_t pin_state = readMatrixPin(col_pins[col_index]);
-
-        // Populate the matrix row with the state of the col pin
-        current_row_value |= pin_state ? 0 : row_shifter;
+#            ifdef MATRIX_PORT_SCAN
+    if (input_plan_ready) {
+        current_row_value = read_input_pins();
+    } else
+#            endif
+    {
+        // For each col...
+        matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
+        for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
+            uint8_t pin_state = readMatrixPin(col_pins[col_index]);
+
+            // Populate the matrix row with the state of the col pin
+            current_row_value |= pin_state ? 0 : row_shifter;
+        }
     }
 
     // Unselect row
@@ -240,16 +308,28 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
-    // For each row...
-    for (uint8_t row_index = 0; row_index < MATRIX_ROWS_PER_HAND; row_index++) {
-        // Check row pin state
-        if (readMatrixPin(row_pins[row_index]) == 0) {
-            // Pin LO, set col bit
-            current_matrix[row_index] |= row_shifter;
-            key_pressed = true;
-        } else {
-            // Pin HI, clear col bit
-            current_matrix[row_index] &= ~row_shifter;
+#            ifdef MATRIX_PORT_SCAN
+    if (input_plan_ready) {
+        uint32_t rows = read_input_pins();
+        for (uint8_t row_index = 0; row_index < MATRIX_ROWS_PER_HAND; row_index++) {
+            matrix_row_t pressed      = (matrix_row_t)0 - ((rows >> row_index) & 1);
+            current_matrix[row_index] = (current_matrix[row_index] & ~row_shifter) | (pressed & row_shifter);
+        }
+        key_pressed = rows != 0;
+    } else
+#            endif
+    {
+        // For each row...
+        for (uint8_t row_index = 0; row_index < MATRIX_ROWS_PER_HAND; row_index++) {
+            // Check row pin state
+            if (readMatrixPin(row_pins[row_index]) == 0) {
+                // Pin LO, set col bit
+                current_matrix[row_index] |= row_shifter;
+                key_pressed = true;
+            } else {
+                // Pin HI, clear col bit
+                current_matrix[row_index] &= ~row_shifter;
+            }
         }
     }
 
@@ -266,6 +346,130 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_IDLE_ENABLE
+#    if defined(DIRECT_PINS)
+#        define MATRIX_IDLE_INPUTS ((const pin_t *)direct_pins)
+#        define MATRIX_IDLE_INPUT_COUNT (MATRIX_ROWS_PER_HAND * MATRIX_COLS)
+#    elif (DIODE_DIRECTION == COL2ROW)
+#        define MATRIX_IDLE_INPUTS col_pins
+#        define MATRIX_IDLE_INPUT_COUNT MATRIX_COLS
+#    else
+#        define MATRIX_IDLE_INPUTS row_pins
+#        define MATRIX_IDLE_INPUT_COUNT MATRIX_ROWS_PER_HAND
+#    endif
+
+// Pins whose interrupt line already belongs to another driver
+#    if defined(ENCODER_QUADRATURE_INTERRUPT) && defined(ENCODER_A_PINS) && defined(ENCODER_B_PINS)
+static const pin_t idle_reserved_a[] = ENCODER_A_PINS;
+static const pin_t idle_reserved_b[] = ENCODER_B_PINS;
+#    endif
+#    ifdef MATRIX_IDLE_RESERVED_PINS
+static const pin_t idle_reserved_user[] = MATRIX_IDLE_RESERVED_PINS;
+#    endif
+
+static bool idle_lines_free = false;
+
+static bool idle_line_in(pin_t pin, const pin_t *pins, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (pins[i] != NO_PIN && gpio_pin_interrupt_line(pins[i]) == gpio_pin_interrupt_line(pin)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every input needs an interrupt line of its own, otherwise arming one
+// input takes the line away from another and its keys could not wake us
+static bool idle_check_lines(void) {
+    for (uint8_t i = 0; i < MATRIX_IDLE_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_IDLE_INPUTS[i];
+        if (pin == NO_PIN) {
+            continue;
+        }
+        if (idle_line_in(pin, &MATRIX_IDLE_INPUTS[i + 1], MATRIX_IDLE_INPUT_COUNT - i - 1)) {
+            return false;
+        }
+#    if defined(ENCODER_QUADRATURE_INTERRUPT) && defined(ENCODER_A_PINS) && defined(ENCODER_B_PINS)
+        if (idle_line_in(pin, idle_reserved_a, ARRAY_SIZE(idle_reserved_a)) || idle_line_in(pin, idle_reserved_b, ARRAY_SIZE(idle_reserved_b))) {
+            return false;
+        }
+#    endif
+#    ifdef MATRIX_IDLE_RESERVED_PINS
+        if (idle_line_in(pin, idle_reserved_user, ARRAY_SIZE(idle_reserved_user))) {
+            return false;
+        }
+#    endif
+    }
+    return true;
+}
+
+static void matrix_idle_interrupt(void *arg) {
+    (void)arg;
+    matrix_idle_wake();
+}
+
+static void idle_unselect_all(void) {
+#    if defined(DIRECT_PINS)
+#    elif (DIODE_DIRECTION == COL2ROW)
+    unselect_rows();
+#    else
+    unselect_cols();
+#    endif
+}
+
+static void idle_set_interrupts(bool enable) {
+    for (uint8_t i = 0; i < MATRIX_IDLE_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_IDLE_INPUTS[i];
+        if (pin != NO_PIN) {
+            if (enable) {
+                gpio_enable_pin_interrupt(pin, matrix_idle_interrupt);
+            } else {
+                gpio_disable_pin_interrupt(pin);
+            }
+        }
+    }
+}
+
+bool matrix_idle_arm(void) {
+    if (!idle_lines_free) {
+        return false;
+    }
+
+    // Select every output at once, so that any key pulls its input
+#    if defined(DIRECT_PINS)
+#    elif (DIODE_DIRECTION == COL2ROW)
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        select_row(row);
+    }
+#    else
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        select_col(col);
+    }
+#    endif
+    matrix_output_select_delay();
+
+    // Interrupts go on before the inputs are checked, so a key pressed in
+    // between is not missed
+    idle_set_interrupts(true);
+
+    bool key_pressed = false;
+    for (uint8_t i = 0; i < MATRIX_IDLE_INPUT_COUNT && !key_pressed; i++) {
+        key_pressed = readMatrixPin(MATRIX_IDLE_INPUTS[i]) == 0;
+    }
+    if (key_pressed) {
+        matrix_idle_disarm();
+        return false;
+    }
+    return true;
+}
+
+void matrix_idle_disarm(void) {
+    idle_set_interrupts(false);
+    idle_unselect_all();
+    matrix_output_unselect_delay(0, true);
+}
+#endif
+
 void matrix_init(void) {
 #ifdef SPLIT_KEYBOARD
     // Set pinout for right half if pinout for that half is defined
@@ -296,6 +500,10 @@ void matrix_init(void) {
     thatHand = MATRIX_ROWS_PER_HAND - thisHand;
 #endif
 
+#ifdef MATRIX_PORT_SCAN
+    input_plan_init();
+#endif
+
     // initialize key pins
     matrix_init_pins();
 
@@ -305,6 +513,13 @@ void matrix_init(void) {
 
     debounce_init();
 
+#ifdef MATRIX_IDLE_ENABLE
+    idle_lines_free = idle_check_lines();
+    if (!idle_lines_free) {
+        dprintf("matrix idle: inputs share an interrupt line, scanning continuously\n");
+    }
+#endif
+
     matrix_init_kb();
 }
 
@@ -319,6 +534,10 @@ __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_mat
 uint8_t matrix_scan(void) {
     matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
 
+#ifdef MATRIX_IDLE_ENABLE
+    matrix_idle_exit();
+#endif
+
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS_PER_HAND; current_row++) {
@@ -0,0 +1,60 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "matrix_idle.h"
+#include "matrix.h"
+#include "keyboard.h"
+
+extern matrix_row_t matrix_previous[MATRIX_ROWS];
+
+static volatile bool woken = false;
+static bool          idle  = false;
+
+// Both as debounced and as last handled by keyboard_task()
+static bool all_keys_released(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (matrix_get_row(row) | matrix_previous[row]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool matrix_idle_task(void) {
+    if (idle) {
+        if (!woken) {
+            return false;
+        }
+        matrix_idle_exit();
+        return true;
+    }
+
+    // A held key, or a release the debouncer has not passed on yet, keeps
+    // the matrix scanning
+    if (last_matrix_activity_elapsed() < MATRIX_IDLE_TIMEOUT || !all_keys_released()) {
+        return true;
+    }
+
+    // Cleared before arming so that an interrupt fired while arming is kept
+    woken = false;
+    if (!matrix_idle_arm()) {
+        return true;
+    }
+    idle = true;
+    return false;
+}
+
+void matrix_idle_exit(void) {
+    if (idle) {
+        matrix_idle_disarm();
+        idle = false;
+    }
+}
+
+void matrix_idle_wake(void) {
+    woken = true;
+}
+
+bool matrix_is_idle(void) {
+    return idle;
+}
@@ -0,0 +1,54 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Stops scanning the matrix while nothing is happening.
+ *
+ * Once no key has been down for MATRIX_IDLE_TIMEOUT milliseconds, the
+ * matrix is armed: every output is driven active and a pin change interrupt
+ * is enabled on every input, so that pressing any key fires an interrupt.
+ * Scanning stops until the interrupt calls matrix_idle_wake(); the matrix is
+ * then disarmed and scanned on the same keyboard_task(), so the key that
+ * woke it up is seen by the first scan.
+ */
+
+#ifndef MATRIX_IDLE_TIMEOUT
+#    define MATRIX_IDLE_TIMEOUT 1000
+#endif
+
+/**
+ * \brief Decide whether the matrix has to be scanned, arming or disarming it as needed.
+ *
+ * \return false while the matrix is idle.
+ */
+bool matrix_idle_task(void);
+
+/**
+ * \brief Leave idle on the next matrix_idle_task(). Safe to call from an interrupt.
+ */
+void matrix_idle_wake(void);
+
+/**
+ * \brief Disarm the matrix if it is idle, for code that scans it without matrix_idle_task().
+ */
+void matrix_idle_exit(void);
+
+bool matrix_is_idle(void);
+
+/**
+ * \brief Drive every output active and enable the input interrupts, provided by the matrix.
+ *
+ * \return false if a key is already down, or if the inputs cannot each have an
+ *         interrupt line of their own, in which case the matrix is left as it was.
+ */
+bool matrix_idle_arm(void);
+
+/**
+ * \brief Disable the input interrupts and return the pins to scanning, provided by the matrix.
+ */
+void matrix_idle_disarm(void);
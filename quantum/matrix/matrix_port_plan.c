@@ -0,0 +1,45 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "matrix_port_plan.h"
+
+bool matrix_port_plan_build(matrix_port_plan_t *plan, const uintptr_t *ports, const uint8_t *bits, uint8_t count) {
+    plan->port_count = 0;
+    plan->step_count = 0;
+    if (count > 32) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (bits[i] >= 32) {
+            continue;
+        }
+
+        uint8_t port = 0;
+        while (port < plan->port_count && plan->ports[port] != ports[i]) {
+            port++;
+        }
+        if (port == plan->port_count) {
+            if (port == MATRIX_PORT_PLAN_MAX_PORTS) {
+                return false;
+            }
+            plan->ports[plan->port_count++] = ports[i];
+        }
+
+        uint8_t left  = i > bits[i] ? i - bits[i] : 0;
+        uint8_t right = bits[i] > i ? bits[i] - i : 0;
+
+        uint8_t step = 0;
+        while (step < plan->step_count && !(plan->steps[step].port == port && plan->steps[step].left == left && plan->steps[step].right == right)) {
+            step++;
+        }
+        if (step == plan->step_count) {
+            if (step == MATRIX_PORT_PLAN_MAX_STEPS) {
+                return false;
+            }
+            plan->steps[plan->step_count++] = (matrix_port_step_t){0, port, left, right};
+        }
+        plan->steps[step].mask |= (uint32_t)1 << bits[i];
+    }
+    return true;
+}
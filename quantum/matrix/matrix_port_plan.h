@@ -0,0 +1,66 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * A plan for reading a set of input pins with one read per GPIO port.
+ *
+ * Pins whose bit position in their port is at the same offset from their
+ * position in the result are gathered by a single mask and shift, so pins
+ * wired in order to consecutive port bits cost one step however many of
+ * them there are.
+ */
+
+#ifndef MATRIX_PORT_PLAN_MAX_PORTS
+#    define MATRIX_PORT_PLAN_MAX_PORTS 4
+#endif
+
+#ifndef MATRIX_PORT_PLAN_MAX_STEPS
+#    define MATRIX_PORT_PLAN_MAX_STEPS 16
+#endif
+
+// Bit of a pin that is not connected
+#define MATRIX_PORT_PLAN_NO_BIT 0xFF
+
+typedef struct matrix_port_step_t {
+    uint32_t mask; // port bits gathered by this step
+    uint8_t  port; // index into the plan's ports
+    uint8_t  left;
+    uint8_t  right;
+} matrix_port_step_t;
+
+typedef struct matrix_port_plan_t {
+    uint8_t            port_count;
+    uint8_t            step_count;
+    uintptr_t          ports[MATRIX_PORT_PLAN_MAX_PORTS];
+    matrix_port_step_t steps[MATRIX_PORT_PLAN_MAX_STEPS];
+} matrix_port_plan_t;
+
+/**
+ * \brief Build a plan for reading `count` pins.
+ *
+ * \param ports The port of each pin, as understood by the platform.
+ * \param bits The bit of each pin within its port, MATRIX_PORT_PLAN_NO_BIT for none.
+ * \param count Number of pins, at most 32.
+ *
+ * \return false if the pins need more ports or steps than a plan can hold.
+ */
+bool matrix_port_plan_build(matrix_port_plan_t *plan, const uintptr_t *ports, const uint8_t *bits, uint8_t count);
+
+/**
+ * \brief Gather the pins from the values read from the plan's ports.
+ *
+ * \return The pins, with pin `i` in bit `i`. Pins with no bit read as 0.
+ */
+static inline uint32_t matrix_port_plan_gather(const matrix_port_plan_t *plan, const uint32_t *values) {
+    uint32_t pins = 0;
+    for (uint8_t i = 0; i < plan->step_count; i++) {
+        const matrix_port_step_t *step = &plan->steps[i];
+        pins |= ((values[step->port] & step->mask) << step->left) >> step->right;
+    }
+    return pins;
+}
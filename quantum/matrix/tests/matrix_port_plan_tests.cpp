@@ -0,0 +1,142 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "matrix_port_plan.h"
+}
+
+struct pin_map_t {
+    std::vector<uintptr_t> ports;
+    std::vector<uint8_t>   bits;
+};
+
+class MatrixPortPlanTest : public ::testing::Test {
+   protected:
+    uint32_t random() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) ^ (seed << 16);
+    }
+
+    // The pins as readMatrixPin() would see them, one at a time
+    static uint32_t reference(const pin_map_t &map, const std::vector<uintptr_t> &port_ids, const uint32_t *values) {
+        uint32_t pins = 0;
+        for (size_t i = 0; i < map.bits.size(); i++) {
+            if (map.bits[i] == MATRIX_PORT_PLAN_NO_BIT) {
+                continue;
+            }
+            for (size_t p = 0; p < port_ids.size(); p++) {
+                if (port_ids[p] == map.ports[i] && (values[p] >> map.bits[i]) & 1) {
+                    pins |= (uint32_t)1 << i;
+                }
+            }
+        }
+        return pins;
+    }
+
+    // Compare the plan with the reference over random port values
+    void check(const pin_map_t &map, const matrix_port_plan_t &plan) {
+        std::vector<uintptr_t> port_ids(plan.ports, plan.ports + plan.port_count);
+        uint32_t               values[MATRIX_PORT_PLAN_MAX_PORTS];
+
+        for (int n = 0; n < 200; n++) {
+            for (uint8_t p = 0; p < plan.port_count; p++) {
+                values[p] = n == 0 ? 0 : n == 1 ? UINT32_MAX : random();
+            }
+            ASSERT_EQ(matrix_port_plan_gather(&plan, values), reference(map, port_ids, values)) << "values " << n;
+        }
+    }
+
+    uint32_t seed = 1;
+};
+
+TEST_F(MatrixPortPlanTest, ConsecutivePinsShareAStep) {
+    pin_map_t map;
+    for (uint8_t i = 0; i < 16; i++) {
+        map.ports.push_back(0x1000);
+        map.bits.push_back(i + 2);
+    }
+
+    matrix_port_plan_t plan;
+    ASSERT_TRUE(matrix_port_plan_build(&plan, map.ports.data(), map.bits.data(), map.bits.size()));
+    EXPECT_EQ(plan.port_count, 1);
+    EXPECT_EQ(plan.step_count, 1);
+    EXPECT_EQ(plan.steps[0].mask, 0xFFFFu << 2);
+    check(map, plan);
+}
+
+TEST_F(MatrixPortPlanTest, TwoPortsInTwoRuns) {
+    // A typical STM32 board: columns on PA0..PA7 then PB12..PB15, with a gap
+    pin_map_t map = {{0xA, 0xA, 0xA, 0xA, 0xA, 0xA, 0xA, 0xA, 0xB, 0xB, 0, 0xB, 0xB}, {0, 1, 2, 3, 4, 5, 6, 7, 12, 13, MATRIX_PORT_PLAN_NO_BIT, 14, 15}};
+
+    matrix_port_plan_t plan;
+    ASSERT_TRUE(matrix_port_plan_build(&plan, map.ports.data(), map.bits.data(), map.bits.size()));
+    EXPECT_EQ(plan.port_count, 2);
+    EXPECT_EQ(plan.step_count, 3);
+    check(map, plan);
+
+    // Missing pins read as released
+    uint32_t values[] = {UINT32_MAX, UINT32_MAX};
+    EXPECT_EQ(matrix_port_plan_gather(&plan, values), 0x1BFFu);
+}
+
+TEST_F(MatrixPortPlanTest, ReversedPins) {
+    pin_map_t map;
+    for (uint8_t i = 0; i < 8; i++) {
+        map.ports.push_back(1);
+        map.bits.push_back(7 - i);
+    }
+
+    matrix_port_plan_t plan;
+    ASSERT_TRUE(matrix_port_plan_build(&plan, map.ports.data(), map.bits.data(), map.bits.size()));
+    EXPECT_EQ(plan.step_count, 8);
+    check(map, plan);
+}
+
+TEST_F(MatrixPortPlanTest, ArbitraryPinMaps) {
+    int built = 0;
+    for (int n = 0; n < 500; n++) {
+        pin_map_t map;
+        uint8_t   count = 1 + random() % 32;
+        uint8_t   ports = 1 + random() % 3;
+        for (uint8_t i = 0; i < count; i++) {
+            // Mostly runs of consecutive bits, like real boards
+            uint8_t bit = i > 0 && map.bits[i - 1] < 31 && random() % 4 ? map.bits[i - 1] + 1 : random() % 32;
+            map.ports.push_back(i > 0 && random() % 4 ? map.ports[i - 1] : 0x40000000 + 0x400 * (random() % ports));
+            map.bits.push_back(random() % 16 == 0 ? MATRIX_PORT_PLAN_NO_BIT : bit);
+        }
+
+        matrix_port_plan_t plan;
+        if (!matrix_port_plan_build(&plan, map.ports.data(), map.bits.data(), count)) {
+            continue;
+        }
+        check(map, plan);
+        built++;
+    }
+    EXPECT_GT(built, 250);
+}
+
+TEST_F(MatrixPortPlanTest, TooManyStepsFallsBack) {
+    pin_map_t map;
+    for (uint8_t i = 0; i < MATRIX_PORT_PLAN_MAX_STEPS + 1; i++) {
+        map.ports.push_back(1);
+        map.bits.push_back(31 - i);
+    }
+
+    matrix_port_plan_t plan;
+    EXPECT_FALSE(matrix_port_plan_build(&plan, map.ports.data(), map.bits.data(), map.bits.size()));
+}
+
+TEST_F(MatrixPortPlanTest, TooManyPortsFallsBack) {
+    pin_map_t map;
+    for (uint8_t i = 0; i < MATRIX_PORT_PLAN_MAX_PORTS + 1; i++) {
+        map.ports.push_back(i);
+        map.bits.push_back(0);
+    }
+
+    matrix_port_plan_t plan;
+    EXPECT_FALSE(matrix_port_plan_build(&plan, map.ports.data(), map.bits.data(), map.bits.size()));
+}
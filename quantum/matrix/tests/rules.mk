@@ -0,0 +1,6 @@
+matrix_port_plan_SRC := \
+    $(QUANTUM_PATH)/matrix/tests/matrix_port_plan_tests.cpp \
+    $(QUANTUM_PATH)/matrix/matrix_port_plan.c
+
+matrix_port_plan_INC := \
+    $(QUANTUM_PATH)/matrix
@@ -0,0 +1,42 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "compiler_support.h"
+#include "eeprom.h"
+#include "util.h"
+#include "nvm_dynamic_macro.h"
+#include "nvm_eeprom_dynamic_macro_internal.h"
+
+STATIC_ASSERT(DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_EEPROM_SIZE <= TOTAL_EEPROM_BYTE_COUNT, "Persisted dynamic macros are configured to use more space than what is available for the selected EEPROM driver");
+
+void nvm_dynamic_macro_erase(void) {
+    // No-op, nvm_eeconfig_erase() will have already erased EEPROM if necessary.
+}
+
+uint32_t nvm_dynamic_macro_size(void) {
+    return DYNAMIC_MACRO_EEPROM_SIZE;
+}
+
+uint32_t nvm_dynamic_macro_read(void *buf, uint32_t offset, uint32_t length) {
+#if DYNAMIC_MACRO_EEPROM_SIZE > 0
+    if (offset >= DYNAMIC_MACRO_EEPROM_SIZE) return 0;
+    void *ee_start = (void *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_ADDR + offset);
+    void *ee_end   = (void *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_ADDR + MIN(DYNAMIC_MACRO_EEPROM_SIZE, offset + length));
+    eeprom_read_block(buf, ee_start, ee_end - ee_start);
+    return ee_end - ee_start;
+#else
+    return 0;
+#endif
+}
+
+uint32_t nvm_dynamic_macro_update(const void *buf, uint32_t offset, uint32_t length) {
+#if DYNAMIC_MACRO_EEPROM_SIZE > 0
+    if (offset >= DYNAMIC_MACRO_EEPROM_SIZE) return 0;
+    void *ee_start = (void *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_ADDR + offset);
+    void *ee_end   = (void *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_ADDR + MIN(DYNAMIC_MACRO_EEPROM_SIZE, offset + length));
+    eeprom_update_block(buf, ee_start, ee_end - ee_start);
+    return ee_end - ee_start;
+#else
+    return 0;
+#endif
+}
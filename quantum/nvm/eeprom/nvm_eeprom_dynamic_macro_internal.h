@@ -0,0 +1,20 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "eeprom.h"
+
+// Persisted dynamic macros occupy the top of EEPROM, so dynamic keymap
+// macros stop short of them. Nothing is reserved unless the keyboard opts
+// in with DYNAMIC_MACRO_PERSISTENT.
+#ifndef DYNAMIC_MACRO_EEPROM_SIZE
+#    if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_PERSISTENT)
+#        define DYNAMIC_MACRO_EEPROM_SIZE 256
+#    else
+#        define DYNAMIC_MACRO_EEPROM_SIZE 0
+#    endif
+#endif
+
+#ifndef DYNAMIC_MACRO_EEPROM_ADDR
+#    define DYNAMIC_MACRO_EEPROM_ADDR (TOTAL_EEPROM_BYTE_COUNT - DYNAMIC_MACRO_EEPROM_SIZE)
+#endif
@@ -19,4 +19,7 @@
 // custom config
 #define VIA_EEPROM_CUSTOM_CONFIG_ADDR (VIA_EEPROM_LAYOUT_OPTIONS_ADDR + VIA_EEPROM_LAYOUT_OPTIONS_SIZE)
 
-#define VIA_EEPROM_CONFIG_END (VIA_EEPROM_CUSTOM_CONFIG_ADDR + VIA_EEPROM_CUSTOM_CONFIG_SIZE)
+// An uploaded RGB Matrix lighting program follows the custom config
+#define VIA_EEPROM_RGB_MATRIX_PROGRAM_ADDR (VIA_EEPROM_CUSTOM_CONFIG_ADDR + VIA_EEPROM_CUSTOM_CONFIG_SIZE)
+
+#define VIA_EEPROM_CONFIG_END (VIA_EEPROM_RGB_MATRIX_PROGRAM_ADDR + VIA_EEPROM_RGB_MATRIX_PROGRAM_SIZE)
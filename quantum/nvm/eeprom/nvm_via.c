@@ -75,3 +75,23 @@ uint32_t nvm_via_update_custom_config(const void *buf, uint32_t offset, uint32_t
     return 0;
 #endif
 }
+
+uint32_t nvm_via_read_rgb_matrix_program(void *buf, uint32_t length) {
+#if VIA_EEPROM_RGB_MATRIX_PROGRAM_SIZE > 0
+    length = MIN(VIA_EEPROM_RGB_MATRIX_PROGRAM_SIZE, length);
+    eeprom_read_block(buf, (void *)(uintptr_t)VIA_EEPROM_RGB_MATRIX_PROGRAM_ADDR, length);
+    return length;
+#else
+    return 0;
+#endif
+}
+
+uint32_t nvm_via_update_rgb_matrix_program(const void *buf, uint32_t length) {
+#if VIA_EEPROM_RGB_MATRIX_PROGRAM_SIZE > 0
+    length = MIN(VIA_EEPROM_RGB_MATRIX_PROGRAM_SIZE, length);
+    eeprom_update_block(buf, (void *)(uintptr_t)VIA_EEPROM_RGB_MATRIX_PROGRAM_ADDR, length);
+    return length;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,12 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void nvm_dynamic_macro_erase(void);
+
+uint32_t nvm_dynamic_macro_size(void);
+uint32_t nvm_dynamic_macro_read(void *buf, uint32_t offset, uint32_t length);
+uint32_t nvm_dynamic_macro_update(const void *buf, uint32_t offset, uint32_t length);
@@ -15,3 +15,6 @@ void     nvm_via_update_layout_options(uint32_t val);
 
 uint32_t nvm_via_read_custom_config(void *buf, uint32_t offset, uint32_t length);
 uint32_t nvm_via_update_custom_config(const void *buf, uint32_t offset, uint32_t length);
+
+uint32_t nvm_via_read_rgb_matrix_program(void *buf, uint32_t length);
+uint32_t nvm_via_update_rgb_matrix_program(const void *buf, uint32_t length);
@@ -11,6 +11,8 @@
 #include "keycode_config.h"
 #include "send_string.h"
 #include "action_util.h"
+#include "bitwise.h"
+#include "debug.h"
 
 #if __has_include("autocorrect_data.h")
 #    include "autocorrect_data.h"
@@ -19,9 +21,51 @@
 #    include "autocorrect_data_default.h"
 #endif
 
+#if !defined(AUTOCORRECT_FORMAT) || AUTOCORRECT_FORMAT != 2
+#    error "autocorrect_data.h was generated for an older version of autocorrect, regenerate it with qmk generate-autocorrect-data"
+#endif
+
+#ifdef AUTOCORRECT_DATA_EXTERNAL
+#    ifndef FLASH_ENABLE
+#        error "A dictionary in external flash requires FLASH_DRIVER to be set"
+#    endif
+#    include "flash.h"
+#    ifndef AUTOCORRECT_FLASH_ADDRESS
+#        define AUTOCORRECT_FLASH_ADDRESS 0
+#    endif
+// Magic number and checksum written by qmk generate-autocorrect-data --flash
+#    define AUTOCORRECT_FLASH_HEADER_SIZE 8
+#endif
+
+// Node header, see the appendix of docs/features/autocorrect.md
+#define AUTOCORRECT_NODE_LEAF 0x80
+#define AUTOCORRECT_NODE_BITMAP 0x40
+#define AUTOCORRECT_NODE_FAIL_MASK 0x30
+#define AUTOCORRECT_NODE_FAIL_LINK 0x00
+#define AUTOCORRECT_NODE_FAIL_ROOT 0x10
+#define AUTOCORRECT_NODE_FAIL_LAST 0x20
+#define AUTOCORRECT_NODE_CHAIN 0x08
+#define AUTOCORRECT_NODE_CHAIN_LEAF 0x04
+#define AUTOCORRECT_NODE_COUNT_MASK 0x03
+#define AUTOCORRECT_NODE_READ_SIZE 8
+
+#if AUTOCORRECT_LINK_SIZE > 2
+typedef uint32_t autocorrect_state_t;
+#else
+typedef uint16_t autocorrect_state_t;
+#endif
+
+// Set in links to leaf nodes
+#define AUTOCORRECT_LINK_LEAF ((autocorrect_state_t)1 << (AUTOCORRECT_LINK_SIZE * 8 - 1))
+
 static uint8_t typo_buffer[AUTOCORRECT_MAX_LENGTH] = {KC_SPC};
 static uint8_t typo_buffer_size                    = 1;
 
+// Automaton state after each key of the buffer, valid for the first
+// `typo_states_size` keys.
+static autocorrect_state_t typo_states[AUTOCORRECT_MAX_LENGTH];
+static uint8_t             typo_states_size = 0;
+
 /**
  * @brief function for querying the enabled state of autocorrect
  *
@@ -189,6 +233,135 @@ __attribute__((weak)) bool apply_autocorrect(uint8_t backspaces, const char *str
     return true;
 }
 
+static void autocorrect_read(autocorrect_state_t offset, void *data, uint8_t size) {
+#ifdef AUTOCORRECT_DATA_EXTERNAL
+    flash_read_range(AUTOCORRECT_FLASH_ADDRESS + AUTOCORRECT_FLASH_HEADER_SIZE + offset, data, size);
+#else
+    memcpy_P(data, autocorrect_data + offset, size);
+#endif
+}
+
+/**
+ * @brief checks once that the dictionary in external flash matches autocorrect_data.h
+ *
+ * @return true if the dictionary can be used
+ */
+static bool autocorrect_data_valid(void) {
+#ifdef AUTOCORRECT_DATA_EXTERNAL
+    static int8_t valid = -1;
+    if (valid < 0) {
+        uint8_t header[AUTOCORRECT_FLASH_HEADER_SIZE];
+        valid = flash_read_range(AUTOCORRECT_FLASH_ADDRESS, header, sizeof(header)) == FLASH_STATUS_SUCCESS && memcmp(header, "QKAC", 4) == 0 && (header[4] | (uint32_t)header[5] << 8 | (uint32_t)header[6] << 16 | (uint32_t)header[7] << 24) == AUTOCORRECT_DATA_CHECKSUM;
+        if (!valid) {
+            dprintf("autocorrect: no matching dictionary in flash at 0x%lX\n", (unsigned long)AUTOCORRECT_FLASH_ADDRESS);
+        }
+    }
+    return valid;
+#else
+    return true;
+#endif
+}
+
+static autocorrect_state_t autocorrect_link(const uint8_t *data) {
+    autocorrect_state_t link = 0;
+    for (uint8_t i = 0; i < AUTOCORRECT_LINK_SIZE; ++i) {
+        link |= (autocorrect_state_t)data[i] << (i * 8);
+    }
+    return link;
+}
+
+/**
+ * @brief bit of a typo character in the child bitmap of a node
+ */
+static uint8_t autocorrect_symbol_bit(uint8_t keycode) {
+    switch (keycode) {
+        case KC_QUOTE:
+            return 26;
+        case KC_SPC:
+            return 27;
+        default:
+            return keycode - KC_A;
+    }
+}
+
+/**
+ * @brief advances the automaton by one key
+ *
+ * Follows failure links, each to a shorter suffix of the typed keys, until a
+ * node has a child for `keycode`. This takes O(1) steps on average, as every
+ * key adds at most one level.
+ *
+ * @param state current node, not a leaf
+ * @param last the key that led to `state`, resolves AUTOCORRECT_NODE_FAIL_LAST
+ * @param keycode the key typed
+ * @return the next node, with AUTOCORRECT_LINK_LEAF set if a typo was found
+ */
+static autocorrect_state_t autocorrect_step(autocorrect_state_t state, uint8_t last, uint8_t keycode) {
+    for (;;) {
+        uint8_t data[AUTOCORRECT_NODE_READ_SIZE];
+        autocorrect_read(state, data, sizeof(data));
+
+        uint8_t             header = data[0];
+        uint8_t             pos    = 1;
+        autocorrect_state_t fail   = 0;
+        if ((header & AUTOCORRECT_NODE_FAIL_MASK) == AUTOCORRECT_NODE_FAIL_LINK) {
+            fail = autocorrect_link(&data[pos]);
+            pos += AUTOCORRECT_LINK_SIZE;
+        }
+
+        int8_t index = -1;
+        if (header & AUTOCORRECT_NODE_BITMAP) {
+            uint32_t bitmap = data[pos] | (uint32_t)data[pos + 1] << 8 | (uint32_t)data[pos + 2] << 16 | (uint32_t)data[pos + 3] << 24;
+            uint32_t bit    = (uint32_t)1 << autocorrect_symbol_bit(keycode);
+            if (bitmap & bit) {
+                index = bitpop32(bitmap & (bit - 1));
+            }
+            pos += 4;
+        } else {
+            // Children sorted by keycode
+            uint8_t count = (header & AUTOCORRECT_NODE_COUNT_MASK) + 1;
+            for (uint8_t i = 0; i < count && data[pos + i] <= keycode; ++i) {
+                if (data[pos + i] == keycode) {
+                    index = i;
+                }
+            }
+            pos += count;
+        }
+
+        if (index >= 0) {
+            // An only child is stored right after its parent
+            if (header & AUTOCORRECT_NODE_CHAIN) {
+                return (state + pos) | (header & AUTOCORRECT_NODE_CHAIN_LEAF ? AUTOCORRECT_LINK_LEAF : 0);
+            }
+            uint8_t link[AUTOCORRECT_LINK_SIZE];
+            autocorrect_read(state + pos + index * AUTOCORRECT_LINK_SIZE, link, sizeof(link));
+            return autocorrect_link(link);
+        }
+
+        if (state == 0) {
+            return 0;
+        }
+        switch (header & AUTOCORRECT_NODE_FAIL_MASK) {
+            case AUTOCORRECT_NODE_FAIL_ROOT:
+                state = 0;
+                break;
+            case AUTOCORRECT_NODE_FAIL_LAST:
+                // The root always has a child for `last`
+                state = autocorrect_step(0, 0, last);
+                break;
+            default:
+                state = fail;
+                break;
+        }
+
+        // Stop if `state` becomes an invalid index. This should not normally
+        // happen, it is a safeguard in case of a bug, data corruption, etc.
+        if (state >= DICTIONARY_SIZE) {
+            return 0;
+        }
+    }
+}
+
 /**
  * @brief Process handler for autocorrect feature
  *
@@ -269,108 +442,124 @@ bool process_autocorrect(uint16_t keycode, keyrecord_t *record) {
     // Rotate oldest character if buffer is full.
     if (typo_buffer_size >= AUTOCORRECT_MAX_LENGTH) {
         memmove(typo_buffer, typo_buffer + 1, AUTOCORRECT_MAX_LENGTH - 1);
+        memmove(typo_states, typo_states + 1, (AUTOCORRECT_MAX_LENGTH - 1) * sizeof(typo_states[0]));
         typo_buffer_size = AUTOCORRECT_MAX_LENGTH - 1;
+        if (typo_states_size > 0) {
+            --typo_states_size;
+        }
     }
 
+    // Forget the states of keys that were removed from the buffer.
+    if (typo_states_size > typo_buffer_size) {
+        typo_states_size = typo_buffer_size;
+    }
     // Append `keycode` to buffer.
     typo_buffer[typo_buffer_size++] = keycode;
     // Return if buffer is smaller than the shortest word.
-    if (typo_buffer_size < AUTOCORRECT_MIN_LENGTH) {
+    if (typo_buffer_size < AUTOCORRECT_MIN_LENGTH || !autocorrect_data_valid()) {
         return true;
     }
 
-    // Check for typo in buffer using a trie stored in `autocorrect_data`.
-    uint16_t state = 0;
-    uint8_t  code  = pgm_read_byte(autocorrect_data + state);
-    for (int8_t i = typo_buffer_size - 1; i >= 0; --i) {
-        uint8_t const key_i = typo_buffer[i];
-
-        if (code & 64) { // Check for match in node with multiple children.
-            code &= 63;
-            for (; code != key_i; code = pgm_read_byte(autocorrect_data + (state += 3))) {
-                if (!code) return true;
-            }
-            // Follow link to child node.
-            state = (pgm_read_byte(autocorrect_data + state + 1) | pgm_read_byte(autocorrect_data + state + 2) << 8);
-            // Check for match in node with single child.
-        } else if (code != key_i) {
-            return true;
-        } else if (!(code = pgm_read_byte(autocorrect_data + (++state)))) {
-            ++state;
+    // Advance the automaton stored in `autocorrect_data` over the keys it has
+    // not seen yet, usually just `keycode`.
+    while (typo_states_size < typo_buffer_size) {
+        uint8_t             i     = typo_states_size;
+        autocorrect_state_t state = i > 0 ? typo_states[i - 1] : 0;
+        if (state & AUTOCORRECT_LINK_LEAF) {
+            // Only possible when the buffer was cut short, start over
+            state = 0;
         }
+        typo_states[typo_states_size++] = autocorrect_step(state, i > 0 ? typo_buffer[i - 1] : 0, typo_buffer[i]);
+    }
 
-        // Stop if `state` becomes an invalid index. This should not normally
-        // happen, it is a safeguard in case of a bug, data corruption, etc.
-        if (state >= DICTIONARY_SIZE) {
-            return true;
-        }
+    autocorrect_state_t state = typo_states[typo_buffer_size - 1];
+    if (!(state & AUTOCORRECT_LINK_LEAF)) {
+        return true;
+    }
 
-        code = pgm_read_byte(autocorrect_data + state);
-
-        if (code & 128) { // A typo was found! Apply autocorrect.
-            const uint8_t backspaces = (code & 63) + !record->event.pressed;
-            const char   *changes    = (const char *)(autocorrect_data + state + 1);
-
-            /* Gather info about the typo'd word
-             *
-             * Since buffer may contain several words, delimited by spaces, we
-             * iterate from the end to find the start and length of the typo
-             */
-            char typo[AUTOCORRECT_MAX_LENGTH + 1] = {0}; // extra char for null terminator
-
-            uint8_t typo_len   = 0;
-            uint8_t typo_start = 0;
-            bool    space_last = typo_buffer[typo_buffer_size - 1] == KC_SPC;
-            for (uint8_t i = typo_buffer_size; i > 0; --i) {
-                // stop counting after finding space (unless it is the last thing)
-                if (typo_buffer[i - 1] == KC_SPC && i != typo_buffer_size) {
-                    typo_start = i;
-                    break;
-                }
+    // A typo was found! Apply autocorrect.
+    state &= ~AUTOCORRECT_LINK_LEAF;
+    uint8_t code;
+    autocorrect_read(state, &code, sizeof(code));
+    const uint8_t backspaces = (code & 63) + !record->event.pressed;
+#ifdef AUTOCORRECT_DATA_EXTERNAL
+    char changes[AUTOCORRECT_MAX_CORRECTION_LENGTH + 1];
+    autocorrect_read(state + 1, changes, sizeof(changes));
+    changes[AUTOCORRECT_MAX_CORRECTION_LENGTH] = 0;
+#else
+    const char *changes = (const char *)(autocorrect_data + state + 1);
+#endif
 
-                ++typo_len;
-            }
+    /* Gather info about the typo'd word
+     *
+     * Since buffer may contain several words, delimited by spaces, we
+     * iterate from the end to find the start and length of the typo
+     */
+    char typo[AUTOCORRECT_MAX_LENGTH + 1] = {0}; // extra char for null terminator
+
+    uint8_t typo_len   = 0;
+    uint8_t typo_start = 0;
+    bool    space_last = typo_buffer[typo_buffer_size - 1] == KC_SPC;
+    for (uint8_t i = typo_buffer_size; i > 0; --i) {
+        // stop counting after finding space (unless it is the last thing)
+        if (typo_buffer[i - 1] == KC_SPC && i != typo_buffer_size) {
+            typo_start = i;
+            break;
+        }
 
-            // when detecting 'typo:', reduce the length of the string by one
-            if (space_last) {
-                --typo_len;
-            }
+        ++typo_len;
+    }
 
-            // convert buffer of keycodes into a string
-            for (uint8_t i = 0; i < typo_len; ++i) {
-                typo[i] = typo_buffer[typo_start + i] - KC_A + 'a';
-            }
+    // when detecting 'typo:', reduce the length of the string by one
+    if (space_last) {
+        --typo_len;
+    }
 
-            /* Gather the corrected word
-             *
-             * A) Correction of 'typo:' -- Code takes into account
-             * an extra backspace to delete the space (which we dont copy)
-             * for this reason the offset is correct to "skip" the null terminator
-             *
-             * B) When correcting 'typo' -- Need extra offset for terminator
-             */
-            char correct[AUTOCORRECT_MAX_LENGTH + 10] = {0}; // let's hope this is big enough
-
-            uint8_t offset = space_last ? backspaces : backspaces + 1;
-            strcpy(correct, typo);
-            strcpy_P(correct + typo_len - offset, changes);
-
-            if (apply_autocorrect(backspaces, changes, typo, correct)) {
-                for (uint8_t i = 0; i < backspaces; ++i) {
-                    tap_code(KC_BSPC);
-                }
-                send_string_P(changes);
-            }
+    // convert buffer of keycodes into a string
+    for (uint8_t i = 0; i < typo_len; ++i) {
+        typo[i] = typo_buffer[typo_start + i] - KC_A + 'a';
+    }
 
-            if (keycode == KC_SPC) {
-                typo_buffer[0]   = KC_SPC;
-                typo_buffer_size = 1;
-                return true;
-            } else {
-                typo_buffer_size = 0;
-                return false;
-            }
+    /* Gather the corrected word
+     *
+     * A) Correction of 'typo:' -- Code takes into account
+     * an extra backspace to delete the space (which we dont copy)
+     * for this reason the offset is correct to "skip" the null terminator
+     *
+     * B) When correcting 'typo' -- Need extra offset for terminator
+     */
+    char correct[AUTOCORRECT_MAX_LENGTH + 10] = {0}; // let's hope this is big enough
+
+    uint8_t offset = space_last ? backspaces : backspaces + 1;
+    // A typo that began before the oldest buffered key
+    if (offset > typo_len) {
+        offset = typo_len;
+    }
+    strcpy(correct, typo);
+#ifdef AUTOCORRECT_DATA_EXTERNAL
+    strcpy(correct + typo_len - offset, changes);
+#else
+    strcpy_P(correct + typo_len - offset, changes);
+#endif
+
+    if (apply_autocorrect(backspaces, changes, typo, correct)) {
+        for (uint8_t i = 0; i < backspaces; ++i) {
+            tap_code(KC_BSPC);
         }
+#ifdef AUTOCORRECT_DATA_EXTERNAL
+        send_string(changes);
+#else
+        send_string_P(changes);
+#endif
+    }
+
+    typo_states_size = 0;
+    if (keycode == KC_SPC) {
+        typo_buffer[0]   = KC_SPC;
+        typo_buffer_size = 1;
+        return true;
+    } else {
+        typo_buffer_size = 0;
+        return false;
     }
-    return true;
 }
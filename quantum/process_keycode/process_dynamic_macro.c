@@ -18,10 +18,19 @@
 /* Author: Wojciech Siewierski < wojciech dot siewierski at onet dot pl > */
 #include "process_dynamic_macro.h"
 #include <stddef.h>
+#include <string.h>
 #include "action_layer.h"
 #include "keycodes.h"
 #include "debug.h"
 #include "wait.h"
+#include "timer.h"
+#include "util.h"
+#include "compiler_support.h"
+#include "deferred_exec.h"
+
+#ifdef DYNAMIC_MACRO_PERSISTENT
+#    include "nvm_dynamic_macro.h"
+#endif
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -86,205 +95,533 @@ __attribute__((weak)) bool dynamic_macro_valid_key_user(uint16_t keycode, keyrec
  * need a `direction` variable accessible at the call site.
  */
 #define DYNAMIC_MACRO_CURRENT_SLOT() (direction > 0 ? 1 : 2)
-#define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) ((int)(direction * ((POINTER) - (BEGIN))))
-#define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) ((int)(direction * ((END2) - (BEGIN)) + 1))
+#define DYNAMIC_MACRO_SLOT_INDEX(direction) ((direction) > 0 ? 0 : 1)
+#define DYNAMIC_MACRO_SLOT_DIRECTION(slot) ((slot) == 0 ? +1 : -1)
+
+/* Recorded events are delta-encoded into a byte stream. The first byte
+ * of each event holds the press bit and either a key index or a set of
+ * flags telling which extra bytes follow:
+ *
+ *   p0kkkkkk  short form: a plain matrix key event with a key index
+ *             (row * MATRIX_COLS + col) below 64, the whole event
+ *   p1dtrxxx  extended form, followed in order by
+ *               d: recorded delay, 1-2 bytes, 7 bits each, LSB first
+ *               t: tap state
+ *               r = 0: low byte of the key index, xxx is bits 8..10
+ *               r = 1: type, row and column bytes, then a big endian
+ *                      keycode if the lowest x bit is set
+ *
+ * A plain key tap therefore takes two bytes, instead of twice
+ * sizeof(keyrecord_t).
+ */
+#define DYNAMIC_MACRO_PRESSED 0x80
+#define DYNAMIC_MACRO_EXTENDED 0x40
+#define DYNAMIC_MACRO_SHORT_KEY_MASK 0x3F
+#define DYNAMIC_MACRO_HAS_DELAY 0x20
+#define DYNAMIC_MACRO_HAS_TAP 0x10
+#define DYNAMIC_MACRO_RAW 0x08
+#define DYNAMIC_MACRO_HAS_KEYCODE 0x01
+#define DYNAMIC_MACRO_HIGH_KEY_MASK 0x07
+#define DYNAMIC_MACRO_MAX_DELAY 0x3FFF
+#define DYNAMIC_MACRO_EVENT_MAX_SIZE 9
+
+STATIC_ASSERT(DYNAMIC_MACRO_BUFFER_SIZE <= UINT16_MAX, "DYNAMIC_MACRO_BUFFER_SIZE must be less than 65536");
+
+/* Both macros use the same buffer but read/write on different
+ * ends of it.
+ *
+ * Macro1 is written left-to-right starting from the beginning of
+ * the buffer.
+ *
+ * Macro2 is written right-to-left starting from the end of the
+ * buffer.
+ *
+ *  macro_buffer[0]                        macro_buffer[SIZE - 1]
+ *  v                                                            v
+ * +------------------------------------------------------------+
+ * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
+ * +------------------------------------------------------------+
+ *  \_ macro_length[0] _/      \_________ macro_length[1] ______/
+ *
+ * During the recording when one macro encounters the end of the
+ * other macro, the recording is stopped. Apart from this, there
+ * are no arbitrary limits for the macros' length in relation to
+ * each other: for example one can either have two medium sized
+ * macros or one long macro and one short macro. Or even one empty
+ * and one using the whole buffer.
+ */
+static uint8_t macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE];
+
+/* Number of bytes used by each macro. */
+static uint16_t macro_length[2] = {0};
+
+/* 0   - no macro is being recorded right now
+ * 1,2 - either macro 1 or 2 is being recorded */
+static uint8_t macro_id = 0;
+
+/* Length of the macro being recorded before its trailing run of
+ * key-down events, or UINT16_MAX if the last recorded event was a
+ * release. */
+static uint16_t macro_pressed_tail = UINT16_MAX;
+
+#ifdef DYNAMIC_MACRO_PRESERVE_TIMING
+static uint16_t macro_last_event_time = 0;
+#endif
 
 #ifdef DYNAMIC_MACRO_KEEP_ORIGINAL_LAYER_STATE
-static layer_state_t dm1_layer_state;
-static layer_state_t dm2_layer_state;
+static layer_state_t dm_layer_state[2];
+#endif
+
+/* The macros being played back, innermost last. A macro may play the
+ * other one, but never itself, so two frames are enough. */
+typedef struct {
+    int8_t        direction;
+    bool          waited;
+    uint16_t      position;
+    layer_state_t saved_layer_state;
+} dynamic_macro_playback_t;
+
+static dynamic_macro_playback_t playback_stack[2];
+static uint8_t                  playback_depth = 0;
+
+static deferred_executor_t playback_executor[1]  = {0};
+static deferred_token      playback_token        = INVALID_DEFERRED_TOKEN;
+static uint32_t            playback_last_checked = 0;
+
+static inline uint8_t *dynamic_macro_byte(uint8_t slot, uint16_t position) {
+    return slot == 0 ? &macro_buffer[position] : &macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE - 1 - position];
+}
+
+/**
+ * Encode a key event.
+ *
+ * @param[in]  record The event to encode.
+ * @param[in]  delay  Time since the previous event in the macro.
+ * @param[out] event  At least DYNAMIC_MACRO_EVENT_MAX_SIZE bytes.
+ * @return The number of bytes used.
+ */
+static uint8_t dynamic_macro_encode(keyrecord_t *record, uint16_t delay, uint8_t *event) {
+    uint8_t  size   = 1;
+    uint8_t  header = record->event.pressed ? DYNAMIC_MACRO_PRESSED : 0;
+    uint16_t index  = record->event.key.row * MATRIX_COLS + record->event.key.col;
+    bool     raw    = record->event.type != KEY_EVENT || record->event.key.row >= MATRIX_ROWS || record->event.key.col >= MATRIX_COLS || index > 0x7FF;
+    uint8_t  tap    = 0;
+
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+    raw = raw || record->keycode != KC_NO;
+#endif
+#ifndef NO_ACTION_TAPPING
+    tap = record->tap.count | (record->tap.interrupted ? 0x10 : 0) | (record->tap.speculated ? 0x20 : 0);
+#endif
+
+    if (!raw && tap == 0 && delay == 0 && index <= DYNAMIC_MACRO_SHORT_KEY_MASK) {
+        event[0] = header | index;
+        return 1;
+    }
+
+    header |= DYNAMIC_MACRO_EXTENDED;
+    if (delay > 0) {
+        delay = MIN(delay, DYNAMIC_MACRO_MAX_DELAY);
+        header |= DYNAMIC_MACRO_HAS_DELAY;
+        if (delay > 0x7F) {
+            event[size++] = (delay & 0x7F) | 0x80;
+            delay >>= 7;
+        }
+        event[size++] = delay;
+    }
+    if (tap != 0) {
+        header |= DYNAMIC_MACRO_HAS_TAP;
+        event[size++] = tap;
+    }
+    if (raw) {
+        header |= DYNAMIC_MACRO_RAW;
+        event[size++] = record->event.type;
+        event[size++] = record->event.key.row;
+        event[size++] = record->event.key.col;
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+        if (record->keycode != KC_NO) {
+            header |= DYNAMIC_MACRO_HAS_KEYCODE;
+            event[size++] = record->keycode >> 8;
+            event[size++] = record->keycode & 0xFF;
+        }
+#endif
+    } else {
+        header |= index >> 8;
+        event[size++] = index & 0xFF;
+    }
+    event[0] = header;
+    return size;
+}
+
+/**
+ * Decode the key event stored at the given macro position.
+ *
+ * @param[in]  slot     The macro to read from.
+ * @param[in]  position Offset of the event within the macro.
+ * @param[out] record   The decoded event, without a timestamp.
+ * @param[out] delay    Recorded time since the previous event.
+ * @return The offset of the following event.
+ */
+static uint16_t dynamic_macro_decode(uint8_t slot, uint16_t position, keyrecord_t *record, uint16_t *delay) {
+    uint8_t header = *dynamic_macro_byte(slot, position++);
+
+    memset(record, 0, sizeof(keyrecord_t));
+    record->event.pressed = header & DYNAMIC_MACRO_PRESSED;
+    record->event.type    = KEY_EVENT;
+    *delay                = 0;
+
+    uint16_t index = header & DYNAMIC_MACRO_SHORT_KEY_MASK;
+    if (header & DYNAMIC_MACRO_EXTENDED) {
+        if (header & DYNAMIC_MACRO_HAS_DELAY) {
+            uint8_t low = *dynamic_macro_byte(slot, position++);
+            *delay      = low & 0x7F;
+            if (low & 0x80) {
+                *delay |= *dynamic_macro_byte(slot, position++) << 7;
+            }
+        }
+        uint8_t tap = 0;
+        if (header & DYNAMIC_MACRO_HAS_TAP) {
+            tap = *dynamic_macro_byte(slot, position++);
+        }
+#ifndef NO_ACTION_TAPPING
+        record->tap.count       = tap & 0x0F;
+        record->tap.interrupted = tap & 0x10;
+        record->tap.speculated  = tap & 0x20;
+#else
+        (void)tap;
+#endif
+        if (header & DYNAMIC_MACRO_RAW) {
+            record->event.type    = *dynamic_macro_byte(slot, position++);
+            record->event.key.row = *dynamic_macro_byte(slot, position++);
+            record->event.key.col = *dynamic_macro_byte(slot, position++);
+            if (header & DYNAMIC_MACRO_HAS_KEYCODE) {
+                uint16_t keycode = *dynamic_macro_byte(slot, position++) << 8;
+                keycode |= *dynamic_macro_byte(slot, position++);
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+                record->keycode = keycode;
+#else
+                (void)keycode;
+#endif
+            }
+            return position;
+        }
+        index = (header & DYNAMIC_MACRO_HIGH_KEY_MASK) << 8 | *dynamic_macro_byte(slot, position++);
+    }
+    record->event.key.row = index / MATRIX_COLS;
+    record->event.key.col = index % MATRIX_COLS;
+    return position;
+}
+
+#ifdef DYNAMIC_MACRO_PERSISTENT
+/* Persisted layout: magic byte, both macro lengths (little endian),
+ * then the bytes of both macros in playback order. */
+#    define DYNAMIC_MACRO_NVM_MAGIC 0xD3
+#    define DYNAMIC_MACRO_NVM_HEADER_SIZE 5
+
+static bool macros_loaded = false;
+
+static void dynamic_macro_load(void) {
+    uint8_t header[DYNAMIC_MACRO_NVM_HEADER_SIZE];
+
+    macros_loaded = true;
+    if (nvm_dynamic_macro_read(header, 0, sizeof(header)) != sizeof(header) || header[0] != DYNAMIC_MACRO_NVM_MAGIC) {
+        return;
+    }
+
+    uint16_t length[2] = {header[1] | header[2] << 8, header[3] | header[4] << 8};
+    if ((uint32_t)length[0] + length[1] > MIN(DYNAMIC_MACRO_BUFFER_SIZE, nvm_dynamic_macro_size() - DYNAMIC_MACRO_NVM_HEADER_SIZE)) {
+        dprintln("dynamic macro: ignoring invalid persisted macros");
+        return;
+    }
+
+    uint32_t offset = DYNAMIC_MACRO_NVM_HEADER_SIZE;
+    nvm_dynamic_macro_read(macro_buffer, offset, length[0]);
+    offset += length[0];
+    /* Macro 2 is stored in playback order, the buffer holds it reversed. */
+    for (uint16_t i = 0; i < length[1]; i++) {
+        nvm_dynamic_macro_read(dynamic_macro_byte(1, i), offset + i, 1);
+    }
+
+    macro_length[0] = length[0];
+    macro_length[1] = length[1];
+    dprintf("dynamic macro: loaded persisted macros, lengths: %d, %d\n", length[0], length[1]);
+}
+
+static void dynamic_macro_save(void) {
+    uint32_t available = nvm_dynamic_macro_size();
+    if (available <= DYNAMIC_MACRO_NVM_HEADER_SIZE) {
+        return;
+    }
+    available -= DYNAMIC_MACRO_NVM_HEADER_SIZE;
+
+    /* Persist whichever macros fit, in slot order. */
+    uint16_t length[2];
+    for (uint8_t slot = 0; slot < 2; slot++) {
+        length[slot] = macro_length[slot] <= available ? macro_length[slot] : 0;
+        available -= length[slot];
+    }
+
+    uint32_t offset = DYNAMIC_MACRO_NVM_HEADER_SIZE;
+    nvm_dynamic_macro_update(macro_buffer, offset, length[0]);
+    offset += length[0];
+    for (uint16_t i = 0; i < length[1]; i++) {
+        nvm_dynamic_macro_update(dynamic_macro_byte(1, i), offset + i, 1);
+    }
+
+    uint8_t header[DYNAMIC_MACRO_NVM_HEADER_SIZE] = {DYNAMIC_MACRO_NVM_MAGIC, length[0] & 0xFF, length[0] >> 8, length[1] & 0xFF, length[1] >> 8};
+    nvm_dynamic_macro_update(header, 0, sizeof(header));
+}
 #endif
 
 /**
  * Start recording of the dynamic macro.
  *
- * @param[out] macro_pointer The new macro buffer iterator.
- * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
+ * @param[in] direction Either +1 or -1, which macro to record.
  */
-void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_buffer, int8_t direction) {
+static void dynamic_macro_record_start(int8_t direction) {
     dprintln("dynamic macro recording: started");
 
     dynamic_macro_record_start_kb(direction);
 
 #ifdef DYNAMIC_MACRO_KEEP_ORIGINAL_LAYER_STATE
-    if (direction == 1) {
-        dm1_layer_state = layer_state;
-    } else if (direction == -1) {
-        dm2_layer_state = layer_state;
-    }
+    dm_layer_state[DYNAMIC_MACRO_SLOT_INDEX(direction)] = layer_state;
 #else
     layer_clear();
 #endif
     clear_keyboard();
-    *macro_pointer = macro_buffer;
+    macro_length[DYNAMIC_MACRO_SLOT_INDEX(direction)] = 0;
+    macro_pressed_tail                                = UINT16_MAX;
+}
+
+/**
+ * Time to wait before the next event of the innermost macro being
+ * played. The event is marked as waited for, so the next playback
+ * callback sends it straight away.
+ */
+static uint32_t dynamic_macro_playback_delay(void) {
+    dynamic_macro_playback_t *frame = &playback_stack[playback_depth - 1];
+    uint8_t                   slot  = DYNAMIC_MACRO_SLOT_INDEX(frame->direction);
+    uint16_t                  gap   = 0;
+
+    if (!frame->waited && frame->position < macro_length[slot]) {
+        keyrecord_t record;
+        uint16_t    delay;
+        dynamic_macro_decode(slot, frame->position, &record, &delay);
+        frame->waited = true;
+#ifdef DYNAMIC_MACRO_PRESERVE_TIMING
+        gap = delay;
+#endif
+#ifdef DYNAMIC_MACRO_DELAY
+        gap = MAX(gap, DYNAMIC_MACRO_DELAY);
+#endif
+    }
+
+    /* Even without any delay, send one event per millisecond so the
+     * rest of the keyboard keeps running during playback. */
+    return gap > 0 ? gap : 1;
 }
 
 /**
- * Play the dynamic macro.
+ * Finish playing the innermost macro.
+ */
+static void dynamic_macro_play_end(void) {
+    dynamic_macro_playback_t *frame = &playback_stack[--playback_depth];
+
+    clear_keyboard();
+
+    layer_state_set(frame->saved_layer_state);
+
+    dynamic_macro_play_kb(frame->direction);
+}
+
+static uint32_t dynamic_macro_playback_callback(uint32_t trigger_time, void *cb_arg) {
+    while (playback_depth > 0) {
+        dynamic_macro_playback_t *frame = &playback_stack[playback_depth - 1];
+        uint8_t                   slot  = DYNAMIC_MACRO_SLOT_INDEX(frame->direction);
+
+        if (frame->position >= macro_length[slot]) {
+            dynamic_macro_play_end();
+            continue;
+        }
+        if (!frame->waited) {
+            /* Resuming the outer macro after a nested one ended. */
+            return dynamic_macro_playback_delay();
+        }
+
+        keyrecord_t record;
+        uint16_t    delay;
+        frame->position   = dynamic_macro_decode(slot, frame->position, &record, &delay);
+        frame->waited     = false;
+        record.event.time = timer_read();
+        process_record(&record);
+
+        /* The event may have started a nested macro. */
+        return dynamic_macro_playback_delay();
+    }
+
+    playback_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+/**
+ * Play the dynamic macro. Events are sent from dynamic_macro_task(),
+ * this only queues the macro.
  *
- * @param macro_buffer[in] The beginning of the macro buffer being played.
- * @param macro_end[in]    The element after the last macro buffer element.
- * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ * @param direction[in] Either +1 or -1, which macro to play.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
+static void dynamic_macro_play(int8_t direction) {
+    for (uint8_t i = 0; i < playback_depth; i++) {
+        if (playback_stack[i].direction == direction) {
+            dprintln("dynamic macro: ignoring recursive macro playback");
+            return;
+        }
+    }
+
     dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
 
-    layer_state_t saved_layer_state = layer_state;
+    dynamic_macro_playback_t *frame = &playback_stack[playback_depth++];
+    frame->direction                = direction;
+    frame->waited                   = false;
+    frame->position                 = 0;
+    frame->saved_layer_state        = layer_state;
 
     clear_keyboard();
 #ifdef DYNAMIC_MACRO_KEEP_ORIGINAL_LAYER_STATE
-    if (direction == 1) {
-        layer_state_set(dm1_layer_state);
-    } else if (direction == -1) {
-        layer_state_set(dm2_layer_state);
-    }
+    layer_state_set(dm_layer_state[DYNAMIC_MACRO_SLOT_INDEX(direction)]);
 #else
     layer_clear();
 #endif
 
-    while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
-#ifdef DYNAMIC_MACRO_DELAY
-        wait_ms(DYNAMIC_MACRO_DELAY);
-#endif
+    if (playback_token == INVALID_DEFERRED_TOKEN) {
+        playback_last_checked = timer_read32();
+        playback_token        = defer_exec_advanced(playback_executor, ARRAY_SIZE(playback_executor), dynamic_macro_playback_delay(), dynamic_macro_playback_callback, NULL);
+        if (playback_token == INVALID_DEFERRED_TOKEN) {
+            dynamic_macro_play_end();
+        }
     }
-
-    clear_keyboard();
-
-    layer_state_set(saved_layer_state);
-
-    dynamic_macro_play_kb(direction);
 }
 
 /**
  * Record a single key in a dynamic macro.
  *
- * @param macro_buffer[in] The start of the used macro buffer.
- * @param macro_pointer[in,out] The current buffer position.
- * @param macro2_end[in] The end of the other macro.
- * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
+ * @param direction[in]  Either +1 or -1, which macro to record to.
  * @param record[in]     The current keypress.
  */
-void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_pointer, keyrecord_t *macro2_end, int8_t direction, keyrecord_t *record) {
+static void dynamic_macro_record_key(int8_t direction, keyrecord_t *record) {
+    uint8_t slot = DYNAMIC_MACRO_SLOT_INDEX(direction);
+
     /* If we've just started recording, ignore all the key releases. */
-    if (!record->event.pressed && *macro_pointer == macro_buffer) {
+    if (!record->event.pressed && macro_length[slot] == 0) {
         dprintln("dynamic macro: ignoring a leading key-up event");
         return;
     }
 
-    /* The other end of the other macro is the last buffer element it
-     * is safe to use before overwriting the other macro.
+    uint16_t delay = 0;
+#ifdef DYNAMIC_MACRO_PRESERVE_TIMING
+    if (macro_length[slot] != 0) {
+        delay = TIMER_DIFF_16(record->event.time, macro_last_event_time);
+    }
+    macro_last_event_time = record->event.time;
+#endif
+
+    uint8_t event[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    uint8_t size = dynamic_macro_encode(record, delay, event);
+
+    /* The bytes left between both macros are all that is safe to use
+     * before overwriting the other macro.
      */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    if (size <= DYNAMIC_MACRO_BUFFER_SIZE - macro_length[0] - macro_length[1]) {
+        if (!record->event.pressed) {
+            macro_pressed_tail = UINT16_MAX;
+        } else if (macro_pressed_tail == UINT16_MAX) {
+            macro_pressed_tail = macro_length[slot];
+        }
+        for (uint8_t i = 0; i < size; i++) {
+            *dynamic_macro_byte(slot, macro_length[slot]++) = event[i];
+        }
     }
     dynamic_macro_record_key_kb(direction, record);
 
-    dprintf("dynamic macro: slot %d length: %d/%d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, *macro_pointer), DYNAMIC_MACRO_CURRENT_CAPACITY(macro_buffer, macro2_end));
+    dprintf("dynamic macro: slot %d length: %d/%d bytes\n", DYNAMIC_MACRO_CURRENT_SLOT(), macro_length[slot], (int)(DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1 - slot]));
 }
 
 /**
- * End recording of the dynamic macro. Essentially just update the
- * pointer to the end of the macro.
+ * End recording of the dynamic macro.
  */
-void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_pointer, int8_t direction, keyrecord_t **macro_end) {
+static void dynamic_macro_record_end(int8_t direction) {
+    uint8_t slot = DYNAMIC_MACRO_SLOT_INDEX(direction);
+
     dynamic_macro_record_end_kb(direction);
 
     /* Do not save the keys being held when stopping the recording,
      * i.e. the keys used to access the layer DM_RSTP is on.
      */
-    while (macro_pointer != macro_buffer && (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
+    if (macro_pressed_tail != UINT16_MAX) {
+        dprintln("dynamic macro: trimming trailing key-down events");
+        macro_length[slot] = macro_pressed_tail;
     }
 
-    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
+    dprintf("dynamic macro: slot %d saved, length: %d bytes\n", DYNAMIC_MACRO_CURRENT_SLOT(), macro_length[slot]);
 
-    *macro_end = macro_pointer;
+#ifdef DYNAMIC_MACRO_PERSISTENT
+    dynamic_macro_save();
+#endif
 }
 
-/* Both macros use the same buffer but read/write on different
- * ends of it.
- *
- * Macro1 is written left-to-right starting from the beginning of
- * the buffer.
- *
- * Macro2 is written right-to-left starting from the end of the
- * buffer.
- *
- * &macro_buffer   macro_end
- *  v                   v
- * +------------------------------------------------------------+
- * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
- * +------------------------------------------------------------+
- *                           ^                                 ^
- *                         r_macro_end                  r_macro_buffer
- *
- * During the recording when one macro encounters the end of the
- * other macro, the recording is stopped. Apart from this, there
- * are no arbitrary limits for the macros' length in relation to
- * each other: for example one can either have two medium sized
- * macros or one long macro and one short macro. Or even one empty
- * and one using the whole buffer.
- */
-static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
-
-/* Pointer to the first buffer element after the first macro.
- * Initially points to the very beginning of the buffer since the
- * macro is empty. */
-static keyrecord_t *macro_end = macro_buffer;
-
-/* The other end of the macro buffer. Serves as the beginning of
- * the second macro. */
-static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
-
-/* Like macro_end but for the second macro. */
-static keyrecord_t *r_macro_end = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
-
-/* A persistent pointer to the current macro position (iterator)
- * used during the recording. */
-static keyrecord_t *macro_pointer = NULL;
-
-/* 0   - no macro is being recorded right now
- * 1,2 - either macro 1 or 2 is being recorded */
-static uint8_t macro_id = 0;
-
 /**
  * If a dynamic macro is currently being recorded, stop recording.
  */
 void dynamic_macro_stop_recording(void) {
-    switch (macro_id) {
-        case 1:
-            dynamic_macro_record_end(macro_buffer, macro_pointer, +1, &macro_end);
-            break;
-        case 2:
-            dynamic_macro_record_end(r_macro_buffer, macro_pointer, -1, &r_macro_end);
-            break;
+    if (macro_id != 0) {
+        dynamic_macro_record_end(DYNAMIC_MACRO_SLOT_DIRECTION(macro_id - 1));
     }
     macro_id = 0;
 }
 
+/**
+ * Whether a dynamic macro is being played back right now.
+ */
+bool dynamic_macro_is_playing(void) {
+    return playback_depth > 0;
+}
+
+/**
+ * Send the events of the macro being played back, as they come due.
+ */
+void dynamic_macro_task(void) {
+    if (playback_token == INVALID_DEFERRED_TOKEN) {
+        return;
+    }
+    deferred_exec_advanced_task(playback_executor, ARRAY_SIZE(playback_executor), &playback_last_checked);
+}
+
 /* Handle the key events related to the dynamic macros.
  */
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
+#ifdef DYNAMIC_MACRO_PERSISTENT
+    if (!macros_loaded) {
+        dynamic_macro_load();
+    }
+#endif
+
     if (macro_id == 0) {
         /* No macro recording in progress. */
         if (!record->event.pressed) {
             switch (keycode) {
                 case QK_DYNAMIC_MACRO_RECORD_START_1:
-                    dynamic_macro_record_start(&macro_pointer, macro_buffer, +1);
-                    macro_id = 1;
-                    return false;
                 case QK_DYNAMIC_MACRO_RECORD_START_2:
-                    dynamic_macro_record_start(&macro_pointer, r_macro_buffer, -1);
-                    macro_id = 2;
+                    if (dynamic_macro_is_playing()) {
+                        dprintln("dynamic macro: ignoring recording start during playback");
+                        return false;
+                    }
+                    macro_id = keycode == QK_DYNAMIC_MACRO_RECORD_START_1 ? 1 : 2;
+                    dynamic_macro_record_start(DYNAMIC_MACRO_SLOT_DIRECTION(macro_id - 1));
                     return false;
                 case QK_DYNAMIC_MACRO_PLAY_1:
-                    dynamic_macro_play(macro_buffer, macro_end, +1);
+                    dynamic_macro_play(+1);
                     return false;
                 case QK_DYNAMIC_MACRO_PLAY_2:
-                    dynamic_macro_play(r_macro_buffer, r_macro_end, -1);
+                    dynamic_macro_play(-1);
                     return false;
             }
         }
@@ -310,14 +647,7 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
             default:
                 if (dynamic_macro_valid_key_kb(keycode, record)) {
                     /* Store the key in the macro buffer and process it normally. */
-                    switch (macro_id) {
-                        case 1:
-                            dynamic_macro_record_key(macro_buffer, &macro_pointer, r_macro_end, +1, record);
-                            break;
-                        case 2:
-                            dynamic_macro_record_key(r_macro_buffer, &macro_pointer, macro_end, -1, record);
-                            break;
-                    }
+                    dynamic_macro_record_key(DYNAMIC_MACRO_SLOT_DIRECTION(macro_id - 1), record);
                 }
                 return true;
                 break;
@@ -22,10 +22,15 @@
 #include <stdbool.h>
 #include "action.h"
 
-/* May be overridden with a custom value. Be aware that the effective
- * macro length is half of this value: each keypress is recorded twice
- * because of the down-event and up-event. This is not a bug, it's the
- * intended behavior.
+/* May be overridden with a custom value. Be aware that each keypress is
+ * recorded twice because of the down-event and up-event. This is not a
+ * bug, it's the intended behavior.
+ *
+ * The value is expressed in recorded events of the original, uncompressed
+ * format and only sets the RAM footprint of the buffer. Events are stored
+ * delta-encoded, using a single byte for a plain key event, so the actual
+ * capacity is several times larger. DYNAMIC_MACRO_BUFFER_SIZE may be
+ * defined instead to size the buffer in bytes directly.
  *
  * Usually it should be fine to set the macro size to at least 256 but
  * there have been reports of it being too much in some users' cases,
@@ -35,6 +40,10 @@
 #    define DYNAMIC_MACRO_SIZE 128
 #endif
 
+#ifndef DYNAMIC_MACRO_BUFFER_SIZE
+#    define DYNAMIC_MACRO_BUFFER_SIZE (DYNAMIC_MACRO_SIZE * sizeof(keyrecord_t))
+#endif
+
 void dynamic_macro_led_blink(void);
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record);
 bool dynamic_macro_record_start_kb(int8_t direction);
@@ -48,3 +57,5 @@ bool dynamic_macro_record_end_user(int8_t direction);
 bool dynamic_macro_valid_key_kb(uint16_t keycode, keyrecord_t *record);
 bool dynamic_macro_valid_key_user(uint16_t keycode, keyrecord_t *record);
 void dynamic_macro_stop_recording(void);
+bool dynamic_macro_is_playing(void);
+void dynamic_macro_task(void);
@@ -24,6 +24,7 @@
 #include "quantum.h"
 #include "quantum_keycodes.h"
 #include "keymap_introspection.h"
+#include "deferred_exec.h"
 
 #ifndef KEY_OVERRIDE_REPEAT_DELAY
 #    define KEY_OVERRIDE_REPEAT_DELAY 500
@@ -74,14 +75,20 @@ static uint16_t last_key_down = 0;
 // When was the last key pressed down?
 static uint32_t last_key_down_time = 0;
 
-// What timestamp are we comparing to when waiting to register a deferred key?
-static uint32_t defer_reference_time = 0;
-// What delay should pass until deferred key is registered?
-static uint32_t defer_delay = 0;
-
 // Holds the keycode that should be registered at a later time, in order to not get false key presses
 static uint16_t deferred_register = 0;
 
+// Executor for the deferred register, run from key_override_task()
+static deferred_executor_t deferred_register_executor[1]  = {0};
+static deferred_token      deferred_register_token        = INVALID_DEFERRED_TOKEN;
+static uint32_t            deferred_register_last_checked = 0;
+
+// Lookup index over the key overrides: positions in the override list, sorted by trigger keycode, then by whether any trigger modifiers are required, then by position. Each (trigger, requires mods) bucket is therefore in activation order.
+static uint8_t *index_order        = NULL;
+static uint16_t index_count        = 0;
+static uint16_t index_source_count = 0;
+static bool     index_valid        = false;
+
 // TODO: in future maybe save in EEPROM?
 static bool enabled = true;
 
@@ -145,17 +152,35 @@ static bool key_override_matches_active_modifiers(const key_override_t *override
     return false;
 }
 
+static uint32_t deferred_register_callback(uint32_t trigger_time, void *cb_arg) {
+    key_override_printf("Registering deferred key\n");
+    register_code16(deferred_register);
+    deferred_register       = 0;
+    deferred_register_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+static void cancel_deferred_register(void) {
+    if (deferred_register_token != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec_advanced(deferred_register_executor, ARRAY_SIZE(deferred_register_executor), deferred_register_token);
+        deferred_register_token = INVALID_DEFERRED_TOKEN;
+    }
+    deferred_register = 0;
+}
+
 static void schedule_deferred_register(const uint16_t keycode) {
-    if (timer_elapsed32(last_key_down_time) < KEY_OVERRIDE_REPEAT_DELAY) {
+    uint32_t       delay   = 50; // 50ms
+    const uint32_t elapsed = timer_elapsed32(last_key_down_time);
+
+    if (elapsed < KEY_OVERRIDE_REPEAT_DELAY) {
         // Defer until KEY_OVERRIDE_REPEAT_DELAY has passed since the trigger key was pressed down. This emulates the behavior as holding down a key x, then holding down shift shortly after. Usually the shifted key X is not immediately produced, but rather a 'key repeat delay' passes before any repeated character is output.
-        defer_reference_time = last_key_down_time;
-        defer_delay          = KEY_OVERRIDE_REPEAT_DELAY;
-    } else {
-        // Wait a very short time when a modifier event triggers the override to avoid false activations when e.g. a modifier is pressed just before a key is released (with the intention of pairing the modifier with a different key), or a modifier is lifted shortly before the trigger key is lifted. Operating systems by default reject modifier-events that happen very close to a non-modifier event.
-        defer_reference_time = timer_read32();
-        defer_delay          = 50; // 50ms
+        delay = KEY_OVERRIDE_REPEAT_DELAY - elapsed;
     }
-    deferred_register = keycode;
+    // Otherwise wait a very short time when a modifier event triggers the override to avoid false activations when e.g. a modifier is pressed just before a key is released (with the intention of pairing the modifier with a different key), or a modifier is lifted shortly before the trigger key is lifted. Operating systems by default reject modifier-events that happen very close to a non-modifier event.
+
+    cancel_deferred_register();
+    deferred_register       = keycode;
+    deferred_register_token = defer_exec_advanced(deferred_register_executor, ARRAY_SIZE(deferred_register_executor), delay, deferred_register_callback, NULL);
 }
 
 const key_override_t *clear_active_override(const bool allow_reregister) {
@@ -165,7 +190,7 @@ const key_override_t *clear_active_override(const bool allow_reregister) {
 
     key_override_printf("Deactivating override\n");
 
-    deferred_register = 0;
+    cancel_deferred_register();
 
     // Clear the suppressed mods
     clear_suppressed_override_mods();
@@ -244,169 +269,288 @@ static bool check_activation_event(const key_override_t *override, const bool ke
     }
 }
 
-/** Iterates through the list of key overrides and tries activating each, until it finds one that activates or reaches the end of overrides. Returns true if the key action for `keycode` should be sent */
-static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
-    if (key_override_count() == 0) {
-        return true;
+/** Tries activating a single key override. Returns true if it activated, in which case `send_key_action` is set to whether the key action for `keycode` should be sent */
+static bool try_activating_single_override(const key_override_t *const override, const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *send_key_action) {
+    // Fast, but not full mods check. Most key presses will not have any mods down, and most overrides will require mods. Hence here we filter overrides that require mods to be down while no mods are down
+    if (active_mods == 0 && override->trigger_mods != 0) {
+        key_override_printf("Not activating override: Modifiers don't match\n");
+        return false;
     }
 
-    for (uint8_t i = 0; i < key_override_count(); i++) {
-        const key_override_t *const override = key_override_get(i);
+    // Check layer
+    if ((override->layers & (1 << layer)) == 0) {
+        key_override_printf("Not activating override: Not set to activate on pressed layer\n");
+        return false;
+    }
 
-        // End of array
-        if (override == NULL) {
-            break;
-        }
+    // Check allowed activation events
+    if (!check_activation_event(override, key_down, is_mod)) {
+        key_override_printf("Not activating override: Activation event not allowed\n");
+        return false;
+    }
 
-        // Fast, but not full mods check. Most key presses will not have any mods down, and most overrides will require mods. Hence here we filter overrides that require mods to be down while no mods are down
-        if (active_mods == 0 && override->trigger_mods != 0) {
-            key_override_printf("Not activating override: Modifiers don't match\n");
-            continue;
-        }
+    const bool is_trigger = override->trigger == keycode;
 
-        // Check layer
-        if ((override->layers & (1 << layer)) == 0) {
-            key_override_printf("Not activating override: Not set to activate on pressed layer\n");
-            continue;
-        }
+    // Check if trigger lifted. This is a small optimization in order to skip the remaining checks
+    if (is_trigger && !key_down) {
+        key_override_printf("Not activating override: Trigger lifted\n");
+        return false;
+    }
 
-        // Check allowed activation events
-        if (!check_activation_event(override, key_down, is_mod)) {
-            key_override_printf("Not activating override: Activation event not allowed\n");
-            continue;
-        }
+    // If the trigger is KC_NO it means 'no key', so only the required modifiers need to be down.
+    const bool no_trigger = override->trigger == KC_NO;
 
-        const bool is_trigger = override->trigger == keycode;
+    // Check if aleady active
+    if (override == active_override) {
+        key_override_printf("Not activating override: Alerady actived\n");
+        return false;
+    }
 
-        // Check if trigger lifted. This is a small optimization in order to skip the remaining checks
-        if (is_trigger && !key_down) {
-            key_override_printf("Not activating override: Trigger lifted\n");
-            continue;
-        }
+    // Check if enabled
+    if (override->enabled != NULL && !((*(override->enabled) & 1))) {
+        key_override_printf("Not activating override: Not enabled\n");
+        return false;
+    }
+
+    // Check mods precisely
+    if (!key_override_matches_active_modifiers(override, active_mods)) {
+        key_override_printf("Not activating override: Modifiers don't match\n");
+        return false;
+    }
 
-        // If the trigger is KC_NO it means 'no key', so only the required modifiers need to be down.
-        const bool no_trigger = override->trigger == KC_NO;
+    // Check if trigger key is down.
+    const bool trigger_down = is_trigger && key_down;
 
-        // Check if aleady active
-        if (override == active_override) {
-            key_override_printf("Not activating override: Alerady actived\n");
-            continue;
+    // At this point, all requirements for activation are checked, except whether the trigger key is pressed. Now we check if the required trigger is down
+    // If no trigger key is required, yes.
+    // If the trigger was just pressed, yes.
+    // If the last non-mod key that was pressed down is the trigger key, yes.
+    bool should_activate = no_trigger || trigger_down || last_key_down == override->trigger;
+
+    if (!should_activate) {
+        key_override_printf("Not activating override. Trigger not down\n");
+        return false;
+    }
+
+    key_override_printf("Activating override\n");
+
+    clear_active_override(false);
+
+#ifdef DUMMY_MOD_NEUTRALIZER_KEYCODE
+    // Send a dummy keycode before unregistering the modifier(s)
+    // so that suppressing the modifier(s) doesn't falsely get interpreted
+    // by the host OS as a tap of a modifier key.
+    // For example, unintended activations of the start menu on Windows when
+    // using a GUI+<kc> key override with suppressed mods.
+    neutralize_flashing_modifiers(active_mods);
+#endif
+
+    active_override                 = override;
+    active_override_trigger_is_down = true;
+
+    set_suppressed_override_mods(override->suppressed_mods);
+
+    if (!trigger_down && !no_trigger) {
+        // When activating a key override the trigger is is always unregistered. In the case where the key that newly pressed is not the trigger key, we have to explicitly remove the trigger key from the keyboard report. If the trigger was just pressed down we simply suppress the event which also has the effect of the trigger key not being registered in the keyboard report.
+        if (IS_BASIC_KEYCODE(override->trigger)) {
+            del_key(override->trigger);
+        } else {
+            unregister_code(override->trigger);
         }
+    }
 
-        // Check if enabled
-        if (override->enabled != NULL && !((*(override->enabled) & 1))) {
-            key_override_printf("Not activating override: Not enabled\n");
-            continue;
+    const uint16_t mod_free_replacement = clear_mods_from(override->replacement);
+
+    bool register_replacement = mod_free_replacement != KC_NO &&   // KC_NO is never registered
+                                mod_free_replacement < SAFE_RANGE; // Custom keycodes are never registered
+
+    // Try firing the custom handler
+    if (override->custom_action != NULL) {
+        register_replacement &= override->custom_action(true, override->context);
+    }
+
+    if (register_replacement) {
+        const uint8_t override_mods = extract_mod_bits(override->replacement);
+        set_weak_override_mods(override_mods);
+
+        // If this is a modifier event that activates the key override we _always_ defer the actual full activation of the override
+        if (is_mod) {
+            key_override_printf("Deferring register replacement key\n");
+            schedule_deferred_register(mod_free_replacement);
+            send_keyboard_report();
+        } else {
+            if (IS_BASIC_KEYCODE(mod_free_replacement)) {
+                add_key(mod_free_replacement);
+            } else {
+                key_override_printf("NOT KEY 2\n");
+                send_keyboard_report();
+                // On macOS there seems to be a race condition when it comes to the keyboard report and consumer keycodes. It seems the OS may recognize a consumer keycode before an updated keyboard report, even if the keyboard report is actually sent before the consumer key. I assume it is some sort of race condition because it happens infrequently and very irregularly. Waiting for about at least 10ms between sending the keyboard report and sending the consumer code has shown to fix this.
+                wait_ms(10);
+                register_code(mod_free_replacement);
+            }
         }
+    } else {
+        // If not registering the replacement key send keyboard report to update the unregistered keys.
+        send_keyboard_report();
+    }
 
-        // Check mods precisely
-        if (!key_override_matches_active_modifiers(override, active_mods)) {
-            key_override_printf("Not activating override: Modifiers don't match\n");
-            continue;
+
+    // If the trigger is down, suppress the event so that it does not get added to the keyboard report.
+    *send_key_action = !trigger_down;
+
+    return true;
+}
+
+static uint32_t index_sort_key(const uint8_t position) {
+    const key_override_t *const override = key_override_get(position);
+    return ((uint32_t)override->trigger << 1) | (override->trigger_mods != 0);
+}
+
+/** Builds the lookup index. Leaves `index_order` NULL if the overrides do not fit the index, in which case lookups scan the whole list */
+static void build_index(void) {
+    const uint16_t count = key_override_count();
+
+    index_valid        = true;
+    index_source_count = count;
+    index_order        = NULL;
+    index_count        = 0;
+
+    if (count > key_override_count_raw() || count > UINT8_MAX) {
+        return;
+    }
+
+    index_order = key_override_index_storage_raw();
+
+    // Insertion sort keeps equal keys in list order, which is the order overrides are tried in
+    for (uint16_t i = 0; i < count; i++) {
+        if (key_override_get(i) == NULL) {
+            break;
         }
 
-        // Check if trigger key is down.
-        const bool trigger_down = is_trigger && key_down;
+        const uint32_t key = index_sort_key(i);
+        uint16_t       j   = index_count;
+        while (j > 0 && index_sort_key(index_order[j - 1]) > key) {
+            index_order[j] = index_order[j - 1];
+            j--;
+        }
+        index_order[j] = i;
+        index_count++;
+    }
+}
 
-        // At this point, all requirements for activation are checked, except whether the trigger key is pressed. Now we check if the required trigger is down
-        // If no trigger key is required, yes.
-        // If the trigger was just pressed, yes.
-        // If the last non-mod key that was pressed down is the trigger key, yes.
-        bool should_activate = no_trigger || trigger_down || last_key_down == override->trigger;
+void key_override_invalidate_index(void) {
+    index_valid = false;
+}
 
-        if (!should_activate) {
-            key_override_printf("Not activating override. Trigger not down\n");
-            continue;
+/** Returns the first position in the index whose sort key is not less than `key` */
+static uint16_t index_lower_bound(const uint32_t key) {
+    uint16_t lo = 0;
+    uint16_t hi = index_count;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (index_sort_key(index_order[mid]) < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
+    }
+    return lo;
+}
 
-        key_override_printf("Activating override\n");
+typedef struct {
+    uint16_t begin;
+    uint16_t end;
+} index_bucket_t;
 
-        clear_active_override(false);
+/** Iterates through the key overrides that could activate for this event and tries activating each, until it finds one that activates or runs out of candidates. Returns true if the key action for `keycode` should be sent */
+static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
+    bool send_key_action = true;
 
-#ifdef DUMMY_MOD_NEUTRALIZER_KEYCODE
-        // Send a dummy keycode before unregistering the modifier(s)
-        // so that suppressing the modifier(s) doesn't falsely get interpreted
-        // by the host OS as a tap of a modifier key.
-        // For example, unintended activations of the start menu on Windows when
-        // using a GUI+<kc> key override with suppressed mods.
-        neutralize_flashing_modifiers(active_mods);
-#endif
+    *activated = false;
+
+    if (key_override_count() == 0) {
+        return true;
+    }
 
-        active_override                 = override;
-        active_override_trigger_is_down = true;
+    if (!index_valid || index_source_count != key_override_count()) {
+        build_index();
+    }
 
-        set_suppressed_override_mods(override->suppressed_mods);
+    if (index_order == NULL) {
+        // Overrides don't fit the index, try them all in list order
+        for (uint8_t i = 0; i < key_override_count(); i++) {
+            const key_override_t *const override = key_override_get(i);
 
-        if (!trigger_down && !no_trigger) {
-            // When activating a key override the trigger is is always unregistered. In the case where the key that newly pressed is not the trigger key, we have to explicitly remove the trigger key from the keyboard report. If the trigger was just pressed down we simply suppress the event which also has the effect of the trigger key not being registered in the keyboard report.
-            if (IS_BASIC_KEYCODE(override->trigger)) {
-                del_key(override->trigger);
-            } else {
-                unregister_code(override->trigger);
+            // End of array
+            if (override == NULL) {
+                break;
+            }
+
+            if (try_activating_single_override(override, keycode, layer, key_down, is_mod, active_mods, &send_key_action)) {
+                *activated = true;
+                return send_key_action;
             }
         }
 
-        const uint16_t mod_free_replacement = clear_mods_from(override->replacement);
+        return true;
+    }
 
-        bool register_replacement = mod_free_replacement != KC_NO &&   // KC_NO is never registered
-                                    mod_free_replacement < SAFE_RANGE; // Custom keycodes are never registered
+    // An override can only activate if it has no trigger, its trigger was just pressed, or its trigger is the last non-mod key that was pressed down. Each such trigger contributes one bucket of overrides requiring no modifiers and, if any modifiers are down, one bucket of overrides requiring modifiers.
+    const uint16_t triggers[]   = {KC_NO, last_key_down, key_down ? keycode : KC_NO};
+    index_bucket_t buckets[6]   = {0};
+    uint8_t        bucket_count = 0;
+    const uint8_t  mod_variants = active_mods == 0 ? 1 : 2;
 
-        // Try firing the custom handler
-        if (override->custom_action != NULL) {
-            register_replacement &= override->custom_action(true, override->context);
+    for (uint8_t t = 0; t < ARRAY_SIZE(triggers); t++) {
+        bool duplicate = false;
+        for (uint8_t u = 0; u < t; u++) {
+            duplicate |= triggers[u] == triggers[t];
+        }
+        if (duplicate) {
+            continue;
         }
 
-        if (register_replacement) {
-            const uint8_t override_mods = extract_mod_bits(override->replacement);
-            set_weak_override_mods(override_mods);
+        for (uint8_t requires_mods = 0; requires_mods < mod_variants; requires_mods++) {
+            const uint32_t key    = ((uint32_t)triggers[t] << 1) | requires_mods;
+            index_bucket_t bucket = {.begin = index_lower_bound(key), .end = index_lower_bound(key + 1)};
+            if (bucket.begin != bucket.end) {
+                buckets[bucket_count++] = bucket;
+            }
+        }
+    }
 
-            // If this is a modifier event that activates the key override we _always_ defer the actual full activation of the override
-            if (is_mod) {
-                key_override_printf("Deferring register replacement key\n");
-                schedule_deferred_register(mod_free_replacement);
-                send_keyboard_report();
-            } else {
-                if (IS_BASIC_KEYCODE(mod_free_replacement)) {
-                    add_key(mod_free_replacement);
-                } else {
-                    key_override_printf("NOT KEY 2\n");
-                    send_keyboard_report();
-                    // On macOS there seems to be a race condition when it comes to the keyboard report and consumer keycodes. It seems the OS may recognize a consumer keycode before an updated keyboard report, even if the keyboard report is actually sent before the consumer key. I assume it is some sort of race condition because it happens infrequently and very irregularly. Waiting for about at least 10ms between sending the keyboard report and sending the consumer code has shown to fix this.
-                    wait_ms(10);
-                    register_code(mod_free_replacement);
-                }
+    // Merge the buckets so candidates are still tried in list order
+    while (true) {
+        index_bucket_t *next = NULL;
+        for (uint8_t b = 0; b < bucket_count; b++) {
+            if (buckets[b].begin != buckets[b].end && (next == NULL || index_order[buckets[b].begin] < index_order[next->begin])) {
+                next = &buckets[b];
             }
-        } else {
-            // If not registering the replacement key send keyboard report to update the unregistered keys.
-            send_keyboard_report();
+        }
+        if (next == NULL) {
+            break;
         }
 
-        *activated = true;
+        const key_override_t *const override = key_override_get(index_order[next->begin++]);
 
-        // If the trigger is down, suppress the event so that it does not get added to the keyboard report.
-        return !trigger_down;
+        if (try_activating_single_override(override, keycode, layer, key_down, is_mod, active_mods, &send_key_action)) {
+            *activated = true;
+            return send_key_action;
+        }
     }
 
-    *activated = false;
-
     return true;
 }
 
 void key_override_task(void) {
-    if (deferred_register == 0) {
+    if (deferred_register_token == INVALID_DEFERRED_TOKEN) {
         return;
     }
 
-    if (timer_elapsed32(defer_reference_time) >= defer_delay) {
-        key_override_printf("Registering deferred key\n");
-        register_code16(deferred_register);
-        deferred_register    = 0;
-        defer_reference_time = 0;
-        defer_delay          = 0;
-    }
+    deferred_exec_advanced_task(deferred_register_executor, ARRAY_SIZE(deferred_register_executor), &deferred_register_last_checked);
 }
 
-bool process_key_override(const uint16_t keycode, const keyrecord_t *const record) {
+bool process_key_override(const uint16_t keycode, keyrecord_t *const record) {
 #ifdef BENCH_KEY_OVERRIDE
     uint16_t start = timer_read();
 #endif
@@ -459,7 +603,7 @@ bool process_key_override(const uint16_t keycode, const keyrecord_t *const recor
         if (key_down) {
             last_key_down      = keycode;
             last_key_down_time = timer_read32();
-            deferred_register  = 0;
+            cancel_deferred_register();
         }
 
         // The last key that was pressed was just released. No more keys are therefore sending input
@@ -467,7 +611,7 @@ bool process_key_override(const uint16_t keycode, const keyrecord_t *const recor
             last_key_down      = 0;
             last_key_down_time = 0;
             // We also cancel any deferred registers because, again, no keys are sending any input. Only the last key that is pressed creates an input – this key was just lifted.
-            deferred_register = 0;
+            cancel_deferred_register();
         }
     }
 
@@ -100,11 +100,14 @@ void key_override_toggle(void);
 bool key_override_is_enabled(void);
 
 /** Handling of key overrides and its implemented keycodes */
-bool process_key_override(const uint16_t keycode, const keyrecord_t *const record);
+bool process_key_override(const uint16_t keycode, keyrecord_t *const record);
 
 /** Perform any deferred keys */
 void key_override_task(void);
 
+/** Rebuilds the trigger lookup index on the next key event. Call this after changing the triggers or trigger mods returned by a custom key_override_get() */
+void key_override_invalidate_index(void);
+
 /**
  *  Preferrably use these macros to create key overrides. They fix many of the options to a standard setting that should satisfy most basic use-cases. Only directly create a key_override_t struct when you really need to.
  */
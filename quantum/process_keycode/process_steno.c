@@ -16,11 +16,25 @@
 #include "process_steno.h"
 #include "quantum_keycodes.h"
 #include "eeconfig.h"
+#include "timer.h"
+#include "debug.h"
 #include <string.h>
 #ifdef VIRTSER_ENABLE
 #    include "virtser.h"
 #endif
 
+#ifndef STENO_QUEUE_SIZE
+#    define STENO_QUEUE_SIZE 8
+#endif
+
+#ifndef STENO_REPEAT_DELAY
+#    define STENO_REPEAT_DELAY 300
+#endif
+
+#ifndef STENO_REPEAT_INTERVAL
+#    define STENO_REPEAT_INTERVAL 100
+#endif
+
 // All steno keys that have been pressed to form this chord,
 // stored in MAX_STROKE_SIZE groups of 8-bit arrays.
 static uint8_t chord[MAX_STROKE_SIZE] = {0};
@@ -31,6 +45,19 @@ static uint8_t chord[MAX_STROKE_SIZE] = {0};
 // At the end of this scenario given as an example, `chord` would have five bits set to 1 but
 // `n_pressed_keys` would be set to 2 because there are only two keys currently being pressed down.
 static int8_t n_pressed_keys = 0;
+// Whether `chord` was already sent while keys are still held, by the first-up
+// or the repeat mode, so that releasing the remaining keys does not send it again.
+static bool chord_sent = false;
+
+#ifdef STENO_FIRST_UP
+// The steno keys being held down, one bit per key
+static uint8_t held_keys[(STN__MAX - STN__MIN) / 8 + 1] = {0};
+#endif
+
+#ifdef STENO_REPEAT
+static uint16_t repeat_timer;
+static bool     repeating = false;
+#endif
 
 #ifdef STENO_ENABLE_ALL
 static steno_mode_t mode;
@@ -44,15 +71,135 @@ static inline void steno_clear_chord(void) {
     memset(chord, 0, sizeof(chord));
 }
 
+#ifdef VIRTSER_ENABLE
+// Packets waiting for room in the serial endpoint, so that a fast writer never
+// blocks the main loop. Sized for a TX Bolt packet and its trailing null byte.
+typedef struct {
+    uint8_t  length;
+    uint8_t  packet[MAX_STROKE_SIZE > BOLT_STROKE_SIZE ? MAX_STROKE_SIZE : BOLT_STROKE_SIZE + 1];
+    uint16_t time;
+} steno_stroke_t;
+
+static steno_stroke_t stroke_queue[STENO_QUEUE_SIZE];
+static uint8_t        stroke_head  = 0;
+static uint8_t        stroke_count = 0;
+
+#    ifdef STENO_STATS_ENABLE
+static uint32_t stats_queued        = 0;
+static uint32_t stats_sent          = 0;
+static uint32_t stats_dropped       = 0;
+static uint32_t stats_latency_total = 0;
+static uint16_t stats_latency_max   = 0;
+#    endif
+
+/**
+ * @brief Returns the next free entry of the queue, or NULL if it is full or
+ * nobody is listening on the serial port.
+ */
+static steno_stroke_t *steno_queue_next(void) {
+    // A stroke kept until the port is opened would be typed out of context
+    if (!virtser_is_open()) {
+        dprintln("steno: serial port closed, stroke dropped");
+#    ifdef STENO_STATS_ENABLE
+        stats_dropped++;
+#    endif
+        return NULL;
+    }
+    if (stroke_count == STENO_QUEUE_SIZE) {
+        dprintln("steno: queue full, stroke dropped");
+#    ifdef STENO_STATS_ENABLE
+        stats_dropped++;
+#    endif
+        return NULL;
+    }
+    steno_stroke_t *stroke = &stroke_queue[(stroke_head + stroke_count) % STENO_QUEUE_SIZE];
+    stroke->length         = 0;
+    return stroke;
+}
+
+static void steno_queue_push(steno_stroke_t *stroke) {
+    stroke->time = timer_read();
+    stroke_count++;
+#    ifdef STENO_STATS_ENABLE
+    stats_queued++;
+#    endif
+}
+
+/**
+ * @brief Write the queued strokes that fit into the serial endpoint, called by `virtser_task()`.
+ */
+void virtser_send_pending(void) {
+    if (!virtser_is_open()) {
+#    ifdef STENO_STATS_ENABLE
+        stats_dropped += stroke_count;
+#    endif
+        stroke_count = 0;
+        return;
+    }
+    while (stroke_count > 0) {
+        steno_stroke_t *stroke = &stroke_queue[stroke_head];
+        if (!virtser_send_ready(stroke->length)) {
+            return;
+        }
+        virtser_send_buffer(stroke->packet, stroke->length);
+#    ifdef STENO_STATS_ENABLE
+        uint16_t latency = timer_elapsed(stroke->time);
+        stats_sent++;
+        stats_latency_total += latency;
+        if (latency > stats_latency_max) {
+            stats_latency_max = latency;
+        }
+#    endif
+        stroke_head = (stroke_head + 1) % STENO_QUEUE_SIZE;
+        stroke_count--;
+    }
+}
+
+uint8_t steno_queue_count(void) {
+    return stroke_count;
+}
+
+#    ifdef STENO_STATS_ENABLE
+uint32_t steno_stats_queued(void) {
+    return stats_queued;
+}
+
+uint32_t steno_stats_dropped(void) {
+    return stats_dropped;
+}
+
+uint16_t steno_stats_max_latency(void) {
+    return stats_latency_max;
+}
+
+uint16_t steno_stats_average_latency(void) {
+    return stats_sent ? stats_latency_total / stats_sent : 0;
+}
+
+void steno_stats_clear(void) {
+    stats_queued        = 0;
+    stats_sent          = 0;
+    stats_dropped       = 0;
+    stats_latency_total = 0;
+    stats_latency_max   = 0;
+}
+#    endif // STENO_STATS_ENABLE
+#endif     // VIRTSER_ENABLE
+
 #ifdef STENO_ENABLE_GEMINI
 
 #    ifdef VIRTSER_ENABLE
 void send_steno_chord_gemini(void) {
-    // Set MSB to 1 to indicate the start of packet
-    chord[0] |= 0x80;
+    steno_stroke_t *stroke = steno_queue_next();
+    if (!stroke) {
+        return;
+    }
     for (uint8_t i = 0; i < GEMINI_STROKE_SIZE; ++i) {
-        virtser_send(chord[i]);
+        stroke->packet[stroke->length++] = chord[i];
     }
+    // Set MSB to 1 to indicate the start of packet
+    stroke->packet[0] |= 0x80;
+    steno_queue_push(stroke);
 }
 #    else
 #        pragma message "VIRTSER_ENABLE = yes is required for Gemini PR to work properly out of the box!"
@@ -90,18 +237,23 @@ static const uint8_t boltmap[64] PROGMEM = {TXB_NUL, TXB_NUM, TXB_NUM, TXB_NUM,
 
 #    ifdef VIRTSER_ENABLE
 static void send_steno_chord_bolt(void) {
+    steno_stroke_t *stroke = steno_queue_next();
+    if (!stroke) {
+        return;
+    }
     for (uint8_t i = 0; i < BOLT_STROKE_SIZE; ++i) {
         // TX Bolt uses variable length packets where each byte corresponds to a bit array of certain keys.
         // If a user chorded the keys of the first group with keys of the last group, for example, there
         // would be bytes of 0x00 in `chord` for the middle groups which we mustn't send.
         if (chord[i]) {
-            virtser_send(chord[i]);
+            stroke->packet[stroke->length++] = chord[i];
         }
     }
     // Sending a null packet is not always necessary, but it is simpler and more reliable
     // to unconditionally send it every time instead of keeping track of more states and
     // creating more branches in the execution of the program.
-    virtser_send(0);
+    stroke->packet[stroke->length++] = 0;
+    steno_queue_push(stroke);
 }
 #    else
 #        pragma message "VIRTSER_ENABLE = yes is required for TX Bolt to work properly out of the box!"
@@ -142,6 +294,71 @@ __attribute__((weak)) bool send_steno_chord_user(steno_mode_t mode, uint8_t chor
     return true;
 }
 
+static void add_key_to_chord(uint8_t key) {
+    switch (mode) {
+#ifdef STENO_ENABLE_BOLT
+        case STENO_MODE_BOLT:
+            add_bolt_key_to_chord(key);
+            break;
+#endif // STENO_ENABLE_BOLT
+#ifdef STENO_ENABLE_GEMINI
+        case STENO_MODE_GEMINI:
+            add_gemini_key_to_chord(key);
+            break;
+#endif // STENO_ENABLE_GEMINI
+        default:
+            break;
+    }
+}
+
+static void send_chord(void) {
+    if (!send_steno_chord_user(mode, chord)) {
+        return;
+    }
+    switch (mode) {
+#if defined(STENO_ENABLE_BOLT) && defined(VIRTSER_ENABLE)
+        case STENO_MODE_BOLT:
+            send_steno_chord_bolt();
+            break;
+#endif // STENO_ENABLE_BOLT && VIRTSER_ENABLE
+#if defined(STENO_ENABLE_GEMINI) && defined(VIRTSER_ENABLE)
+        case STENO_MODE_GEMINI:
+            send_steno_chord_gemini();
+            break;
+#endif // STENO_ENABLE_GEMINI && VIRTSER_ENABLE
+        default:
+            break;
+    }
+}
+
+#ifdef STENO_FIRST_UP
+/**
+ * @brief Start the next chord with the keys that are still held down, so that
+ * they can be rolled into the following stroke.
+ */
+static void steno_restart_chord(void) {
+    steno_clear_chord();
+    for (uint8_t key = 0; key <= STN__MAX - STN__MIN; key++) {
+        if (held_keys[key / 8] & (1 << (key % 8))) {
+            add_key_to_chord(key);
+        }
+    }
+}
+#endif // STENO_FIRST_UP
+
+void steno_task(void) {
+#ifdef STENO_REPEAT
+    if (n_pressed_keys <= 0 || timer_elapsed(repeat_timer) < (repeating ? STENO_REPEAT_INTERVAL : STENO_REPEAT_DELAY)) {
+        return;
+    }
+    // The chord has been held without changes, send it again
+    repeat_timer = timer_read();
+    repeating    = true;
+    chord_sent   = true;
+    send_chord();
+#endif // STENO_REPEAT
+}
+
 __attribute__((weak)) bool post_process_steno_user(uint16_t keycode, keyrecord_t *record, steno_mode_t mode, uint8_t chord[MAX_STROKE_SIZE], int8_t n_pressed_keys) {
     return true;
 }
@@ -192,49 +409,57 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
                 switch (mode) {
 #ifdef STENO_ENABLE_BOLT
                     case STENO_MODE_BOLT:
-                        add_bolt_key_to_chord(keycode - QK_STENO);
-                        break;
 #endif // STENO_ENABLE_BOLT
 #ifdef STENO_ENABLE_GEMINI
                     case STENO_MODE_GEMINI:
-                        add_gemini_key_to_chord(keycode - QK_STENO);
-                        break;
 #endif // STENO_ENABLE_GEMINI
+                        add_key_to_chord(keycode - QK_STENO);
+                        break;
                     default:
                         return false;
                 }
+#ifdef STENO_FIRST_UP
+                held_keys[(keycode - QK_STENO) / 8] |= 1 << ((keycode - QK_STENO) % 8);
+#endif
+#ifdef STENO_REPEAT
+                repeat_timer = timer_read();
+                repeating    = false;
+#endif
+                chord_sent = false;
                 if (!post_process_steno_user(keycode, record, mode, chord, n_pressed_keys)) {
                     return false;
                 }
             } else { // is released
                 n_pressed_keys--;
+#ifdef STENO_FIRST_UP
+                held_keys[(keycode - QK_STENO) / 8] &= ~(1 << ((keycode - QK_STENO) % 8));
+#endif
                 if (!post_process_steno_user(keycode, record, mode, chord, n_pressed_keys)) {
                     return false;
                 }
+#ifdef STENO_FIRST_UP
+                if (n_pressed_keys > 0) {
+                    // The first key to be released ends the stroke, the ones still held
+                    // start the next one
+                    if (!chord_sent) {
+                        send_chord();
+                        chord_sent = true;
+                    }
+                    steno_restart_chord();
+                    return false;
+                }
+#else
                 if (n_pressed_keys > 0) {
                     // User hasn't released all keys yet,
                     // so the chord cannot be sent
                     return false;
                 }
+#endif
                 n_pressed_keys = 0;
-                if (!send_steno_chord_user(mode, chord)) {
-                    steno_clear_chord();
-                    return false;
-                }
-                switch (mode) {
-#if defined(STENO_ENABLE_BOLT) && defined(VIRTSER_ENABLE)
-                    case STENO_MODE_BOLT:
-                        send_steno_chord_bolt();
-                        break;
-#endif // STENO_ENABLE_BOLT && VIRTSER_ENABLE
-#if defined(STENO_ENABLE_GEMINI) && defined(VIRTSER_ENABLE)
-                    case STENO_MODE_GEMINI:
-                        send_steno_chord_gemini();
-                        break;
-#endif // STENO_ENABLE_GEMINI && VIRTSER_ENABLE
-                    default:
-                        break;
+                if (!chord_sent) {
+                    send_chord();
                 }
+                chord_sent = false;
                 steno_clear_chord();
             }
             break;
@@ -36,6 +36,17 @@ typedef enum {
 } steno_mode_t;
 
 bool process_steno(uint16_t keycode, keyrecord_t *record);
+void steno_task(void);
+#ifdef VIRTSER_ENABLE
+uint8_t steno_queue_count(void);
+#    ifdef STENO_STATS_ENABLE
+uint32_t steno_stats_queued(void);
+uint32_t steno_stats_dropped(void);
+uint16_t steno_stats_max_latency(void);
+uint16_t steno_stats_average_latency(void);
+void     steno_stats_clear(void);
+#    endif // STENO_STATS_ENABLE
+#endif     // VIRTSER_ENABLE
 #ifdef STENO_ENABLE_ALL
 void steno_init(void);
 void steno_set_mode(steno_mode_t mode);
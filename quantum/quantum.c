@@ -295,160 +295,242 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
-/** \brief Core keycode function
+/** \brief Entry of the process_record_quantum() dispatch table
  *
- * Hands off handling to other quantum/process_keycode/ functions
+ * Each entry names a handler and the inclusive keycode range it acts upon.
+ * Handlers that observe every key (recording, state machines, user hooks)
+ * span the whole keycode space. A handler covering disjoint ranges is listed
+ * once per range, with its entries kept adjacent. Entries run in table order.
  */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record, true);
+typedef struct {
+    bool (*handler)(uint16_t keycode, keyrecord_t *record);
+    uint16_t first;
+    uint16_t last;
+} process_record_handler_t;
 
-    // This is how you use actions here
-    // if (keycode == QK_LEADER) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
+#define PROCESS_KEYCODE_RANGE(handler, first, last) {handler, first, last}
+#define PROCESS_ALL_KEYCODES(handler) PROCESS_KEYCODE_RANGE(handler, 0x0000, 0xFFFF)
 
-#if defined(SECURE_ENABLE)
-    if (!preprocess_secure(keycode, record)) {
-        return false;
-    }
-#endif
-
-#ifdef TAP_DANCE_ENABLE
-    if (preprocess_tap_dance(keycode, record)) {
-        // The tap dance might have updated the layer state, therefore the
-        // result of the keycode lookup might change.
-        keycode = get_record_keycode(record, true);
-    }
-#endif
-
-#ifdef RGBLIGHT_ENABLE
-    if (record->event.pressed) {
-        preprocess_rgblight();
-    }
-#endif
-
-#ifdef WPM_ENABLE
-    if (record->event.pressed) {
-        update_wpm(keycode);
-    }
-#endif
-
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
+static const process_record_handler_t process_record_handlers[] PROGMEM = {
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+    // Must run asap to ensure all keypresses are recorded.
+    PROCESS_ALL_KEYCODES(process_dynamic_macro),
 #endif
 #ifdef REPEAT_KEY_ENABLE
-            process_last_key(keycode, record) && process_repeat_key(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_last_key),
+    PROCESS_ALL_KEYCODES(process_repeat_key),
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_clicky),
 #endif
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_haptic),
 #endif
 #if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE)
-            process_auto_mouse(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_auto_mouse),
 #endif
-            process_record_modules(keycode, record) && // modules must run before kb
-            process_record_kb(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_record_modules), // modules must run before kb
+    PROCESS_ALL_KEYCODES(process_record_kb),
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_record_via, QK_MACRO, QK_MACRO_MAX),
 #endif
 #if defined(SECURE_ENABLE)
-            process_secure(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_secure),
 #endif
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_sequencer, QK_SEQUENCER, QK_SEQUENCER_MAX),
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_midi, QK_MIDI, QK_MIDI_MAX),
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_audio, QK_AUDIO, QK_AUDIO_MAX),
 #endif
 #if defined(BACKLIGHT_ENABLE)
-            process_backlight(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_backlight, QK_BACKLIGHT_ON, QK_BACKLIGHT_TOGGLE_BREATHING),
 #endif
 #if defined(LED_MATRIX_ENABLE)
-            process_led_matrix(keycode, record) &&
+    // Also claims the backlight keycodes.
+    PROCESS_KEYCODE_RANGE(process_led_matrix, QK_BACKLIGHT_ON, QK_LED_MATRIX_FLAG_PREVIOUS),
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_steno, QK_STENO, QK_STENO_MAX),
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_music),
 #endif
 #ifdef CAPS_WORD_ENABLE
-            process_caps_word(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_caps_word),
 #endif
 #ifdef KEY_OVERRIDE_ENABLE
-            process_key_override(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_key_override),
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_tap_dance),
 #endif
 #if defined(UNICODE_COMMON_ENABLE)
-            process_unicode_common(keycode, record) &&
+#    ifdef UCIS_ENABLE
+    // UCIS captures every key while a sequence is being entered.
+    PROCESS_ALL_KEYCODES(process_unicode_common),
+#    else
+    PROCESS_KEYCODE_RANGE(process_unicode_common, QK_UNICODE_MODE_NEXT, QK_UNICODE_MODE_EMACS),
+    PROCESS_KEYCODE_RANGE(process_unicode_common, QK_UNICODE, QK_UNICODE_MAX),
+#    endif
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_leader),
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_auto_shift),
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_dynamic_tapping_term, QK_DYNAMIC_TAPPING_TERM_PRINT, QK_DYNAMIC_TAPPING_TERM_DOWN),
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_space_cadet),
 #endif
 #ifdef MAGIC_ENABLE
-            process_magic(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_magic, QK_MAGIC, QK_MAGIC_MAX),
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_grave_esc, QK_GRAVE_ESCAPE, QK_GRAVE_ESCAPE),
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_underglow(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_underglow, QK_UNDERGLOW_TOGGLE, QK_UNDERGLOW_SPEED_DOWN),
+#    ifdef VELOCIKEY_ENABLE
+    PROCESS_KEYCODE_RANGE(process_underglow, QK_VELOCIKEY_TOGGLE, QK_VELOCIKEY_TOGGLE),
+#    endif
 #endif
 #if defined(RGB_MATRIX_ENABLE)
-            process_rgb_matrix(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_rgb_matrix, QK_RGB_MATRIX_ON, QK_RGB_MATRIX_FLAG_PREVIOUS),
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_joystick, QK_JOYSTICK, QK_JOYSTICK_MAX),
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_programmable_button, QK_PROGRAMMABLE_BUTTON, QK_PROGRAMMABLE_BUTTON_MAX),
 #endif
 #ifdef AUTOCORRECT_ENABLE
-            process_autocorrect(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_autocorrect),
 #endif
 #ifdef TRI_LAYER_ENABLE
-            process_tri_layer(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_tri_layer, QK_TRI_LAYER_LOWER, QK_TRI_LAYER_UPPER),
 #endif
 #if !defined(NO_ACTION_LAYER)
-            process_default_layer(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_default_layer, QK_PERSISTENT_DEF_LAYER, QK_PERSISTENT_DEF_LAYER_MAX),
 #endif
 #ifdef LAYER_LOCK_ENABLE
-            process_layer_lock(keycode, record) &&
+    PROCESS_ALL_KEYCODES(process_layer_lock),
 #endif
 #ifdef CONNECTION_ENABLE
-            process_connection(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_connection, QK_CONNECTION, QK_CONNECTION_MAX),
 #endif
 #ifndef NO_ACTION_ONESHOT
-            process_oneshot(keycode, record) &&
+    PROCESS_KEYCODE_RANGE(process_oneshot, QK_ONE_SHOT_ON, QK_ONE_SHOT_TOGGLE),
 #endif
-            process_quantum(keycode, record))) {
+    PROCESS_ALL_KEYCODES(process_quantum),
+};
+
+#ifdef PROCESS_RECORD_QUANTUM_STATS
+static process_record_quantum_stats_t process_record_stats;
+
+void process_record_quantum_get_stats(process_record_quantum_stats_t *stats) {
+    *stats = process_record_stats;
+
+    // Count the handlers a full walk of the chain would call for each event.
+    stats->chain_length = 0;
+#    if defined(KEY_LOCK_ENABLE)
+    stats->chain_length++;
+#    endif
+    void *previous = NULL;
+    for (uint8_t i = 0; i < ARRAY_SIZE(process_record_handlers); i++) {
+        void *handler = pgm_read_ptr(&process_record_handlers[i].handler);
+        if (handler != previous) {
+            stats->chain_length++;
+        }
+        previous = handler;
+    }
+}
+
+void process_record_quantum_reset_stats(void) {
+    process_record_stats = (process_record_quantum_stats_t){0};
+}
+#endif
+
+/** \brief Core keycode function
+ *
+ * Hands off handling to other quantum/process_keycode/ functions
+ */
+bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+
+    // This is how you use actions here
+    // if (keycode == QK_LEADER) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#if defined(SECURE_ENABLE)
+    if (!preprocess_secure(keycode, record)) {
+        return false;
+    }
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+    if (preprocess_tap_dance(keycode, record)) {
+        // The tap dance might have updated the layer state, therefore the
+        // result of the keycode lookup might change.
+        keycode = get_record_keycode(record, true);
+    }
+#endif
+
+#if defined(UNICODE_COMMON_ENABLE) && defined(UNICODE_QUEUE_ENABLE)
+    // Characters still being typed must reach the host before this key, and
+    // before a released modifier is restored by unicode_input_finish(). Other
+    // releases go through, so the key that queued them does not block the board.
+    if (record->event.pressed || IS_MODIFIER_KEYCODE(keycode) || IS_QK_MODS(keycode) || IS_QK_MOD_TAP(keycode) || IS_QK_ONE_SHOT_MOD(keycode)) {
+        unicode_flush();
+    }
+#endif
+
+#ifdef RGBLIGHT_ENABLE
+    if (record->event.pressed) {
+        preprocess_rgblight();
+    }
+#endif
+
+#ifdef WPM_ENABLE
+    if (record->event.pressed) {
+        update_wpm(keycode);
+    }
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    if (!process_key_lock(&keycode, record)) {
         return false;
     }
+#endif
+
+#ifdef PROCESS_RECORD_QUANTUM_STATS
+    process_record_stats.events++;
+#endif
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(process_record_handlers); i++) {
+        process_record_handler_t entry;
+        memcpy_P(&entry, &process_record_handlers[i], sizeof(entry));
+        if (keycode < entry.first || keycode > entry.last) {
+            continue;
+        }
+#ifdef PROCESS_RECORD_QUANTUM_STATS
+        process_record_stats.handler_calls++;
+#endif
+        if (!entry.handler(keycode, record)) {
+            return false;
+        }
+    }
 
     return true;
 }
@@ -272,6 +272,17 @@ bool     process_record_user(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_kb(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_user(uint16_t keycode, keyrecord_t *record);
 
+#ifdef PROCESS_RECORD_QUANTUM_STATS
+typedef struct {
+    uint32_t events;        // key events dispatched through process_record_quantum()
+    uint32_t handler_calls; // process_* handlers actually called for those events
+    uint8_t  chain_length;  // handlers a full walk of the chain would call per event
+} process_record_quantum_stats_t;
+
+void process_record_quantum_get_stats(process_record_quantum_stats_t *stats);
+void process_record_quantum_reset_stats(void);
+#endif
+
 void reset_keyboard(void);
 void soft_reset_keyboard(void);
 
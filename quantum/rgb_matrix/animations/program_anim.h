@@ -0,0 +1,47 @@
+#ifdef ENABLE_RGB_MATRIX_PROGRAM
+RGB_MATRIX_EFFECT(PROGRAM)
+#    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+// Renders the lighting program loaded through VIA, see rgb_matrix_program.h
+
+bool PROGRAM(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    rgb_matrix_program_frame_t frame = {
+        .hsv  = rgb_matrix_config.hsv,
+        .time = scale16by8(g_rgb_timer, qadd8(rgb_matrix_config.speed / 4, 1)),
+    };
+#        ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+    // The tracker is packed, so take an aligned copy of the ticks
+    uint16_t hit_tick[LED_HITS_TO_REMEMBER];
+    for (uint8_t j = 0; j < g_last_hit_tracker.count; j++) {
+        hit_tick[j] = g_last_hit_tracker.tick[j];
+    }
+    frame.hit_count = g_last_hit_tracker.count;
+    frame.hit_x     = g_last_hit_tracker.x;
+    frame.hit_y     = g_last_hit_tracker.y;
+    frame.hit_tick  = hit_tick;
+#        endif
+    bool polar = rgb_matrix_program_uses_polar();
+
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_program_led_t led = {
+            .index = i,
+            .flags = g_led_config.flags[i],
+            .x     = g_led_config.point[i].x,
+            .y     = g_led_config.point[i].y,
+        };
+        if (polar) {
+            led_polar_t led_polar = rgb_matrix_led_polar(i);
+            led.angle             = led_polar.angle;
+            led.radius            = led_polar.radius;
+        }
+        rgb_t rgb = rgb_matrix_hsv_to_rgb(rgb_matrix_program_eval(&frame, &led));
+        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+    }
+    return rgb_matrix_check_finished_leds(led_max);
+}
+
+#    endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#endif     // ENABLE_RGB_MATRIX_PROGRAM
@@ -0,0 +1,24 @@
+#ifdef ENABLE_RGB_MATRIX_STREAM
+RGB_MATRIX_EFFECT(STREAM)
+#    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+// Shows the last frame streamed by the host, see rgb_matrix_stream.h.
+// The whole frame is copied in the first iteration, so that a frame
+// completed between iterations cannot tear.
+
+bool STREAM(effect_params_t* params) {
+    if (params->iter > 0) {
+        return false;
+    }
+
+    const uint16_t* frame = rgb_matrix_stream_frame();
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_t rgb = frame ? rgb_matrix_stream_to_rgb(frame[i]) : (rgb_t){0, 0, 0};
+        rgb_matrix_set_color(i, scale8(rgb.r, rgb_matrix_config.hsv.v), scale8(rgb.g, rgb_matrix_config.hsv.v), scale8(rgb.b, rgb_matrix_config.hsv.v));
+    }
+    return false;
+}
+
+#    endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#endif     // ENABLE_RGB_MATRIX_STREAM
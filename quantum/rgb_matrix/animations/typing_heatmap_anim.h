@@ -24,6 +24,31 @@ void process_rgb_matrix_typing_heatmap(uint8_t row, uint8_t col) {
     if (g_led_config.matrix_co[row][col] == NO_LED) { // skip as pressed key doesn't have an led position
         return;
     }
+#            ifdef RGB_MATRIX_LED_GEOMETRY
+#                if RGB_MATRIX_TYPING_HEATMAP_SPREAD > RGB_MATRIX_NEIGHBOUR_RADIUS
+#                    error "RGB_MATRIX_NEIGHBOUR_RADIUS must be at least RGB_MATRIX_TYPING_HEATMAP_SPREAD"
+#                endif
+    // Only the pressed key's neighbours can be within the spread
+    uint8_t  led   = g_led_config.matrix_co[row][col];
+    uint16_t first = pgm_read_word(&g_led_neighbour_start[led]);
+    uint16_t last  = pgm_read_word(&g_led_neighbour_start[led + 1]);
+
+    g_rgb_frame_buffer[row][col] = qadd8(g_rgb_frame_buffer[row][col], RGB_MATRIX_TYPING_HEATMAP_INCREASE_STEP);
+    for (uint16_t n = first; n < last; n++) {
+        led_neighbour_t neighbour;
+        led_key_t       key;
+        memcpy_P(&neighbour, &g_led_neighbours[n], sizeof(led_neighbour_t));
+        memcpy_P(&key, &g_led_key[neighbour.index], sizeof(led_key_t));
+        if (key.row == NO_LED || neighbour.distance > RGB_MATRIX_TYPING_HEATMAP_SPREAD) {
+            continue;
+        }
+        uint8_t amount = qsub8(RGB_MATRIX_TYPING_HEATMAP_SPREAD, neighbour.distance);
+        if (amount > RGB_MATRIX_TYPING_HEATMAP_AREA_LIMIT) {
+            amount = RGB_MATRIX_TYPING_HEATMAP_AREA_LIMIT;
+        }
+        g_rgb_frame_buffer[key.row][key.col] = qadd8(g_rgb_frame_buffer[key.row][key.col], amount);
+    }
+#            else
     for (uint8_t i_row = 0; i_row < MATRIX_ROWS; i_row++) {
         for (uint8_t i_col = 0; i_col < MATRIX_COLS; i_col++) {
             if (g_led_config.matrix_co[i_row][i_col] == NO_LED) { // skip as target key doesn't have an led position
@@ -32,9 +57,9 @@ void process_rgb_matrix_typing_heatmap(uint8_t row, uint8_t col) {
             if (i_row == row && i_col == col) {
                 g_rgb_frame_buffer[row][col] = qadd8(g_rgb_frame_buffer[row][col], RGB_MATRIX_TYPING_HEATMAP_INCREASE_STEP);
             } else {
-#            define LED_DISTANCE(led_a, led_b) sqrt16(((int16_t)(led_a.x - led_b.x) * (int16_t)(led_a.x - led_b.x)) + ((int16_t)(led_a.y - led_b.y) * (int16_t)(led_a.y - led_b.y)))
+#                define LED_DISTANCE(led_a, led_b) sqrt16(((int16_t)(led_a.x - led_b.x) * (int16_t)(led_a.x - led_b.x)) + ((int16_t)(led_a.y - led_b.y) * (int16_t)(led_a.y - led_b.y)))
                 uint8_t distance = LED_DISTANCE(g_led_config.point[g_led_config.matrix_co[row][col]], g_led_config.point[g_led_config.matrix_co[i_row][i_col]]);
-#            undef LED_DISTANCE
+#                undef LED_DISTANCE
                 if (distance <= RGB_MATRIX_TYPING_HEATMAP_SPREAD) {
                     uint8_t amount = qsub8(RGB_MATRIX_TYPING_HEATMAP_SPREAD, distance);
                     if (amount > RGB_MATRIX_TYPING_HEATMAP_AREA_LIMIT) {
@@ -45,6 +70,7 @@ void process_rgb_matrix_typing_heatmap(uint8_t row, uint8_t col) {
             }
         }
     }
+#            endif
 #        endif
 }
 
@@ -27,3 +27,8 @@
     defined(ENABLE_RGB_MATRIX_SOLID_MULTISPLASH)
 #    define RGB_MATRIX_KEYPRESSES
 #endif
+
+// geometry
+#ifndef RGB_MATRIX_NEIGHBOUR_RADIUS
+#    define RGB_MATRIX_NEIGHBOUR_RADIUS 40
+#endif
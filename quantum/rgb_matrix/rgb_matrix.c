@@ -17,6 +17,8 @@
  */
 
 #include "rgb_matrix.h"
+#include "rgb_matrix_program.h"
+#include "rgb_matrix_stream.h"
 #include "progmem.h"
 #include "eeconfig.h"
 #include "keyboard.h"
@@ -35,7 +37,11 @@ const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
 __attribute__((weak)) rgb_t rgb_matrix_hsv_to_rgb(hsv_t hsv) {
+#ifdef RGB_MATRIX_HSV_TO_RGB_CACHE
+    return hsv_to_rgb_cached(hsv);
+#else
     return hsv_to_rgb(hsv);
+#endif
 }
 
 // Generic effect runners
@@ -78,20 +84,6 @@ last_hit_t g_last_hit_tracker;
 static const uint8_t rgb_matrix_flag_steps[] = RGB_MATRIX_FLAG_STEPS;
 #define RGB_MATRIX_FLAG_STEPS_COUNT ARRAY_SIZE(rgb_matrix_flag_steps)
 
-// internals
-static bool            suspend_state      = false;
-static uint8_t         rgb_last_enable    = UINT8_MAX;
-static uint8_t         rgb_last_effect    = UINT8_MAX;
-static uint8_t         rgb_current_effect = 0;
-static effect_params_t rgb_effect_params  = {0, LED_FLAG_ALL, false};
-static rgb_task_states rgb_task_state     = SYNCING;
-
-// double buffers
-static uint32_t rgb_timer_buffer;
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-static last_hit_t last_hit_buffer;
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-
 // split rgb matrix
 #if defined(RGB_MATRIX_SPLIT)
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
@@ -99,6 +91,26 @@ const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
 
 EECONFIG_DEBOUNCE_HELPER(rgb_matrix, rgb_matrix_config);
 
+// Task scheduler
+#define LED_EFFECT_CONFIG rgb_matrix_config
+#define LED_EFFECT_TIMER g_rgb_timer
+#define LED_EFFECT_TASK_STATES rgb_task_states
+#define LED_EFFECT_NONE RGB_MATRIX_NONE
+#define LED_EFFECT_FLUSH_LIMIT RGB_MATRIX_LED_FLUSH_LIMIT
+#define LED_EFFECT_TIMEOUT RGB_MATRIX_TIMEOUT
+#define LED_EFFECT_CLEAR() rgb_matrix_set_color_all(0, 0, 0)
+#define LED_EFFECT_FLUSH_EECONFIG() eeconfig_flush_rgb_matrix(false)
+#define LED_EFFECT_UPDATE_PWM_BUFFERS() rgb_matrix_update_pwm_buffers()
+#define LED_EFFECT_INDICATORS() rgb_matrix_indicators()
+#define LED_EFFECT_INDICATORS_ADVANCED(params) rgb_matrix_indicators_advanced(params)
+#define LED_EFFECT_MAP_ROW_COLUMN_TO_LED rgb_matrix_map_row_column_to_led
+#if defined(RGB_MATRIX_KEYRELEASES)
+#    define LED_EFFECT_KEYRELEASES
+#elif defined(RGB_MATRIX_KEYPRESSES)
+#    define LED_EFFECT_KEYPRESSES
+#endif
+#include "led_effect_task.inc"
+
 void eeconfig_force_flush_rgb_matrix(void) {
     eeconfig_flush_rgb_matrix(true);
 }
@@ -152,6 +164,46 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
     return led_count;
 }
 
+led_polar_t rgb_matrix_led_polar(uint8_t led_index) {
+    led_polar_t polar;
+#ifdef RGB_MATRIX_LED_GEOMETRY
+    memcpy_P(&polar, &g_led_polar[led_index], sizeof(led_polar_t));
+#else
+    int16_t dx   = g_led_config.point[led_index].x - k_rgb_matrix_center.x;
+    int16_t dy   = g_led_config.point[led_index].y - k_rgb_matrix_center.y;
+    polar.angle  = atan2_8(dy, dx);
+    polar.radius = sqrt16(dx * dx + dy * dy);
+#endif
+    return polar;
+}
+
+uint8_t rgb_matrix_led_distance(uint8_t led_a, uint8_t led_b) {
+    int16_t dx = g_led_config.point[led_a].x - g_led_config.point[led_b].x;
+    int16_t dy = g_led_config.point[led_a].y - g_led_config.point[led_b].y;
+#ifdef RGB_MATRIX_LED_GEOMETRY
+    // Neighbours are sorted by index, LEDs outside the box around the radius
+    // cannot be one and anything further away is computed below
+    if (abs(dx) <= RGB_MATRIX_NEIGHBOUR_RADIUS && abs(dy) <= RGB_MATRIX_NEIGHBOUR_RADIUS) {
+        uint16_t low  = pgm_read_word(&g_led_neighbour_start[led_a]);
+        uint16_t high = pgm_read_word(&g_led_neighbour_start[led_a + 1]);
+        while (low < high) {
+            uint16_t        mid = (low + high) / 2;
+            led_neighbour_t neighbour;
+            memcpy_P(&neighbour, &g_led_neighbours[mid], sizeof(led_neighbour_t));
+            if (neighbour.index == led_b) {
+                return neighbour.distance;
+            }
+            if (neighbour.index < led_b) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+    }
+#endif
+    return sqrt16(dx * dx + dy * dy);
+}
+
 void rgb_matrix_update_pwm_buffers(void) {
     rgb_matrix_driver.flush();
 }
@@ -183,36 +235,7 @@ void rgb_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed) {
     if (!is_keyboard_master()) return;
 #endif
 
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t led[LED_HITS_TO_REMEMBER];
-    uint8_t led_count = 0;
-
-#    if defined(RGB_MATRIX_KEYRELEASES)
-    if (!pressed)
-#    elif defined(RGB_MATRIX_KEYPRESSES)
-    if (pressed)
-#    endif // defined(RGB_MATRIX_KEYRELEASES)
-    {
-        led_count = rgb_matrix_map_row_column_to_led(row, col, led);
-    }
-
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2); // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count = LED_HITS_TO_REMEMBER - led_count;
-    }
-
-    for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
-    }
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+    led_effect_track_key_hit(row, col, pressed);
 
 #if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
 #    if defined(RGB_MATRIX_KEYRELEASES)
@@ -261,93 +284,36 @@ static bool rgb_matrix_none(effect_params_t *params) {
     return false;
 }
 
-static void rgb_task_timers(void) {
-#if defined(RGB_MATRIX_KEYREACTIVE_ENABLED)
-    uint32_t deltaTime = sync_timer_elapsed32(rgb_timer_buffer);
-#endif // defined(RGB_MATRIX_KEYREACTIVE_ENABLED)
-    rgb_timer_buffer = sync_timer_read32();
+static bool led_effect_render(uint8_t effect, effect_params_t *params) {
+    bool rendering = false;
 
-    // Update double buffer last hit timers
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
-        }
-        last_hit_buffer.tick[i] += deltaTime;
-    }
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-}
-
-static void rgb_task_sync(void) {
-    eeconfig_flush_rgb_matrix(false);
-    // next task
-    if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
-}
-
-static void rgb_task_start(void) {
-    // reset iter
-    rgb_effect_params.iter = 0;
-
-    // update double buffers
-    g_rgb_timer = rgb_timer_buffer;
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker = last_hit_buffer;
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-
-    // Ideally we would also stop sending zeros to the LED driver PWM buffers
-    // while suspended and just do a software shutdown. This is a cheap hack for now.
-    bool suspend_backlight = suspend_state ||
-#if RGB_MATRIX_TIMEOUT > 0
-                             (last_input_activity_elapsed() > (uint32_t)RGB_MATRIX_TIMEOUT) ||
-#endif // RGB_MATRIX_TIMEOUT > 0
-                             false;
-
-    // Set effect to be renedered
-    rgb_current_effect = suspend_backlight || !rgb_matrix_config.enable ? 0 : rgb_matrix_config.mode;
-
-    // next task
-    rgb_task_state = RENDERING;
-}
-
-static void rgb_task_render(uint8_t effect) {
-    bool rendering         = false;
-    rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
-    if (rgb_effect_params.flags != rgb_matrix_config.flags) {
-        rgb_effect_params.flags = rgb_matrix_config.flags;
-        rgb_matrix_set_color_all(0, 0, 0);
-    }
-
-    // each effect can opt to do calculations
-    // and/or request PWM buffer updates.
     switch (effect) {
         case RGB_MATRIX_NONE:
-            rendering = rgb_matrix_none(&rgb_effect_params);
+            rendering = rgb_matrix_none(params);
             break;
 
 // ---------------------------------------------
 // -----Begin rgb effect switch case macros-----
-#define RGB_MATRIX_EFFECT(name, ...)          \
-    case RGB_MATRIX_##name:                   \
-        rendering = name(&rgb_effect_params); \
+#define RGB_MATRIX_EFFECT(name, ...) \
+    case RGB_MATRIX_##name:          \
+        rendering = name(params);    \
         break;
 #include "rgb_matrix_effects.inc"
 #undef RGB_MATRIX_EFFECT
 
 #ifdef COMMUNITY_MODULES_ENABLE
-#    define RGB_MATRIX_EFFECT(name, ...)          \
-        case RGB_MATRIX_COMMUNITY_MODULE_##name:  \
-            rendering = name(&rgb_effect_params); \
+#    define RGB_MATRIX_EFFECT(name, ...)         \
+        case RGB_MATRIX_COMMUNITY_MODULE_##name: \
+            rendering = name(params);            \
             break;
 #    include "rgb_matrix_community_modules.inc"
 #    undef RGB_MATRIX_EFFECT
 #endif
 
 #if defined(RGB_MATRIX_CUSTOM_KB) || defined(RGB_MATRIX_CUSTOM_USER)
-#    define RGB_MATRIX_EFFECT(name, ...)          \
-        case RGB_MATRIX_CUSTOM_##name:            \
-            rendering = name(&rgb_effect_params); \
+#    define RGB_MATRIX_EFFECT(name, ...) \
+        case RGB_MATRIX_CUSTOM_##name:   \
+            rendering = name(params);    \
             break;
 #    ifdef RGB_MATRIX_CUSTOM_KB
 #        include "rgb_matrix_kb.inc"
@@ -361,62 +327,16 @@ static void rgb_task_render(uint8_t effect) {
             // ---------------------------------------------
 
         // Factory default magic value
-        case UINT8_MAX: {
+        case UINT8_MAX:
             rgb_matrix_test();
-            rgb_task_state = FLUSHING;
-        }
-            return;
-    }
-
-    rgb_effect_params.iter++;
-
-    // next task
-    if (!rendering) {
-        rgb_task_state = FLUSHING;
-        if (!rgb_effect_params.init && effect == RGB_MATRIX_NONE) {
-            // We only need to flush once if we are RGB_MATRIX_NONE
-            rgb_task_state = SYNCING;
-        }
+            break;
     }
-}
-
-static void rgb_task_flush(uint8_t effect) {
-    // update last trackers after the first full render so we can init over several frames
-    rgb_last_effect = effect;
-    rgb_last_enable = rgb_matrix_config.enable;
-
-    // update pwm buffers
-    rgb_matrix_update_pwm_buffers();
 
-    // next task
-    rgb_task_state = SYNCING;
+    return rendering;
 }
 
 void rgb_matrix_task(void) {
-    rgb_task_timers();
-
-    uint8_t effect = rgb_current_effect;
-
-    switch (rgb_task_state) {
-        case STARTING:
-            rgb_task_start();
-            break;
-        case RENDERING:
-            rgb_task_render(effect);
-            if (effect) {
-                if (rgb_task_state == FLUSHING) { // ensure we only draw basic indicators once rendering is finished
-                    rgb_matrix_indicators();
-                }
-                rgb_matrix_indicators_advanced(&rgb_effect_params);
-            }
-            break;
-        case FLUSHING:
-            rgb_task_flush(effect);
-            break;
-        case SYNCING:
-            rgb_task_sync();
-            break;
-    }
+    led_effect_task();
 }
 
 __attribute__((weak)) bool rgb_matrix_indicators_modules(void) {
@@ -490,17 +410,7 @@ __attribute__((weak)) bool rgb_matrix_indicators_advanced_user(uint8_t led_min,
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        g_last_hit_tracker.tick[i] = UINT16_MAX;
-    }
-
-    last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+    led_effect_clear_key_hits();
 
     eeconfig_init_rgb_matrix();
     if (!rgb_matrix_config.mode) {
@@ -508,13 +418,17 @@ void rgb_matrix_init(void) {
         eeconfig_update_rgb_matrix_default();
     }
     eeconfig_debug_rgb_matrix(); // display current eeprom values
+
+#ifdef ENABLE_RGB_MATRIX_PROGRAM
+    rgb_matrix_program_init();
+#endif
 }
 
 void rgb_matrix_set_suspend_state(bool state) {
 #ifdef RGB_MATRIX_SLEEP
     if (state && !suspend_state) { // only run if turning off, and only once
-        rgb_task_render(0);        // turn off all LEDs when suspending
-        rgb_task_flush(0);         // and actually flash led state to LEDs
+        led_effect_task_render(0);   // turn off all LEDs when suspending
+        led_effect_task_flush(0);    // and actually flash led state to LEDs
     }
     suspend_state = state;
 #endif
@@ -526,7 +440,7 @@ bool rgb_matrix_get_suspend_state(void) {
 
 void rgb_matrix_toggle_eeprom_helper(bool write_to_eeprom) {
     rgb_matrix_config.enable ^= 1;
-    rgb_task_state = STARTING;
+    led_effect_task_state = STARTING;
     eeconfig_flag_rgb_matrix(write_to_eeprom);
     dprintf("rgb matrix toggle [%s]: rgb_matrix_config.enable = %u\n", (write_to_eeprom) ? "EEPROM" : "NOEEPROM", rgb_matrix_config.enable);
 }
@@ -543,7 +457,7 @@ void rgb_matrix_enable(void) {
 }
 
 void rgb_matrix_enable_noeeprom(void) {
-    if (!rgb_matrix_config.enable) rgb_task_state = STARTING;
+    if (!rgb_matrix_config.enable) led_effect_task_state = STARTING;
     rgb_matrix_config.enable = 1;
 }
 
@@ -553,7 +467,7 @@ void rgb_matrix_disable(void) {
 }
 
 void rgb_matrix_disable_noeeprom(void) {
-    if (rgb_matrix_config.enable) rgb_task_state = STARTING;
+    if (rgb_matrix_config.enable) led_effect_task_state = STARTING;
     rgb_matrix_config.enable = 0;
 }
 
@@ -572,7 +486,7 @@ void rgb_matrix_mode_eeprom_helper(uint8_t mode, bool write_to_eeprom) {
     } else {
         rgb_matrix_config.mode = mode;
     }
-    rgb_task_state = STARTING;
+    led_effect_task_state = STARTING;
     eeconfig_flag_rgb_matrix(write_to_eeprom);
 #ifdef RGB_MATRIX_MODE_NAME_ENABLE
     dprintf("rgb matrix mode [%s]: %u (%s)\n", (write_to_eeprom) ? "EEPROM" : "NOEEPROM", (unsigned)rgb_matrix_config.mode, rgb_matrix_get_mode_name(rgb_matrix_config.mode));
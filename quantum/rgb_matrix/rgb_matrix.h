@@ -151,6 +151,9 @@ void eeconfig_force_flush_rgb_matrix(void);
 uint8_t rgb_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i);
 uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i);
 
+led_polar_t rgb_matrix_led_polar(uint8_t led_index);
+uint8_t     rgb_matrix_led_distance(uint8_t led_a, uint8_t led_b);
+
 int rgb_matrix_led_index(int index);
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
@@ -288,6 +291,13 @@ extern rgb_config_t rgb_matrix_config;
 
 extern uint32_t     g_rgb_timer;
 extern led_config_t g_led_config;
+#ifdef RGB_MATRIX_LED_GEOMETRY
+// Generated from info.json along with g_led_config
+extern const led_polar_t     g_led_polar[RGB_MATRIX_LED_COUNT];
+extern const led_key_t       g_led_key[RGB_MATRIX_LED_COUNT];
+extern const uint16_t        g_led_neighbour_start[RGB_MATRIX_LED_COUNT + 1];
+extern const led_neighbour_t g_led_neighbours[];
+#endif
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 extern last_hit_t g_last_hit_tracker;
 #endif
@@ -0,0 +1,231 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "rgb_matrix_program.h"
+#include "compiler_support.h"
+#include "progmem.h"
+#include <lib/lib8tion/lib8tion.h>
+
+#ifdef VIA_ENABLE
+#    include "nvm_via.h"
+#endif
+
+// A left to right rainbow following the configured colour and speed
+#ifndef RGB_MATRIX_PROGRAM_DEFAULT
+#    define RGB_MATRIX_PROGRAM_DEFAULT \
+        { RGB_MATRIX_PROGRAM_VERSION, 2, RGB_MATRIX_PROGRAM_LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0), RGB_MATRIX_PROGRAM_LAYER(RGB_MATRIX_PROGRAM_OP_ADD, 0, RGB_MATRIX_PROGRAM_PHASE(RGB_MATRIX_PROGRAM_HUE, RGB_MATRIX_PROGRAM_SRC_X), 0, 16, (uint8_t)-1) }
+#endif
+
+static const uint8_t PROGMEM rgb_matrix_program_default[] = RGB_MATRIX_PROGRAM_DEFAULT;
+STATIC_ASSERT(sizeof(rgb_matrix_program_default) <= RGB_MATRIX_PROGRAM_SIZE, "RGB_MATRIX_PROGRAM_DEFAULT has too many layers");
+
+static uint8_t program[RGB_MATRIX_PROGRAM_SIZE];
+static uint8_t program_cost;
+static bool    program_polar;
+
+static bool layer_uses_polar(const uint8_t *layer) {
+    if (layer[0] != RGB_MATRIX_PROGRAM_OP_ADD && layer[0] != RGB_MATRIX_PROGRAM_OP_WAVE) {
+        return false;
+    }
+    uint8_t source = layer[2] & 0x0F;
+    return source == RGB_MATRIX_PROGRAM_SRC_DIST || source == RGB_MATRIX_PROGRAM_SRC_ANGLE;
+}
+
+bool rgb_matrix_program_validate(const uint8_t *data, uint8_t length, uint8_t *cost) {
+    if (length < 2 || data[0] != RGB_MATRIX_PROGRAM_VERSION) {
+        return false;
+    }
+
+    uint8_t count = data[1];
+    if (count > RGB_MATRIX_PROGRAM_MAX_LAYERS || 2 + count * RGB_MATRIX_PROGRAM_LAYER_SIZE > length) {
+        return false;
+    }
+
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t *layer   = &data[2 + i * RGB_MATRIX_PROGRAM_LAYER_SIZE];
+        uint8_t        channel = layer[2] >> 4;
+
+        switch (layer[0]) {
+            case RGB_MATRIX_PROGRAM_OP_FILL:
+            case RGB_MATRIX_PROGRAM_OP_BASE:
+                total += 1;
+                break;
+            case RGB_MATRIX_PROGRAM_OP_ADD:
+            case RGB_MATRIX_PROGRAM_OP_WAVE:
+                if (channel > RGB_MATRIX_PROGRAM_VAL || (layer[2] & 0x0F) >= RGB_MATRIX_PROGRAM_SRC_COUNT) {
+                    return false;
+                }
+                total += 1;
+                break;
+            case RGB_MATRIX_PROGRAM_OP_SPLASH:
+                if (channel > RGB_MATRIX_PROGRAM_VAL) {
+                    return false;
+                }
+                total += 1 + RGB_MATRIX_PROGRAM_MAX_HITS;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    if (total > RGB_MATRIX_PROGRAM_MAX_COST) {
+        return false;
+    }
+    if (cost) {
+        *cost = total;
+    }
+    return true;
+}
+
+bool rgb_matrix_program_load(const uint8_t *data, uint8_t length) {
+    uint8_t cost;
+    if (!rgb_matrix_program_validate(data, length, &cost)) {
+        return false;
+    }
+
+    memset(program, 0, sizeof(program));
+    memcpy(program, data, 2 + data[1] * RGB_MATRIX_PROGRAM_LAYER_SIZE);
+    program_cost  = cost;
+    program_polar = false;
+    for (uint8_t i = 0; i < program[1]; i++) {
+        program_polar |= layer_uses_polar(&program[2 + i * RGB_MATRIX_PROGRAM_LAYER_SIZE]);
+    }
+    return true;
+}
+
+const uint8_t *rgb_matrix_program_get(void) {
+    return program;
+}
+
+uint8_t rgb_matrix_program_cost(void) {
+    return program_cost;
+}
+
+bool rgb_matrix_program_uses_polar(void) {
+    return program_polar;
+}
+
+static uint8_t *channel_of(hsv_t *hsv, uint8_t channel) {
+    switch (channel) {
+        case RGB_MATRIX_PROGRAM_HUE:
+            return &hsv->h;
+        case RGB_MATRIX_PROGRAM_SAT:
+            return &hsv->s;
+        default:
+            return &hsv->v;
+    }
+}
+
+static void channel_add(hsv_t *hsv, uint8_t channel, int16_t delta) {
+    uint8_t *value = channel_of(hsv, channel);
+    if (channel == RGB_MATRIX_PROGRAM_HUE) {
+        *value += (uint8_t)delta;
+        return;
+    }
+
+    int16_t sum = *value + delta;
+    *value      = sum < 0 ? 0 : sum > UINT8_MAX ? UINT8_MAX : sum;
+}
+
+static int16_t layer_phase(const rgb_matrix_program_frame_t *frame, const rgb_matrix_program_led_t *led, const uint8_t *layer) {
+    uint8_t source = 0;
+    switch (layer[2] & 0x0F) {
+        case RGB_MATRIX_PROGRAM_SRC_X:
+            source = led->x;
+            break;
+        case RGB_MATRIX_PROGRAM_SRC_Y:
+            source = led->y;
+            break;
+        case RGB_MATRIX_PROGRAM_SRC_DIST:
+            source = led->radius;
+            break;
+        case RGB_MATRIX_PROGRAM_SRC_ANGLE:
+            source = led->angle;
+            break;
+        case RGB_MATRIX_PROGRAM_SRC_INDEX:
+            source = led->index;
+            break;
+    }
+
+    // The time term wraps at 256, like the hue it usually feeds
+    uint8_t time = frame->time * (int8_t)layer[5];
+    return (int8_t)layer[3] + ((source * (int8_t)layer[4]) >> 4) + (int8_t)time;
+}
+
+static uint8_t layer_splash(const rgb_matrix_program_frame_t *frame, const rgb_matrix_program_led_t *led, const uint8_t *layer) {
+    uint8_t splash = 0;
+    uint8_t speed  = qadd8(layer[4], 1);
+    uint8_t first  = frame->hit_count > RGB_MATRIX_PROGRAM_MAX_HITS ? frame->hit_count - RGB_MATRIX_PROGRAM_MAX_HITS : 0;
+
+    for (uint8_t j = first; j < frame->hit_count; j++) {
+        int16_t  dx     = led->x - frame->hit_x[j];
+        int16_t  dy     = led->y - frame->hit_y[j];
+        uint16_t effect = scale16by8(frame->hit_tick[j], speed) + ((sqrt16(dx * dx + dy * dy) * layer[3]) >> 2);
+        if (effect < UINT8_MAX) {
+            splash = qadd8(splash, UINT8_MAX - effect);
+        }
+    }
+    return splash;
+}
+
+hsv_t rgb_matrix_program_eval(const rgb_matrix_program_frame_t *frame, const rgb_matrix_program_led_t *led) {
+    hsv_t hsv = {0, 0, 0};
+
+    for (uint8_t i = 0; i < program[1]; i++) {
+        const uint8_t *layer = &program[2 + i * RGB_MATRIX_PROGRAM_LAYER_SIZE];
+        if (layer[1] && !(led->flags & layer[1])) {
+            continue;
+        }
+
+        switch (layer[0]) {
+            case RGB_MATRIX_PROGRAM_OP_FILL:
+                hsv = (hsv_t){layer[2], layer[3], layer[4]};
+                break;
+            case RGB_MATRIX_PROGRAM_OP_BASE:
+                hsv = frame->hsv;
+                break;
+            case RGB_MATRIX_PROGRAM_OP_ADD:
+                channel_add(&hsv, layer[2] >> 4, layer_phase(frame, led, layer));
+                break;
+            case RGB_MATRIX_PROGRAM_OP_WAVE: {
+                uint8_t *value = channel_of(&hsv, layer[2] >> 4);
+                *value         = scale8(*value, sin8((uint8_t)layer_phase(frame, led, layer)));
+                break;
+            }
+            case RGB_MATRIX_PROGRAM_OP_SPLASH:
+                channel_add(&hsv, layer[2] >> 4, scale8(layer_splash(frame, led, layer), layer[5]));
+                break;
+        }
+    }
+    return hsv;
+}
+
+static void rgb_matrix_program_load_default(void) {
+    uint8_t data[RGB_MATRIX_PROGRAM_SIZE] = {0};
+    memcpy_P(data, rgb_matrix_program_default, sizeof(rgb_matrix_program_default));
+    rgb_matrix_program_load(data, sizeof(data));
+}
+
+void rgb_matrix_program_init(void) {
+#ifdef VIA_ENABLE
+    uint8_t data[RGB_MATRIX_PROGRAM_SIZE];
+    nvm_via_read_rgb_matrix_program(data, sizeof(data));
+    if (rgb_matrix_program_load(data, sizeof(data))) {
+        return;
+    }
+#endif
+    rgb_matrix_program_load_default();
+}
+
+void rgb_matrix_program_reset(void) {
+    rgb_matrix_program_load_default();
+    rgb_matrix_program_save();
+}
+
+void rgb_matrix_program_save(void) {
+#ifdef VIA_ENABLE
+    nvm_via_update_rgb_matrix_program(program, sizeof(program));
+#endif
+}
@@ -0,0 +1,173 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color.h"
+
+/*
+ * A lighting program is a short list of layers applied in order to every
+ * LED. Each layer is a fixed size parameter block, so programs can be
+ * stored in flash or EEPROM and replaced over raw HID without rebuilding
+ * the firmware.
+ *
+ * Program layout, in bytes:
+ *
+ *   [0]  RGB_MATRIX_PROGRAM_VERSION
+ *   [1]  number of layers
+ *   [2+] layers, RGB_MATRIX_PROGRAM_LAYER_SIZE bytes each:
+ *        op, LED flags the layer applies to (0 for all LEDs), p0, p1, p2, p3
+ *
+ * Layers start from the pixel left by the previous layer; the first layer
+ * starts from black.
+ */
+
+#define RGB_MATRIX_PROGRAM_VERSION 1
+
+#ifndef RGB_MATRIX_PROGRAM_MAX_LAYERS
+#    define RGB_MATRIX_PROGRAM_MAX_LAYERS 8
+#endif
+
+// Key hits looked at by a splash layer
+#ifndef RGB_MATRIX_PROGRAM_MAX_HITS
+#    define RGB_MATRIX_PROGRAM_MAX_HITS 8
+#endif
+
+// Upper bound on the work done per LED, see rgb_matrix_program_validate()
+#ifndef RGB_MATRIX_PROGRAM_MAX_COST
+#    define RGB_MATRIX_PROGRAM_MAX_COST 24
+#endif
+
+#define RGB_MATRIX_PROGRAM_LAYER_SIZE 6
+#define RGB_MATRIX_PROGRAM_SIZE (2 + RGB_MATRIX_PROGRAM_MAX_LAYERS * RGB_MATRIX_PROGRAM_LAYER_SIZE)
+
+enum rgb_matrix_program_op {
+    // pixel = {p0, p1, p2}
+    RGB_MATRIX_PROGRAM_OP_FILL = 0,
+    // pixel = the configured colour
+    RGB_MATRIX_PROGRAM_OP_BASE,
+    // channel += phase, wrapping for hue and saturating otherwise
+    RGB_MATRIX_PROGRAM_OP_ADD,
+    // channel = channel * sin(phase)
+    RGB_MATRIX_PROGRAM_OP_WAVE,
+    // channel += p3 * splash, where splash fades with the time since each
+    // recent key hit and the distance to it
+    RGB_MATRIX_PROGRAM_OP_SPLASH,
+    RGB_MATRIX_PROGRAM_OP_COUNT,
+};
+
+/*
+ * ADD and WAVE take a phase built from:
+ *
+ *   p0  channel (high nibble) and source (low nibble)
+ *   p1  offset
+ *   p2  signed scale applied to the source, in 1/16ths
+ *   p3  signed multiplier applied to the effect time
+ *
+ *   phase = p1 + source * p2 / 16 + time * p3
+ *
+ * SPLASH takes:
+ *
+ *   p0  channel (high nibble)
+ *   p1  spread, how much the splash fades with distance, in 1/4ths
+ *   p2  speed, how quickly it fades with time
+ *   p3  strength
+ */
+enum rgb_matrix_program_channel {
+    RGB_MATRIX_PROGRAM_HUE = 0,
+    RGB_MATRIX_PROGRAM_SAT,
+    RGB_MATRIX_PROGRAM_VAL,
+};
+
+enum rgb_matrix_program_source {
+    RGB_MATRIX_PROGRAM_SRC_NONE = 0,
+    RGB_MATRIX_PROGRAM_SRC_X,
+    RGB_MATRIX_PROGRAM_SRC_Y,
+    RGB_MATRIX_PROGRAM_SRC_DIST,
+    RGB_MATRIX_PROGRAM_SRC_ANGLE,
+    RGB_MATRIX_PROGRAM_SRC_INDEX,
+    RGB_MATRIX_PROGRAM_SRC_COUNT,
+};
+
+#define RGB_MATRIX_PROGRAM_LAYER(op, flags, p0, p1, p2, p3) (op), (flags), (p0), (p1), (p2), (p3)
+#define RGB_MATRIX_PROGRAM_PHASE(channel, source) ((uint8_t)(((channel) << 4) | (source)))
+
+// Per frame inputs
+typedef struct rgb_matrix_program_frame_t {
+    hsv_t           hsv;       // the configured colour
+    uint8_t         time;      // effect time, already scaled by the configured speed
+    uint8_t         hit_count; // number of entries in the hit arrays
+    const uint8_t  *hit_x;
+    const uint8_t  *hit_y;
+    const uint16_t *hit_tick;  // milliseconds since each hit
+} rgb_matrix_program_frame_t;
+
+// Per LED inputs
+typedef struct rgb_matrix_program_led_t {
+    uint8_t index;
+    uint8_t flags;
+    uint8_t x;
+    uint8_t y;
+    uint8_t angle;  // only filled in if rgb_matrix_program_uses_polar()
+    uint8_t radius; // only filled in if rgb_matrix_program_uses_polar()
+} rgb_matrix_program_led_t;
+
+/**
+ * \brief Check a program and compute its cost.
+ *
+ * The cost is the number of layer steps evaluated per LED, counting a
+ * splash layer once per key hit it looks at.
+ *
+ * \param data The program.
+ * \param length The size of the program buffer.
+ * \param cost Set to the cost of the program, may be NULL.
+ *
+ * \return true if the program is well formed and within RGB_MATRIX_PROGRAM_MAX_COST.
+ */
+bool rgb_matrix_program_validate(const uint8_t *data, uint8_t length, uint8_t *cost);
+
+/**
+ * \brief Validate and activate a program.
+ *
+ * The active program is left untouched if the new one is rejected.
+ *
+ * \return true if the program was activated.
+ */
+bool rgb_matrix_program_load(const uint8_t *data, uint8_t length);
+
+/**
+ * \brief Get the active program, RGB_MATRIX_PROGRAM_SIZE bytes long.
+ */
+const uint8_t *rgb_matrix_program_get(void);
+
+/**
+ * \brief Get the cost of the active program.
+ */
+uint8_t rgb_matrix_program_cost(void);
+
+/**
+ * \brief Whether the active program reads the angle or radius of LEDs.
+ */
+bool rgb_matrix_program_uses_polar(void);
+
+/**
+ * \brief Compute the colour of one LED with the active program.
+ */
+hsv_t rgb_matrix_program_eval(const rgb_matrix_program_frame_t *frame, const rgb_matrix_program_led_t *led);
+
+/**
+ * \brief Load the stored program, falling back to RGB_MATRIX_PROGRAM_DEFAULT.
+ */
+void rgb_matrix_program_init(void);
+
+/**
+ * \brief Load RGB_MATRIX_PROGRAM_DEFAULT and store it.
+ */
+void rgb_matrix_program_reset(void);
+
+/**
+ * \brief Store the active program.
+ */
+void rgb_matrix_program_save(void);
@@ -0,0 +1,161 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "rgb_matrix_stream.h"
+
+typedef enum { BACK_IDLE, BACK_RECEIVING, BACK_REJECTED } back_state_t;
+
+static uint16_t frames[2][RGB_MATRIX_LED_COUNT];
+static uint16_t palette[RGB_MATRIX_STREAM_PALETTE_SIZE];
+static uint8_t  front;
+static uint8_t  front_frame;
+static bool     has_frame;
+static bool     keyframe_needed = true;
+
+static back_state_t back_state;
+static uint8_t      back_frame;
+static uint8_t      back_parts;
+static uint32_t     back_received;
+
+static rgb_matrix_stream_stats_t stats;
+
+// Returns false if the runs are malformed, in which case the packet is
+// treated as lost
+static bool decode_runs(uint16_t *back, const uint8_t *data, uint8_t length) {
+    while (length >= 2) {
+        uint8_t first  = data[0];
+        uint8_t count  = data[1] & RGB_MATRIX_STREAM_MAX_RUN;
+        uint8_t format = data[1] >> 6;
+        if (count == 0) {
+            break;
+        }
+        data += 2;
+        length -= 2;
+
+        uint8_t size = format == RGB_MATRIX_STREAM_INDEXED ? (count + 1) / 2 : count * 2;
+        uint8_t end  = format == RGB_MATRIX_STREAM_PALETTE ? RGB_MATRIX_STREAM_PALETTE_SIZE : RGB_MATRIX_LED_COUNT;
+        if (size > length || first + count > end) {
+            return false;
+        }
+
+        for (uint8_t i = 0; i < count; i++) {
+            switch (format) {
+                case RGB_MATRIX_STREAM_RGB565:
+                    back[first + i] = data[i * 2] | (data[i * 2 + 1] << 8);
+                    break;
+                case RGB_MATRIX_STREAM_INDEXED:
+                    back[first + i] = palette[(data[i / 2] >> ((i & 1) * 4)) & 0x0F];
+                    break;
+                case RGB_MATRIX_STREAM_PALETTE:
+                    palette[first + i] = data[i * 2] | (data[i * 2 + 1] << 8);
+                    break;
+                default:
+                    return false;
+            }
+        }
+        data += size;
+        length -= size;
+    }
+    return true;
+}
+
+static void begin_frame(uint8_t kind, uint8_t frame, uint8_t base, uint8_t parts) {
+    if (back_state == BACK_RECEIVING) {
+        stats.dropped++;
+    }
+    back_frame    = frame;
+    back_parts    = parts;
+    back_received = 0;
+
+    uint16_t *back = frames[front ^ 1];
+    if (kind == RGB_MATRIX_STREAM_KEYFRAME) {
+        memset(back, 0, sizeof(frames[0]));
+    } else if (has_frame && !keyframe_needed && base == front_frame) {
+        memcpy(back, frames[front], sizeof(frames[0]));
+    } else {
+        back_state      = BACK_REJECTED;
+        keyframe_needed = true;
+        stats.rejected++;
+        return;
+    }
+    back_state = BACK_RECEIVING;
+}
+
+static void receive_part(const uint8_t *data, uint8_t length) {
+    uint8_t kind = data[1], frame = data[2], base = data[3], part = data[4], parts = data[5];
+    if (parts == 0 || parts > RGB_MATRIX_STREAM_MAX_PARTS || part >= parts) {
+        return;
+    }
+
+    if (back_state == BACK_IDLE || frame != back_frame) {
+        // A late copy of the frame on display
+        if (back_state == BACK_IDLE && has_frame && frame == front_frame) {
+            return;
+        }
+        begin_frame(kind, frame, base, parts);
+    }
+
+    uint32_t bit = (uint32_t)1 << part;
+    if (back_state != BACK_RECEIVING || parts != back_parts || (back_received & bit)) {
+        return;
+    }
+    if (!decode_runs(frames[front ^ 1], &data[RGB_MATRIX_STREAM_HEADER_SIZE], length - RGB_MATRIX_STREAM_HEADER_SIZE)) {
+        return;
+    }
+
+    back_received |= bit;
+    if (back_received == (UINT32_MAX >> (32 - back_parts))) {
+        front ^= 1;
+        front_frame = back_frame;
+        has_frame   = true;
+        back_state  = BACK_IDLE;
+        if (kind == RGB_MATRIX_STREAM_KEYFRAME) {
+            keyframe_needed = false;
+        }
+        stats.frames++;
+    }
+}
+
+bool rgb_matrix_stream_receive(uint8_t *data, uint8_t length) {
+    if (length < RGB_MATRIX_STREAM_HEADER_SIZE) {
+        return false;
+    }
+
+    switch (data[1]) {
+        case RGB_MATRIX_STREAM_STATUS:
+            if (length < RGB_MATRIX_STREAM_STATUS_SIZE) {
+                return false;
+            }
+            data[2]  = front_frame;
+            data[3]  = (has_frame ? RGB_MATRIX_STREAM_HAS_FRAME : 0) | (keyframe_needed ? RGB_MATRIX_STREAM_KEYFRAME_NEEDED : 0);
+            data[4]  = RGB_MATRIX_LED_COUNT;
+            data[5]  = stats.frames & 0xFF;
+            data[6]  = stats.frames >> 8;
+            data[7]  = stats.dropped & 0xFF;
+            data[8]  = stats.dropped >> 8;
+            data[9]  = stats.rejected & 0xFF;
+            data[10] = stats.rejected >> 8;
+            return true;
+        case RGB_MATRIX_STREAM_KEYFRAME:
+        case RGB_MATRIX_STREAM_DELTA:
+            receive_part(data, length);
+            break;
+    }
+    return false;
+}
+
+const uint16_t *rgb_matrix_stream_frame(void) {
+    return has_frame ? frames[front] : NULL;
+}
+
+rgb_matrix_stream_stats_t rgb_matrix_stream_get_stats(void) {
+    return stats;
+}
+
+void rgb_matrix_stream_reset(void) {
+    has_frame       = false;
+    keyframe_needed = true;
+    back_state      = BACK_IDLE;
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,104 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color.h"
+
+/*
+ * Host driven lighting, streamed as whole frames over raw HID.
+ *
+ * Every report starts with a header:
+ *
+ *   [0]  RGB_MATRIX_STREAM_COMMAND
+ *   [1]  packet kind, see rgb_matrix_stream_kind
+ *   [2]  frame sequence number
+ *   [3]  sequence number of the frame a delta applies to
+ *   [4]  index of this part of the frame
+ *   [5]  number of parts in the frame, at most RGB_MATRIX_STREAM_MAX_PARTS
+ *
+ * followed by runs of two header bytes, the first LED (or palette entry)
+ * and the count in the low 6 bits with the run format in the high 2 bits,
+ * then the run data. A run with a count of 0 ends the packet.
+ *
+ * A keyframe starts from black and a delta starts from the frame it names,
+ * which has to be the last complete frame. Frames are decoded into a back
+ * buffer and swapped in once every part has been received; a frame with a
+ * missing part is dropped when the next one starts, and deltas that follow
+ * it are rejected until a keyframe arrives. Stream packets are not echoed,
+ * the host polls RGB_MATRIX_STREAM_STATUS to find out whether it needs to
+ * send a keyframe.
+ */
+
+#ifndef RGB_MATRIX_STREAM_COMMAND
+#    define RGB_MATRIX_STREAM_COMMAND 0x80
+#endif
+
+#define RGB_MATRIX_STREAM_HEADER_SIZE 6
+#define RGB_MATRIX_STREAM_STATUS_SIZE 11
+#define RGB_MATRIX_STREAM_MAX_PARTS 32
+#define RGB_MATRIX_STREAM_PALETTE_SIZE 16
+#define RGB_MATRIX_STREAM_MAX_RUN 63
+
+enum rgb_matrix_stream_kind {
+    // Reply with the stream state, see rgb_matrix_stream_receive()
+    RGB_MATRIX_STREAM_STATUS = 0,
+    RGB_MATRIX_STREAM_KEYFRAME,
+    RGB_MATRIX_STREAM_DELTA,
+};
+
+enum rgb_matrix_stream_format {
+    // 2 bytes per LED, little endian RGB565
+    RGB_MATRIX_STREAM_RGB565 = 0,
+    // 4 bits per LED indexing the palette, low nibble first
+    RGB_MATRIX_STREAM_INDEXED,
+    // 2 bytes per palette entry, little endian RGB565
+    RGB_MATRIX_STREAM_PALETTE,
+};
+
+// Status reply flags
+#define RGB_MATRIX_STREAM_HAS_FRAME 0x01
+#define RGB_MATRIX_STREAM_KEYFRAME_NEEDED 0x02
+
+#define RGB_MATRIX_STREAM_RUN(format, count) ((uint8_t)(((format) << 6) | (count)))
+#define RGB_MATRIX_STREAM_RGB565_OF(r, g, b) ((uint16_t)((((r) >> 3) << 11) | (((g) >> 2) << 5) | ((b) >> 3)))
+
+static inline rgb_t rgb_matrix_stream_to_rgb(uint16_t color) {
+    uint8_t r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+    return (rgb_t){(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+typedef struct rgb_matrix_stream_stats_t {
+    uint16_t frames;   // frames completed
+    uint16_t dropped;  // frames abandoned with missing parts
+    uint16_t rejected; // deltas whose base frame was never completed
+} rgb_matrix_stream_stats_t;
+
+/**
+ * \brief Handle a stream packet, whose first byte is RGB_MATRIX_STREAM_COMMAND.
+ *
+ * A status request is answered in place with:
+ *
+ *   [0] RGB_MATRIX_STREAM_COMMAND, [1] RGB_MATRIX_STREAM_STATUS,
+ *   [2] last complete frame, [3] flags, [4] LED count,
+ *   [5..10] frames, dropped and rejected counts, little endian
+ *
+ * \return true if `data` holds a reply to send back to the host.
+ */
+bool rgb_matrix_stream_receive(uint8_t *data, uint8_t length);
+
+/**
+ * \brief Get the last complete frame, RGB_MATRIX_LED_COUNT colours in RGB565.
+ *
+ * \return NULL until a frame has been received.
+ */
+const uint16_t *rgb_matrix_stream_frame(void);
+
+rgb_matrix_stream_stats_t rgb_matrix_stream_get_stats(void);
+
+/**
+ * \brief Forget the current frame and counters.
+ */
+void rgb_matrix_stream_reset(void);
@@ -0,0 +1,175 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "rgb_matrix_stream_encoder.h"
+
+void rgb_matrix_stream_encoder_init(rgb_matrix_stream_encoder_t *encoder, uint8_t led_count, uint8_t report_size, uint8_t keyframe_interval) {
+    memset(encoder, 0, sizeof(*encoder));
+    encoder->led_count         = led_count < UINT8_MAX ? led_count : UINT8_MAX - 1;
+    encoder->report_size       = report_size < RGB_MATRIX_STREAM_MAX_REPORT ? report_size : RGB_MATRIX_STREAM_MAX_REPORT;
+    encoder->keyframe_interval = keyframe_interval;
+    encoder->keyframe_needed   = true;
+}
+
+static bool new_report(rgb_matrix_stream_encoder_t *encoder, uint8_t kind) {
+    if (encoder->parts == RGB_MATRIX_STREAM_MAX_PARTS) {
+        return false;
+    }
+
+    uint8_t *report = encoder->reports[encoder->parts];
+    memset(report, 0, encoder->report_size);
+    report[0] = RGB_MATRIX_STREAM_COMMAND;
+    report[1] = kind;
+    report[2] = encoder->frame;
+    report[3] = encoder->frame - 1;
+    report[4] = encoder->parts;
+    // report[5] is filled in once the frame is complete
+
+    encoder->parts++;
+    encoder->used = RGB_MATRIX_STREAM_HEADER_SIZE;
+    return true;
+}
+
+// Append a run, splitting it over as many reports as needed. Values are
+// colours, or palette indices for RGB_MATRIX_STREAM_INDEXED.
+static bool add_run(rgb_matrix_stream_encoder_t *encoder, uint8_t kind, uint8_t format, uint8_t first, const uint16_t *values, uint8_t count) {
+    while (count > 0) {
+        uint8_t space = encoder->parts ? encoder->report_size - encoder->used : 0;
+        uint8_t fit   = space < 3 ? 0 : format == RGB_MATRIX_STREAM_INDEXED ? (space - 2) * 2 : (space - 2) / 2;
+        if (fit == 0) {
+            if (!new_report(encoder, kind)) {
+                return false;
+            }
+            continue;
+        }
+        if (fit > count) fit = count;
+        if (fit > RGB_MATRIX_STREAM_MAX_RUN) fit = RGB_MATRIX_STREAM_MAX_RUN;
+
+        uint8_t *out = &encoder->reports[encoder->parts - 1][encoder->used];
+        *out++       = first;
+        *out++       = RGB_MATRIX_STREAM_RUN(format, fit);
+        for (uint8_t i = 0; i < fit; i++) {
+            if (format == RGB_MATRIX_STREAM_INDEXED) {
+                out[i / 2] |= values[i] << ((i & 1) * 4);
+            } else {
+                out[i * 2]     = values[i] & 0xFF;
+                out[i * 2 + 1] = values[i] >> 8;
+            }
+        }
+        encoder->used += 2 + (format == RGB_MATRIX_STREAM_INDEXED ? (fit + 1) / 2 : fit * 2);
+
+        first += fit;
+        values += fit;
+        count -= fit;
+    }
+    return true;
+}
+
+static int8_t palette_index(const rgb_matrix_stream_encoder_t *encoder, uint16_t color) {
+    for (uint8_t i = 0; i < encoder->palette_size; i++) {
+        if (encoder->palette[i] == color) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void build_palette(rgb_matrix_stream_encoder_t *encoder, const uint16_t *colors) {
+    encoder->palette_size = 0;
+    for (uint8_t i = 0; i < encoder->led_count; i++) {
+        if (palette_index(encoder, colors[i]) >= 0) {
+            continue;
+        }
+        if (encoder->palette_size == RGB_MATRIX_STREAM_PALETTE_SIZE) {
+            encoder->palette_size = 0;
+            return;
+        }
+        encoder->palette[encoder->palette_size++] = colors[i];
+    }
+}
+
+// Indexed if every colour is in the palette, RGB565 otherwise
+static bool add_colors(rgb_matrix_stream_encoder_t *encoder, uint8_t kind, uint8_t first, const uint16_t *colors, uint8_t count) {
+    uint16_t indices[UINT8_MAX];
+    for (uint8_t i = 0; i < count; i++) {
+        int8_t index = palette_index(encoder, colors[i]);
+        if (index < 0) {
+            return add_run(encoder, kind, RGB_MATRIX_STREAM_RGB565, first, colors, count);
+        }
+        indices[i] = index;
+    }
+    return add_run(encoder, kind, RGB_MATRIX_STREAM_INDEXED, first, indices, count);
+}
+
+static bool encode_delta(rgb_matrix_stream_encoder_t *encoder, const uint16_t *colors) {
+    uint8_t i = 0;
+    while (i < encoder->led_count) {
+        if (colors[i] == encoder->previous[i]) {
+            i++;
+            continue;
+        }
+
+        // An unchanged LED between two changed ones costs less to resend
+        // than a new run header
+        uint8_t end = i + 1;
+        while (end < encoder->led_count) {
+            if (colors[end] != encoder->previous[end]) {
+                end++;
+            } else if (end + 1 < encoder->led_count && colors[end + 1] != encoder->previous[end + 1]) {
+                end += 2;
+            } else {
+                break;
+            }
+        }
+
+        if (!add_colors(encoder, RGB_MATRIX_STREAM_DELTA, i, &colors[i], end - i)) {
+            return false;
+        }
+        i = end;
+    }
+    return true;
+}
+
+static bool encode_keyframe(rgb_matrix_stream_encoder_t *encoder, const uint16_t *colors) {
+    build_palette(encoder, colors);
+    if (encoder->palette_size > 0 && !add_run(encoder, RGB_MATRIX_STREAM_KEYFRAME, RGB_MATRIX_STREAM_PALETTE, 0, encoder->palette, encoder->palette_size)) {
+        return false;
+    }
+    return add_colors(encoder, RGB_MATRIX_STREAM_KEYFRAME, 0, colors, encoder->led_count);
+}
+
+uint8_t rgb_matrix_stream_encode(rgb_matrix_stream_encoder_t *encoder, const uint16_t *colors, rgb_matrix_stream_send_t send, void *context) {
+    bool keyframe = encoder->keyframe_needed || (encoder->keyframe_interval && encoder->since_keyframe >= encoder->keyframe_interval);
+
+    encoder->parts = 0;
+    if (!(keyframe ? encode_keyframe(encoder, colors) : encode_delta(encoder, colors)) || encoder->parts == 0) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < encoder->parts; i++) {
+        encoder->reports[i][5] = encoder->parts;
+        send(encoder->reports[i], encoder->report_size, context);
+    }
+
+    memcpy(encoder->previous, colors, encoder->led_count * sizeof(uint16_t));
+    encoder->frame++;
+    encoder->since_keyframe  = keyframe ? 1 : encoder->since_keyframe + 1;
+    encoder->keyframe_needed = false;
+    return encoder->parts;
+}
+
+void rgb_matrix_stream_encoder_status_request(const rgb_matrix_stream_encoder_t *encoder, uint8_t *report) {
+    memset(report, 0, encoder->report_size);
+    report[0] = RGB_MATRIX_STREAM_COMMAND;
+    report[1] = RGB_MATRIX_STREAM_STATUS;
+}
+
+void rgb_matrix_stream_encoder_status_reply(rgb_matrix_stream_encoder_t *encoder, const uint8_t *report, uint8_t length) {
+    if (length < RGB_MATRIX_STREAM_STATUS_SIZE || report[0] != RGB_MATRIX_STREAM_COMMAND || report[1] != RGB_MATRIX_STREAM_STATUS) {
+        return;
+    }
+    if (report[3] & RGB_MATRIX_STREAM_KEYFRAME_NEEDED) {
+        encoder->keyframe_needed = true;
+    }
+}
@@ -0,0 +1,66 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rgb_matrix_stream.h"
+
+/*
+ * Host side encoder for the RGB Matrix stream protocol, see
+ * rgb_matrix_stream.h. It is not built into the firmware; host tools can
+ * compile it directly.
+ *
+ * Frames are sent as keyframes when the encoder starts, every
+ * `keyframe_interval` frames and after the keyboard reports that it needs
+ * one, and as deltas of the changed LEDs otherwise. A keyframe of at most
+ * RGB_MATRIX_STREAM_PALETTE_SIZE colours is sent as a palette and 4 bit
+ * indices, and later deltas reuse that palette where they can.
+ */
+
+#define RGB_MATRIX_STREAM_MAX_REPORT 64
+
+typedef void (*rgb_matrix_stream_send_t)(const uint8_t *report, uint8_t length, void *context);
+
+typedef struct rgb_matrix_stream_encoder_t {
+    uint8_t  led_count;
+    uint8_t  report_size;
+    uint8_t  keyframe_interval; // 0 to only send keyframes when needed
+    uint8_t  frame;             // sequence number of the next frame
+    uint8_t  since_keyframe;
+    bool     keyframe_needed;
+    uint8_t  palette_size;
+    uint16_t palette[RGB_MATRIX_STREAM_PALETTE_SIZE];
+    uint16_t previous[UINT8_MAX];
+    // frame being built
+    uint8_t parts;
+    uint8_t used;
+    uint8_t reports[RGB_MATRIX_STREAM_MAX_PARTS][RGB_MATRIX_STREAM_MAX_REPORT];
+} rgb_matrix_stream_encoder_t;
+
+/**
+ * \brief Set up an encoder.
+ *
+ * \param led_count Number of LEDs, as reported by the status reply.
+ * \param report_size Raw HID report size, 32 or 64.
+ * \param keyframe_interval Frames between keyframes, 0 to only send them when needed.
+ */
+void rgb_matrix_stream_encoder_init(rgb_matrix_stream_encoder_t *encoder, uint8_t led_count, uint8_t report_size, uint8_t keyframe_interval);
+
+/**
+ * \brief Encode a frame of `led_count` RGB565 colours and send its reports.
+ *
+ * \return The number of reports sent, 0 if nothing changed.
+ */
+uint8_t rgb_matrix_stream_encode(rgb_matrix_stream_encoder_t *encoder, const uint16_t *colors, rgb_matrix_stream_send_t send, void *context);
+
+/**
+ * \brief Fill in a status request report of `report_size` bytes.
+ */
+void rgb_matrix_stream_encoder_status_request(const rgb_matrix_stream_encoder_t *encoder, uint8_t *report);
+
+/**
+ * \brief Handle a status reply, scheduling a keyframe if the keyboard needs one.
+ */
+void rgb_matrix_stream_encoder_status_reply(rgb_matrix_stream_encoder_t *encoder, const uint8_t *report, uint8_t length);
@@ -0,0 +1,187 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "rgb_matrix_program.h"
+}
+
+#define LAYER(op, flags, p0, p1, p2, p3) (uint8_t)(op), (uint8_t)(flags), (uint8_t)(p0), (uint8_t)(p1), (uint8_t)(p2), (uint8_t)(p3)
+#define PHASE(channel, source) RGB_MATRIX_PROGRAM_PHASE(RGB_MATRIX_PROGRAM_##channel, RGB_MATRIX_PROGRAM_SRC_##source)
+
+class RgbMatrixProgramTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        rgb_matrix_program_init();
+    }
+
+    bool load(std::vector<uint8_t> layers) {
+        std::vector<uint8_t> data = {RGB_MATRIX_PROGRAM_VERSION, (uint8_t)(layers.size() / RGB_MATRIX_PROGRAM_LAYER_SIZE)};
+        data.insert(data.end(), layers.begin(), layers.end());
+        return rgb_matrix_program_load(data.data(), data.size());
+    }
+
+    hsv_t eval(uint8_t x, uint8_t y, uint8_t flags = 0x01) {
+        rgb_matrix_program_led_t led = {0, flags, x, y, 0, 0};
+        return rgb_matrix_program_eval(&frame, &led);
+    }
+
+    rgb_matrix_program_frame_t frame = {{10, 255, 200}, 0, 0, nullptr, nullptr, nullptr};
+};
+
+TEST_F(RgbMatrixProgramTest, DefaultProgramIsARainbow) {
+    EXPECT_EQ(rgb_matrix_program_cost(), 2);
+
+    hsv_t hsv = eval(0, 0);
+    EXPECT_EQ(hsv.h, 10);
+    EXPECT_EQ(hsv.s, 255);
+    EXPECT_EQ(hsv.v, 200);
+
+    // Hue follows x and moves backwards with time
+    EXPECT_EQ(eval(32, 0).h, 42);
+    frame.time = 5;
+    EXPECT_EQ(eval(32, 0).h, 37);
+}
+
+TEST_F(RgbMatrixProgramTest, RejectsMalformedPrograms) {
+    uint8_t bad_version[] = {RGB_MATRIX_PROGRAM_VERSION + 1, 1, LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0)};
+    EXPECT_FALSE(rgb_matrix_program_validate(bad_version, sizeof(bad_version), nullptr));
+
+    uint8_t truncated[] = {RGB_MATRIX_PROGRAM_VERSION, 2, LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0)};
+    EXPECT_FALSE(rgb_matrix_program_validate(truncated, sizeof(truncated), nullptr));
+
+    uint8_t bad_op[] = {RGB_MATRIX_PROGRAM_VERSION, 1, LAYER(RGB_MATRIX_PROGRAM_OP_COUNT, 0, 0, 0, 0, 0)};
+    EXPECT_FALSE(rgb_matrix_program_validate(bad_op, sizeof(bad_op), nullptr));
+
+    uint8_t bad_source[] = {RGB_MATRIX_PROGRAM_VERSION, 1, LAYER(RGB_MATRIX_PROGRAM_OP_ADD, 0, RGB_MATRIX_PROGRAM_SRC_COUNT, 0, 0, 0)};
+    EXPECT_FALSE(rgb_matrix_program_validate(bad_source, sizeof(bad_source), nullptr));
+
+    uint8_t bad_channel[] = {RGB_MATRIX_PROGRAM_VERSION, 1, LAYER(RGB_MATRIX_PROGRAM_OP_WAVE, 0, 3 << 4, 0, 0, 0)};
+    EXPECT_FALSE(rgb_matrix_program_validate(bad_channel, sizeof(bad_channel), nullptr));
+
+    uint8_t too_many[RGB_MATRIX_PROGRAM_SIZE + RGB_MATRIX_PROGRAM_LAYER_SIZE] = {RGB_MATRIX_PROGRAM_VERSION, RGB_MATRIX_PROGRAM_MAX_LAYERS + 1};
+    EXPECT_FALSE(rgb_matrix_program_validate(too_many, sizeof(too_many), nullptr));
+
+    // Blank EEPROM
+    uint8_t blank[RGB_MATRIX_PROGRAM_SIZE];
+    memset(blank, 0xFF, sizeof(blank));
+    EXPECT_FALSE(rgb_matrix_program_validate(blank, sizeof(blank), nullptr));
+}
+
+TEST_F(RgbMatrixProgramTest, EnforcesCostBound) {
+    uint8_t cost = 0;
+    uint8_t two_splashes[] = {
+        RGB_MATRIX_PROGRAM_VERSION,
+        3,
+        LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_SPLASH, 0, PHASE(VAL, NONE), 4, 0, 255),
+        LAYER(RGB_MATRIX_PROGRAM_OP_SPLASH, 0, PHASE(HUE, NONE), 4, 0, 255),
+    };
+    EXPECT_TRUE(rgb_matrix_program_validate(two_splashes, sizeof(two_splashes), &cost));
+    EXPECT_EQ(cost, 1 + 2 * (1 + RGB_MATRIX_PROGRAM_MAX_HITS));
+
+    uint8_t three_splashes[] = {
+        RGB_MATRIX_PROGRAM_VERSION,
+        3,
+        LAYER(RGB_MATRIX_PROGRAM_OP_SPLASH, 0, PHASE(VAL, NONE), 4, 0, 255),
+        LAYER(RGB_MATRIX_PROGRAM_OP_SPLASH, 0, PHASE(SAT, NONE), 4, 0, 255),
+        LAYER(RGB_MATRIX_PROGRAM_OP_SPLASH, 0, PHASE(HUE, NONE), 4, 0, 255),
+    };
+    EXPECT_FALSE(rgb_matrix_program_validate(three_splashes, sizeof(three_splashes), &cost));
+}
+
+TEST_F(RgbMatrixProgramTest, RejectedProgramKeepsActiveOne) {
+    ASSERT_TRUE(load({LAYER(RGB_MATRIX_PROGRAM_OP_FILL, 0, 1, 2, 3, 0)}));
+    EXPECT_FALSE(load({LAYER(0x7F, 0, 0, 0, 0, 0)}));
+
+    hsv_t hsv = eval(0, 0);
+    EXPECT_EQ(hsv.h, 1);
+    EXPECT_EQ(hsv.s, 2);
+    EXPECT_EQ(hsv.v, 3);
+}
+
+TEST_F(RgbMatrixProgramTest, LayerFlagsMaskLeds) {
+    ASSERT_TRUE(load({
+        LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_FILL, 0x02, 0, 0, 0, 0),
+    }));
+
+    EXPECT_EQ(eval(0, 0, 0x01).v, 200);
+    EXPECT_EQ(eval(0, 0, 0x02).v, 0);
+    EXPECT_EQ(eval(0, 0, 0x03).v, 0);
+}
+
+TEST_F(RgbMatrixProgramTest, AddSaturatesValue) {
+    ASSERT_TRUE(load({
+        LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_ADD, 0, PHASE(VAL, Y), 100, -16, 0),
+    }));
+
+    EXPECT_EQ(eval(0, 0).v, 255);
+    EXPECT_EQ(eval(0, 100).v, 200);
+    EXPECT_EQ(eval(0, 255).v, 45);
+
+    ASSERT_TRUE(load({
+        LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_ADD, 0, PHASE(SAT, NONE), -128, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_ADD, 0, PHASE(SAT, NONE), -128, 0, 0),
+    }));
+    EXPECT_EQ(eval(0, 0).s, 0);
+}
+
+TEST_F(RgbMatrixProgramTest, WaveModulatesChannel) {
+    ASSERT_TRUE(load({
+        LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_WAVE, 0, PHASE(VAL, NONE), 64, 0, 1),
+    }));
+
+    // sin8() peaks at 64 and bottoms out at 192
+    EXPECT_GE(eval(0, 0).v, 198);
+    frame.time = 128;
+    EXPECT_LE(eval(0, 0).v, 2);
+}
+
+TEST_F(RgbMatrixProgramTest, SplashFadesWithDistanceAndTime) {
+    ASSERT_TRUE(load({
+        LAYER(RGB_MATRIX_PROGRAM_OP_FILL, 0, 0, 255, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_SPLASH, 0, PHASE(VAL, NONE), 16, 255, 255),
+    }));
+
+    uint8_t  hit_x[]    = {100};
+    uint8_t  hit_y[]    = {30};
+    uint16_t hit_tick[] = {0};
+    frame.hit_count     = 1;
+    frame.hit_x         = hit_x;
+    frame.hit_y         = hit_y;
+    frame.hit_tick      = hit_tick;
+
+    EXPECT_GE(eval(100, 30).v, 254);
+    EXPECT_GT(eval(110, 30).v, eval(130, 30).v);
+    EXPECT_EQ(eval(0, 30).v, 0);
+
+    hit_tick[0] = 200;
+    EXPECT_LT(eval(100, 30).v, 100);
+    hit_tick[0] = 10000;
+    EXPECT_EQ(eval(100, 30).v, 0);
+
+    // No hits, no splash
+    frame.hit_count = 0;
+    EXPECT_EQ(eval(100, 30).v, 0);
+}
+
+TEST_F(RgbMatrixProgramTest, PolarSourcesAreReported) {
+    EXPECT_FALSE(rgb_matrix_program_uses_polar());
+
+    ASSERT_TRUE(load({
+        LAYER(RGB_MATRIX_PROGRAM_OP_BASE, 0, 0, 0, 0, 0),
+        LAYER(RGB_MATRIX_PROGRAM_OP_ADD, 0, PHASE(HUE, ANGLE), 0, 16, 0),
+    }));
+    EXPECT_TRUE(rgb_matrix_program_uses_polar());
+
+    rgb_matrix_program_led_t led = {0, 0x01, 0, 0, 90, 0};
+    EXPECT_EQ(rgb_matrix_program_eval(&frame, &led).h, 100);
+}
@@ -0,0 +1,260 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "rgb_matrix_stream.h"
+#include "rgb_matrix_stream_encoder.h"
+}
+
+typedef std::vector<uint8_t> report_t;
+
+static void collect(const uint8_t *report, uint8_t length, void *context) {
+    static_cast<std::vector<report_t> *>(context)->push_back(report_t(report, report + length));
+}
+
+class RgbMatrixStreamTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        rgb_matrix_stream_reset();
+        start(32, 0);
+    }
+
+    void start(uint8_t report_size, uint8_t keyframe_interval) {
+        rgb_matrix_stream_encoder_init(&encoder, RGB_MATRIX_LED_COUNT, report_size, keyframe_interval);
+    }
+
+    std::vector<report_t> encode(const uint16_t *colors) {
+        std::vector<report_t> reports;
+        rgb_matrix_stream_encode(&encoder, colors, collect, &reports);
+        return reports;
+    }
+
+    void deliver(std::vector<report_t> reports) {
+        for (auto &report : reports) {
+            EXPECT_FALSE(rgb_matrix_stream_receive(report.data(), report.size()));
+        }
+    }
+
+    // Ask the keyboard for its status and pass the reply to the encoder
+    report_t poll() {
+        report_t report(encoder.report_size);
+        rgb_matrix_stream_encoder_status_request(&encoder, report.data());
+        EXPECT_TRUE(rgb_matrix_stream_receive(report.data(), report.size()));
+        rgb_matrix_stream_encoder_status_reply(&encoder, report.data(), report.size());
+        return report;
+    }
+
+    bool shown(const uint16_t *colors) {
+        const uint16_t *frame = rgb_matrix_stream_frame();
+        return frame && memcmp(frame, colors, RGB_MATRIX_LED_COUNT * sizeof(uint16_t)) == 0;
+    }
+
+    void fill_rainbow(uint16_t *colors, uint8_t offset) {
+        for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+            uint8_t v = (i + offset) * 7;
+            colors[i] = RGB_MATRIX_STREAM_RGB565_OF(v, 255 - v, v / 2);
+        }
+    }
+
+    rgb_matrix_stream_encoder_t encoder;
+};
+
+TEST_F(RgbMatrixStreamTest, ColourConversion) {
+    rgb_t rgb = rgb_matrix_stream_to_rgb(RGB_MATRIX_STREAM_RGB565_OF(255, 128, 0));
+    EXPECT_EQ(rgb.r, 255);
+    EXPECT_EQ(rgb.g, 130);
+    EXPECT_EQ(rgb.b, 0);
+}
+
+TEST_F(RgbMatrixStreamTest, NoFrameUntilKeyframe) {
+    EXPECT_EQ(rgb_matrix_stream_frame(), nullptr);
+
+    report_t status = poll();
+    EXPECT_EQ(status[3], RGB_MATRIX_STREAM_KEYFRAME_NEEDED);
+    EXPECT_EQ(status[4], RGB_MATRIX_LED_COUNT);
+}
+
+TEST_F(RgbMatrixStreamTest, KeyframeRoundTrip) {
+    uint16_t colors[RGB_MATRIX_LED_COUNT];
+    fill_rainbow(colors, 0);
+
+    auto reports = encode(colors);
+    // 12 RGB565 LEDs fit in a 32 byte report
+    EXPECT_EQ(reports.size(), (RGB_MATRIX_LED_COUNT + 11) / 12);
+    EXPECT_EQ(reports[0][1], RGB_MATRIX_STREAM_KEYFRAME);
+
+    deliver(reports);
+    EXPECT_TRUE(shown(colors));
+    EXPECT_EQ(rgb_matrix_stream_get_stats().frames, 1);
+    EXPECT_EQ(poll()[3], RGB_MATRIX_STREAM_HAS_FRAME);
+}
+
+TEST_F(RgbMatrixStreamTest, PaletteKeyframe) {
+    uint16_t colors[RGB_MATRIX_LED_COUNT];
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        colors[i] = RGB_MATRIX_STREAM_RGB565_OF(i % 4 * 60, 0, 255);
+    }
+
+    auto reports = encode(colors);
+    EXPECT_EQ(encoder.palette_size, 4);
+    EXPECT_LE(reports.size(), 3);
+
+    deliver(reports);
+    EXPECT_TRUE(shown(colors));
+}
+
+TEST_F(RgbMatrixStreamTest, LargerReportsNeedFewerParts) {
+    uint16_t colors[RGB_MATRIX_LED_COUNT];
+    fill_rainbow(colors, 0);
+
+    start(64, 0);
+    auto reports = encode(colors);
+    EXPECT_EQ(reports.size(), (RGB_MATRIX_LED_COUNT + 28) / 29);
+
+    deliver(reports);
+    EXPECT_TRUE(shown(colors));
+}
+
+TEST_F(RgbMatrixStreamTest, DeltaSendsOnlyChanges) {
+    uint16_t colors[RGB_MATRIX_LED_COUNT];
+    fill_rainbow(colors, 0);
+    deliver(encode(colors));
+
+    EXPECT_TRUE(encode(colors).empty());
+
+    colors[3]   = 0xFFFF;
+    colors[5]   = 0x1234;
+    colors[100] = 0;
+    auto reports = encode(colors);
+    ASSERT_EQ(reports.size(), 1);
+    EXPECT_EQ(reports[0][1], RGB_MATRIX_STREAM_DELTA);
+    EXPECT_EQ(reports[0][3], reports[0][2] - 1);
+
+    deliver(reports);
+    EXPECT_TRUE(shown(colors));
+    EXPECT_EQ(rgb_matrix_stream_get_stats().frames, 2);
+}
+
+TEST_F(RgbMatrixStreamTest, FrameSwappedOnlyWhenComplete) {
+    uint16_t first[RGB_MATRIX_LED_COUNT], second[RGB_MATRIX_LED_COUNT];
+    fill_rainbow(first, 0);
+    fill_rainbow(second, 1);
+    deliver(encode(first));
+
+    auto reports = encode(second);
+    ASSERT_GT(reports.size(), 1);
+    report_t last = reports.back();
+    reports.pop_back();
+
+    deliver(reports);
+    EXPECT_TRUE(shown(first));
+    deliver({last});
+    EXPECT_TRUE(shown(second));
+}
+
+TEST_F(RgbMatrixStreamTest, DuplicateAndMalformedPacketsAreIgnored) {
+    uint16_t colors[RGB_MATRIX_LED_COUNT];
+    fill_rainbow(colors, 0);
+    auto reports = encode(colors);
+
+    // A run past the last LED
+    report_t bad = reports[1];
+    bad[6]       = RGB_MATRIX_LED_COUNT - 1;
+    deliver({reports[0], reports[0], bad});
+    EXPECT_EQ(rgb_matrix_stream_frame(), nullptr);
+
+    deliver(reports);
+    deliver(reports);
+    EXPECT_TRUE(shown(colors));
+    EXPECT_EQ(rgb_matrix_stream_get_stats().frames, 1);
+    EXPECT_EQ(rgb_matrix_stream_get_stats().dropped, 0);
+}
+
+TEST_F(RgbMatrixStreamTest, LostPacketRecoversWithKeyframe) {
+    uint16_t colors[RGB_MATRIX_LED_COUNT];
+    fill_rainbow(colors, 0);
+    deliver(encode(colors));
+
+    // Lose one of two parts of a delta
+    fill_rainbow(colors, 1);
+    auto reports = encode(colors);
+    ASSERT_GT(reports.size(), 1);
+    reports.erase(reports.begin());
+    deliver(reports);
+
+    // The next delta is based on the lost frame
+    colors[0] = 0;
+    deliver(encode(colors));
+    EXPECT_FALSE(shown(colors));
+    EXPECT_EQ(rgb_matrix_stream_get_stats().dropped, 1);
+    EXPECT_EQ(rgb_matrix_stream_get_stats().rejected, 1);
+
+    EXPECT_TRUE(poll()[3] & RGB_MATRIX_STREAM_KEYFRAME_NEEDED);
+    colors[1] = 0;
+    reports   = encode(colors);
+    EXPECT_EQ(reports[0][1], RGB_MATRIX_STREAM_KEYFRAME);
+    deliver(reports);
+    EXPECT_TRUE(shown(colors));
+    EXPECT_EQ(poll()[3], RGB_MATRIX_STREAM_HAS_FRAME);
+}
+
+TEST_F(RgbMatrixStreamTest, RandomPacketLoss) {
+    static const int frames = 500;
+    std::vector<std::vector<uint16_t>> sent(256);
+    uint32_t seed = 1;
+    auto random = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7FFF;
+    };
+
+    start(32, 30);
+    uint16_t colors[RGB_MATRIX_LED_COUNT];
+    fill_rainbow(colors, 0);
+
+    for (int n = 0; n < frames; n++) {
+        // A few moving LEDs and the occasional full change
+        for (uint8_t j = 0; j < 5; j++) {
+            colors[random() % RGB_MATRIX_LED_COUNT] = random();
+        }
+        if (n % 97 == 0) {
+            fill_rainbow(colors, n);
+        }
+
+        uint8_t frame   = encoder.frame;
+        auto    reports = encode(colors);
+        if (reports.empty()) {
+            continue;
+        }
+        sent[frame].assign(colors, colors + RGB_MATRIX_LED_COUNT);
+
+        for (auto &report : reports) {
+            if (random() % 100 >= 10) {
+                rgb_matrix_stream_receive(report.data(), report.size());
+            }
+        }
+
+        // Whatever is shown has to be exactly a frame that was sent
+        report_t status = poll();
+        if (status[3] & RGB_MATRIX_STREAM_HAS_FRAME) {
+            ASSERT_TRUE(shown(sent[status[2]].data())) << "frame " << n;
+        }
+    }
+
+    rgb_matrix_stream_stats_t stats = rgb_matrix_stream_get_stats();
+    EXPECT_GT(stats.frames, 0);
+    EXPECT_GT(stats.dropped, 0);
+    EXPECT_GT(stats.rejected, 0);
+
+    // Without loss the stream catches up with the host
+    for (int n = 0; n < 2; n++) {
+        colors[0] ^= 1;
+        deliver(encode(colors));
+        poll();
+    }
+    EXPECT_TRUE(shown(colors));
+}
@@ -0,0 +1,17 @@
+rgb_matrix_program_SRC := \
+    $(QUANTUM_PATH)/rgb_matrix/tests/rgb_matrix_program_tests.cpp \
+    $(QUANTUM_PATH)/rgb_matrix/rgb_matrix_program.c \
+    $(LIB_PATH)/lib8tion/lib8tion.c
+
+rgb_matrix_program_INC := \
+    $(QUANTUM_PATH)/rgb_matrix
+
+rgb_matrix_stream_DEFS := -DRGB_MATRIX_LED_COUNT=120
+
+rgb_matrix_stream_SRC := \
+    $(QUANTUM_PATH)/rgb_matrix/tests/rgb_matrix_stream_tests.cpp \
+    $(QUANTUM_PATH)/rgb_matrix/rgb_matrix_stream.c \
+    $(QUANTUM_PATH)/rgb_matrix/rgb_matrix_stream_encoder.c
+
+rgb_matrix_stream_INC := \
+    $(QUANTUM_PATH)/rgb_matrix
@@ -0,0 +1,2 @@
+TEST_LIST += rgb_matrix_program
+TEST_LIST += rgb_matrix_stream
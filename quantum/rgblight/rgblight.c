@@ -121,9 +121,29 @@ static bool deferred_set_layer_state = false;
 
 rgblight_ranges_t rgblight_ranges = {0, RGBLIGHT_LED_COUNT, 0, RGBLIGHT_LED_COUNT, RGBLIGHT_LED_COUNT};
 
+// Staging buffer the effects render into. Animation steps push only the
+// span that changed since the last flush, and do not flush unchanged frames
+// at all. Any other rgblight_set() call pushes and flushes the whole frame.
+static rgb_t   rgblight_frame[RGBLIGHT_LED_COUNT];
+static uint8_t rgblight_dirty_start = 0;
+static uint8_t rgblight_dirty_end   = RGBLIGHT_LED_COUNT;
+static bool    rgblight_animating   = false;
+
+#ifdef RGBLIGHT_ANIMATION_STATS
+static uint16_t rgblight_flush_count  = 0;
+static uint16_t rgblight_pushed_count = 0;
+#endif
+
+static void rgblight_mark_all_dirty(void) {
+    rgblight_dirty_start = 0;
+    rgblight_dirty_end   = RGBLIGHT_LED_COUNT;
+}
+
 void rgblight_set_clipping_range(uint8_t start_pos, uint8_t num_leds) {
     rgblight_ranges.clipping_start_pos = start_pos;
     rgblight_ranges.clipping_num_leds  = num_leds;
+    // Every LED now maps to a different driver index
+    rgblight_mark_all_dirty();
 }
 
 void rgblight_set_effect_range(uint8_t start_pos, uint8_t num_leds) {
@@ -135,7 +155,11 @@ void rgblight_set_effect_range(uint8_t start_pos, uint8_t num_leds) {
 }
 
 __attribute__((weak)) rgb_t rgblight_hsv_to_rgb(hsv_t hsv) {
+#ifdef RGBLIGHT_HSV_TO_RGB_CACHE
+    return hsv_to_rgb_cached(hsv);
+#else
     return hsv_to_rgb(hsv);
+#endif
 }
 
 uint8_t rgblight_led_index(uint8_t index) {
@@ -147,7 +171,20 @@ uint8_t rgblight_led_index(uint8_t index) {
 }
 
 void setrgb(uint8_t r, uint8_t g, uint8_t b, int index) {
-    rgblight_driver.set_color(rgblight_led_index(index), r, g, b);
+    if (index < 0 || index >= RGBLIGHT_LED_COUNT) {
+        return;
+    }
+
+    rgb_t *led = &rgblight_frame[index];
+    if (led->r == r && led->g == g && led->b == b) {
+        return;
+    }
+    led->r = r;
+    led->g = g;
+    led->b = b;
+
+    if (index < rgblight_dirty_start) rgblight_dirty_start = index;
+    if (index >= rgblight_dirty_end) rgblight_dirty_end = index + 1;
 }
 
 void sethsv_raw(uint8_t hue, uint8_t sat, uint8_t val, int index) {
@@ -628,7 +665,7 @@ void rgblight_setrgb(uint8_t r, uint8_t g, uint8_t b) {
     }
 
     for (uint8_t i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
-        rgblight_driver.set_color(rgblight_led_index(i), r, g, b);
+        setrgb(r, g, b, i);
     }
     rgblight_set();
 }
@@ -638,7 +675,7 @@ void rgblight_setrgb_at(uint8_t r, uint8_t g, uint8_t b, uint8_t index) {
         return;
     }
 
-    rgblight_driver.set_color(rgblight_led_index(index), r, g, b);
+    setrgb(r, g, b, index);
     rgblight_set();
 }
 
@@ -669,7 +706,7 @@ void rgblight_setrgb_range(uint8_t r, uint8_t g, uint8_t b, uint8_t start, uint8
     }
 
     for (uint8_t i = start; i < end; i++) {
-        rgblight_driver.set_color(rgblight_led_index(i), r, g, b);
+        setrgb(r, g, b, i);
     }
     rgblight_set();
 }
@@ -861,7 +898,7 @@ void rgblight_wakeup(void) {
 void rgblight_set(void) {
     if (!rgblight_config.enable) {
         for (uint8_t i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
-            rgblight_driver.set_color(rgblight_led_index(i), 0, 0, 0);
+            setrgb(0, 0, 0, i);
         }
     }
 
@@ -877,6 +914,24 @@ void rgblight_set(void) {
     }
 #endif
 
+    if (!rgblight_animating) {
+        // Callers may have written to the driver directly, or want the
+        // frame sent again
+        rgblight_mark_all_dirty();
+    } else if (rgblight_dirty_start >= rgblight_dirty_end) {
+        return;
+    }
+
+    for (uint8_t i = rgblight_dirty_start; i < rgblight_dirty_end; i++) {
+        rgblight_driver.set_color(rgblight_led_index(i), rgblight_frame[i].r, rgblight_frame[i].g, rgblight_frame[i].b);
+    }
+#ifdef RGBLIGHT_ANIMATION_STATS
+    rgblight_flush_count++;
+    rgblight_pushed_count += rgblight_dirty_end - rgblight_dirty_start;
+#endif
+    rgblight_dirty_start = RGBLIGHT_LED_COUNT;
+    rgblight_dirty_end   = 0;
+
     rgblight_driver.flush();
 }
 
@@ -962,6 +1017,22 @@ void rgblight_timer_toggle(void) {
     }
 }
 
+#    ifdef RGBLIGHT_ANIMATION_STATS
+static rgblight_animation_stats_t animation_stats[RGBLIGHT_MODE_last];
+
+bool rgblight_get_animation_stats(uint8_t mode, rgblight_animation_stats_t *stats) {
+    if (mode >= RGBLIGHT_MODE_last) {
+        return false;
+    }
+    *stats = animation_stats[mode];
+    return true;
+}
+
+void rgblight_reset_animation_stats(void) {
+    memset(animation_stats, 0, sizeof(animation_stats));
+}
+#    endif
+
 void rgblight_show_solid_color(uint8_t r, uint8_t g, uint8_t b) {
     rgblight_enable();
     rgblight_mode(RGBLIGHT_MODE_STATIC_LIGHT);
@@ -1073,7 +1144,21 @@ void rgblight_timer_task(void) {
             oldpos16 = animation_status.pos16;
 #    endif
             animation_status.last_timer += interval_time;
+#    ifdef RGBLIGHT_ANIMATION_STATS
+            uint16_t flushes = rgblight_flush_count;
+            uint16_t pushed  = rgblight_pushed_count;
+#    endif
+            rgblight_animating = true;
             effect_func(&animation_status);
+            rgblight_animating = false;
+#    ifdef RGBLIGHT_ANIMATION_STATS
+            if (rgblight_config.mode < RGBLIGHT_MODE_last) {
+                rgblight_animation_stats_t *stats = &animation_stats[rgblight_config.mode];
+                stats->steps++;
+                stats->flushes += (uint16_t)(rgblight_flush_count - flushes);
+                stats->leds += (uint16_t)(rgblight_pushed_count - pushed);
+            }
+#    endif
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
             if (animation_status.pos16 == 0 && oldpos16 != 0) {
                 tick_flag = true;
@@ -1198,7 +1283,7 @@ void rgblight_effect_snake(animation_status_t *anim) {
 #    endif
 
     for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        rgblight_driver.set_color(rgblight_led_index(i + rgblight_ranges.effect_start_pos), 0, 0, 0);
+        setrgb(0, 0, 0, i + rgblight_ranges.effect_start_pos);
 
         for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
             k = pos + j * increment;
@@ -1254,7 +1339,7 @@ void rgblight_effect_knight(animation_status_t *anim) {
 #    endif
     // Set all the LEDs to 0
     for (i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
-        rgblight_driver.set_color(rgblight_led_index(i), 0, 0, 0);
+        setrgb(0, 0, 0, i);
     }
     // Determine which LEDs should be lit up
     for (i = 0; i < RGBLIGHT_EFFECT_KNIGHT_LED_NUM; i++) {
@@ -1263,7 +1348,7 @@ void rgblight_effect_knight(animation_status_t *anim) {
         if (i >= low_bound && i <= high_bound) {
             sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, cur);
         } else {
-            rgblight_driver.set_color(rgblight_led_index(cur), 0, 0, 0);
+            setrgb(0, 0, 0, cur);
         }
     }
     rgblight_set();
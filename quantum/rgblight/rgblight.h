@@ -442,6 +442,17 @@ void rgblight_effect_rgbtest(animation_status_t *anim);
 void rgblight_effect_alternating(animation_status_t *anim);
 void rgblight_effect_twinkle(animation_status_t *anim);
 
+#    ifdef RGBLIGHT_ANIMATION_STATS
+typedef struct {
+    uint32_t steps;   // animation steps run
+    uint32_t flushes; // steps which changed at least one LED and flushed the driver
+    uint32_t leds;    // LEDs pushed to the driver by those steps
+} rgblight_animation_stats_t;
+
+bool rgblight_get_animation_stats(uint8_t mode, rgblight_animation_stats_t *stats);
+void rgblight_reset_animation_stats(void);
+#    endif
+
 #endif
 
 #ifdef VELOCIKEY_ENABLE
@@ -17,6 +17,7 @@
 #include "unicode.h"
 
 #include "eeconfig.h"
+#include "timer.h"
 #include "action.h"
 #include "action_util.h"
 #include "host.h"
@@ -62,10 +63,38 @@
 #    define UNICODE_TYPE_DELAY 10
 #endif
 
+#ifdef UNICODE_QUEUE_ENABLE
+// Number of code points waiting to be typed
+#    ifndef UNICODE_QUEUE_SIZE
+#        define UNICODE_QUEUE_SIZE 16
+#    endif
+// Minimum time between two reports sent from the queue, in ms
+#    ifndef UNICODE_QUEUE_INTERVAL
+#        define UNICODE_QUEUE_INTERVAL 1
+#    endif
+#endif
+
+// Enough hex digits for a surrogate pair
+#define UNICODE_MAX_DIGITS 16
+
 unicode_config_t unicode_config;
 uint8_t          unicode_saved_mods;
 led_t            unicode_saved_led_state;
 
+#ifdef UNICODE_QUEUE_ENABLE
+static uint32_t unicode_queue[UNICODE_QUEUE_SIZE];
+static uint8_t  unicode_queue_head  = 0;
+static uint8_t  unicode_queue_count = 0;
+
+// The keys of the code point being typed, from the queue
+static uint16_t unicode_queue_keys[UNICODE_MAX_DIGITS];
+static uint8_t  unicode_queue_key_count = 0;
+static uint8_t  unicode_queue_key_pos   = 0;
+static bool     unicode_queue_key_down  = false;
+static bool     unicode_queue_started   = false;
+static uint16_t unicode_queue_next      = 0;
+#endif
+
 #if UNICODE_SELECTED_MODES != -1
 static uint8_t selected[]     = {UNICODE_SELECTED_MODES};
 static int8_t  selected_count = ARRAY_SIZE(selected);
@@ -250,6 +279,12 @@ __attribute__((weak)) void unicode_input_start(void) {
             break;
     }
 
+#ifdef UNICODE_QUEUE_ENABLE
+    // The queue waits out the delay with a timer instead
+    if (unicode_queue_started) {
+        return;
+    }
+#endif
     wait_ms(UNICODE_TYPE_DELAY);
 }
 
@@ -309,14 +344,32 @@ __attribute__((weak)) void unicode_input_cancel(void) {
     set_mods(unicode_saved_mods); // Reregister previously set mods
 }
 
+static bool ascii_lut_bit(const uint8_t *lut, char ascii_code) {
+    return (pgm_read_byte(&lut[(uint8_t)ascii_code / 8]) >> ((uint8_t)ascii_code % 8)) & 0x01;
+}
+
 // clang-format off
 
+static uint16_t nibble_keycode(uint8_t digit) {
+    if (unicode_config.input_mode == UNICODE_MODE_WINDOWS) {
+        return digit < 10
+             ? KC_KP_1 + (10 + digit - 1) % 10
+             : KC_A + (digit - 10);
+    }
+    char ascii_code = digit < 10 ? '0' + digit : 'a' + (digit - 10);
+    uint16_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    if (ascii_lut_bit(ascii_to_shift_lut, ascii_code)) {
+        keycode = LSFT(keycode);
+    }
+    if (ascii_lut_bit(ascii_to_altgr_lut, ascii_code)) {
+        keycode = RALT(keycode);
+    }
+    return keycode;
+}
+
 static void send_nibble_wrapper(uint8_t digit) {
     if (unicode_config.input_mode == UNICODE_MODE_WINDOWS) {
-        uint8_t kc = digit < 10
-                   ? KC_KP_1 + (10 + digit - 1) % 10
-                   : KC_A + (digit - 10);
-        tap_code(kc);
+        tap_code(nibble_keycode(digit));
         return;
     }
     send_nibble(digit);
@@ -324,16 +377,15 @@ static void send_nibble_wrapper(uint8_t digit) {
 
 // clang-format on
 
-void register_hex(uint16_t hex) {
-    for (int i = 3; i >= 0; i--) {
-        uint8_t digit = ((hex >> (i * 4)) & 0xF);
-        send_nibble_wrapper(digit);
-    }
-}
-
-void register_hex32(uint32_t hex) {
-    bool first_digit        = true;
-    bool needs_leading_zero = (unicode_config.input_mode == UNICODE_MODE_WINCOMPOSE);
+/**
+ * \brief Split a number into the hex digits to type for it.
+ *
+ * \return The number of digits, at most 9.
+ */
+static uint8_t hex32_digits(uint32_t hex, uint8_t *digits) {
+    uint8_t count              = 0;
+    bool    first_digit        = true;
+    bool    needs_leading_zero = (unicode_config.input_mode == UNICODE_MODE_WINCOMPOSE);
     for (int i = 7; i >= 0; i--) {
         // Work out the digit we're going to transmit
         uint8_t digit = ((hex >> (i * 4)) & 0xF);
@@ -341,7 +393,7 @@ void register_hex32(uint32_t hex) {
         // If we're still searching for the first digit, and found one
         // that needs a leading zero sent out, send the zero.
         if (first_digit && needs_leading_zero && digit > 9) {
-            send_nibble_wrapper(0);
+            digits[count++] = 0;
         }
 
         // Always send digits (including zero) if we're down to the last
@@ -350,30 +402,143 @@ void register_hex32(uint32_t hex) {
 
         // If we've found a digit worth transmitting, do so.
         if (digit != 0 || !first_digit || must_send) {
-            send_nibble_wrapper(digit);
-            first_digit = false;
+            digits[count++] = digit;
+            first_digit     = false;
         }
     }
+    return count;
 }
 
-void register_unicode(uint32_t code_point) {
+/**
+ * \brief Split a code point into the hex digits to type for it in the current
+ * input mode, or return 0 if it cannot be typed.
+ */
+static uint8_t code_point_digits(uint32_t code_point, uint8_t *digits) {
     if (code_point > 0x10FFFF || (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_WINDOWS)) {
         // Code point out of range, do nothing
-        return;
+        return 0;
     }
 
-    unicode_input_start();
     if (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_MACOS) {
         // Convert code point to UTF-16 surrogate pair on macOS
         code_point -= 0x10000;
         uint32_t lo = code_point & 0x3FF, hi = (code_point & 0xFFC00) >> 10;
-        register_hex32(hi + 0xD800);
-        register_hex32(lo + 0xDC00);
-    } else {
-        register_hex32(code_point);
+        uint8_t  count = hex32_digits(hi + 0xD800, digits);
+        return count + hex32_digits(lo + 0xDC00, digits + count);
+    }
+    return hex32_digits(code_point, digits);
+}
+
+void register_hex(uint16_t hex) {
+    for (int i = 3; i >= 0; i--) {
+        uint8_t digit = ((hex >> (i * 4)) & 0xF);
+        send_nibble_wrapper(digit);
+    }
+}
+
+void register_hex32(uint32_t hex) {
+    uint8_t digits[UNICODE_MAX_DIGITS];
+    uint8_t count = hex32_digits(hex, digits);
+    for (uint8_t i = 0; i < count; i++) {
+        send_nibble_wrapper(digits[i]);
+    }
+}
+
+#ifdef UNICODE_QUEUE_ENABLE
+/**
+ * \brief Send the next report of the queue, with at most one report per
+ * interval so that each lands in its own USB frame.
+ */
+static void unicode_queue_step(void) {
+    unicode_queue_next = timer_read() + UNICODE_QUEUE_INTERVAL;
+
+    if (unicode_queue_key_down) {
+        unregister_code16(unicode_queue_keys[unicode_queue_key_pos++]);
+        unicode_queue_key_down = false;
+        return;
+    }
+    if (unicode_queue_key_pos < unicode_queue_key_count) {
+        register_code16(unicode_queue_keys[unicode_queue_key_pos]);
+        unicode_queue_key_down = true;
+        return;
+    }
+    if (unicode_queue_key_count > 0) {
+        unicode_queue_key_count = 0;
+        // macOS keeps typing code points while Option is held, so the
+        // following ones are sent in the same input sequence
+        if (unicode_queue_count == 0 || unicode_config.input_mode != UNICODE_MODE_MACOS) {
+            unicode_input_finish();
+            unicode_queue_started = false;
+        }
+        return;
+    }
+    if (unicode_queue_count == 0) {
+        return;
+    }
+
+    uint8_t digits[UNICODE_MAX_DIGITS];
+    uint8_t count = code_point_digits(unicode_queue[unicode_queue_head], digits);
+    unicode_queue_head = (unicode_queue_head + 1) % UNICODE_QUEUE_SIZE;
+    unicode_queue_count--;
+
+    for (uint8_t i = 0; i < count; i++) {
+        unicode_queue_keys[i] = nibble_keycode(digits[i]);
+    }
+    unicode_queue_key_count = count;
+    unicode_queue_key_pos   = 0;
+
+    if (count > 0 && !unicode_queue_started) {
+        unicode_queue_started = true;
+        unicode_input_start();
+        unicode_queue_next = timer_read() + UNICODE_TYPE_DELAY;
+    }
+}
+
+bool unicode_queue_active(void) {
+    return unicode_queue_count > 0 || unicode_queue_key_count > 0 || unicode_queue_started;
+}
+
+void unicode_flush(void) {
+    while (unicode_queue_active()) {
+        uint16_t now = timer_read();
+        if (!timer_expired(now, unicode_queue_next)) {
+            wait_ms(TIMER_DIFF_16(unicode_queue_next, now));
+        }
+        unicode_queue_step();
+    }
+}
+
+void unicode_task(void) {
+    if (unicode_queue_active() && timer_expired(timer_read(), unicode_queue_next)) {
+        unicode_queue_step();
+    }
+}
+
+void register_unicode(uint32_t code_point) {
+    if (unicode_queue_count == UNICODE_QUEUE_SIZE) {
+        unicode_flush();
+    }
+    if (!unicode_queue_active()) {
+        unicode_queue_next = timer_read();
+    }
+    unicode_queue[(unicode_queue_head + unicode_queue_count) % UNICODE_QUEUE_SIZE] = code_point;
+    unicode_queue_count++;
+}
+#else
+void register_unicode(uint32_t code_point) {
+    uint8_t digits[UNICODE_MAX_DIGITS];
+    uint8_t count = code_point_digits(code_point, digits);
+    if (count == 0) {
+        return;
+    }
+
+    unicode_input_start();
+    for (uint8_t i = 0; i < count; i++) {
+        send_nibble_wrapper(digits[i]);
     }
     unicode_input_finish();
 }
+#endif
 
 void send_unicode_string(const char *str) {
     if (!str) {
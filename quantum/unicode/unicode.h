@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "compiler_support.h"
 #include "unicode_keycodes.h"
@@ -122,6 +123,8 @@ void register_hex32(uint32_t hex);
 /**
  * \brief Input a single Unicode character. A surrogate pair will be sent if required by the input mode.
  *
+ * With `UNICODE_QUEUE_ENABLE`, the character is queued and typed from `unicode_task()` instead.
+ *
  * \param code_point The code point of the character to send.
  */
 void register_unicode(uint32_t code_point);
@@ -133,4 +136,18 @@ void register_unicode(uint32_t code_point);
  */
 void send_unicode_string(const char *str);
 
+#ifdef UNICODE_QUEUE_ENABLE
+/**
+ * \brief Whether queued characters are still being typed.
+ */
+bool unicode_queue_active(void);
+
+/**
+ * \brief Type all queued characters before returning.
+ */
+void unicode_flush(void);
+
+void unicode_task(void);
+#endif
+
 /** \} */
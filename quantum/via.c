@@ -26,6 +26,7 @@
 #    pragma message "VIA_INSECURE is enabled - firmware is susceptible to keyloggers"
 #endif
 
+#include <string.h>
 #include "via.h"
 
 #include "raw_hid.h"
@@ -59,6 +60,7 @@
 
 #if defined(RGB_MATRIX_ENABLE)
 #    include "rgb_matrix.h"
+#    include "rgb_matrix_stream.h"
 #endif
 
 #if defined(LED_MATRIX_ENABLE)
@@ -128,6 +130,10 @@ void eeconfig_init_via(void) {
     dynamic_keymap_reset();
     // This resets the macros in EEPROM to nothing.
     dynamic_keymap_macro_reset();
+#if defined(RGB_MATRIX_ENABLE) && defined(ENABLE_RGB_MATRIX_PROGRAM)
+    // This resets the lighting program in EEPROM to what is in flash.
+    rgb_matrix_program_reset();
+#endif
     // Save the magic number last, in case saving was interrupted
     via_eeprom_set_valid(true);
 }
@@ -287,16 +293,11 @@ __attribute__((weak)) bool via_command_kb(uint8_t *data, uint8_t length) {
     return false;
 }
 
-void raw_hid_receive(uint8_t *data, uint8_t length) {
+// Runs a single command in place, leaving the response in data.
+void via_command(uint8_t *data, uint8_t length) {
     uint8_t *command_id   = &(data[0]);
     uint8_t *command_data = &(data[1]);
 
-    // If via_command_kb() returns true, the command was fully
-    // handled, including calling raw_hid_send()
-    if (via_command_kb(data, length)) {
-        return;
-    }
-
     switch (*command_id) {
         case id_get_protocol_version: {
             command_data[0] = VIA_PROTOCOL_VERSION >> 8;
@@ -475,6 +476,92 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             break;
         }
     }
+}
+
+#ifdef VIA_BATCH_ENABLE
+// Raw HID reports are never longer than this, see usb_descriptor.h
+#    ifndef RAW_EPSIZE
+#        define RAW_EPSIZE 32
+#    endif
+
+// Runs every command of a VIA_BATCH_COMMAND report, and packs their
+// responses into as few reports as possible, see via.h for the layout.
+static void via_batch_receive(uint8_t *data, uint8_t length) {
+    uint8_t report[RAW_EPSIZE];
+    uint8_t command[RAW_EPSIZE];
+    uint8_t report_index = 0;
+
+    if (length > RAW_EPSIZE) {
+        length = RAW_EPSIZE;
+    }
+    uint8_t in           = VIA_BATCH_REQUEST_HEADER_SIZE;
+    uint8_t out          = VIA_BATCH_RESPONSE_HEADER_SIZE;
+
+    memset(report, 0, length);
+    report[0] = VIA_BATCH_COMMAND;
+    report[1] = data[1];
+
+    while (in + 2 <= length && data[in] != 0) {
+        uint8_t request_length  = data[in];
+        uint8_t response_length = data[in + 1];
+        in += 2;
+        if (request_length > length - in) {
+            // The host finds out from the missing responses
+            break;
+        }
+        if (response_length == 0) {
+            response_length = 1;
+        } else if (response_length > length - VIA_BATCH_RESPONSE_HEADER_SIZE - 1) {
+            response_length = length - VIA_BATCH_RESPONSE_HEADER_SIZE - 1;
+        }
+
+        // Commands expect a whole report, padded with zeros
+        memset(command, 0, length);
+        memcpy(command, &data[in], request_length);
+        in += request_length;
+        via_command(command, length);
+
+        if (out + 1 + response_length > length) {
+            report[2] = report_index++;
+            raw_hid_send(report, length);
+            memset(&report[VIA_BATCH_RESPONSE_HEADER_SIZE], 0, length - VIA_BATCH_RESPONSE_HEADER_SIZE);
+            out = VIA_BATCH_RESPONSE_HEADER_SIZE;
+        }
+        report[out++] = response_length;
+        memcpy(&report[out], command, response_length);
+        out += response_length;
+    }
+
+    report[2] = report_index | VIA_BATCH_LAST_REPORT;
+    raw_hid_send(report, length);
+}
+#endif
+
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    // If via_command_kb() returns true, the command was fully
+    // handled, including calling raw_hid_send()
+    if (via_command_kb(data, length)) {
+        return;
+    }
+
+#if defined(RGB_MATRIX_ENABLE) && defined(ENABLE_RGB_MATRIX_STREAM)
+    // Frames are not echoed back, to leave the bandwidth to the stream
+    if (data[0] == RGB_MATRIX_STREAM_COMMAND) {
+        if (rgb_matrix_stream_receive(data, length)) {
+            raw_hid_send(data, length);
+        }
+        return;
+    }
+#endif
+
+#ifdef VIA_BATCH_ENABLE
+    if (data[0] == VIA_BATCH_COMMAND) {
+        via_batch_receive(data, length);
+        return;
+    }
+#endif
+
+    via_command(data, length);
 
     // Return the same buffer, optionally with values changed
     // (i.e. returning state to the host, or the unhandled state).
@@ -654,6 +741,10 @@ void via_qmk_rgblight_save(void) {
 
 #if defined(RGB_MATRIX_ENABLE)
 
+#    ifdef ENABLE_RGB_MATRIX_PROGRAM
+static uint8_t via_rgb_matrix_program[RGB_MATRIX_PROGRAM_SIZE];
+#    endif
+
 void via_qmk_rgb_matrix_command(uint8_t *data, uint8_t length) {
     // data = [ command_id, channel_id, value_id, value_data ]
     uint8_t *command_id        = &(data[0]);
@@ -702,6 +793,23 @@ void via_qmk_rgb_matrix_get_value(uint8_t *data) {
             value_data[1] = rgb_matrix_get_sat();
             break;
         }
+#    ifdef ENABLE_RGB_MATRIX_PROGRAM
+        case id_qmk_rgb_matrix_program: {
+            // value_data = [ offset, size, program bytes ]
+            uint8_t offset = value_data[0];
+            uint8_t size   = value_data[1]; // size <= 27
+            if (size <= 27 && offset + size <= RGB_MATRIX_PROGRAM_SIZE) {
+                memcpy(&value_data[2], rgb_matrix_program_get() + offset, size);
+            }
+            break;
+        }
+        case id_qmk_rgb_matrix_program_load: {
+            value_data[0] = rgb_matrix_program_cost();
+            value_data[1] = RGB_MATRIX_PROGRAM_MAX_COST;
+            value_data[2] = RGB_MATRIX_PROGRAM_MAX_LAYERS;
+            break;
+        }
+#    endif
     }
 }
 
@@ -731,11 +839,35 @@ void via_qmk_rgb_matrix_set_value(uint8_t *data) {
             rgb_matrix_sethsv_noeeprom(value_data[0], value_data[1], rgb_matrix_get_val());
             break;
         }
+#    ifdef ENABLE_RGB_MATRIX_PROGRAM
+        case id_qmk_rgb_matrix_program: {
+            // value_data = [ offset, size, program bytes ]
+            // Bytes are staged until id_qmk_rgb_matrix_program_load
+            uint8_t offset = value_data[0];
+            uint8_t size   = value_data[1]; // size <= 27
+            if (size <= 27 && offset + size <= RGB_MATRIX_PROGRAM_SIZE) {
+                memcpy(&via_rgb_matrix_program[offset], &value_data[2], size);
+            }
+            break;
+        }
+        case id_qmk_rgb_matrix_program_load: {
+            // Reports the cost of the program, or 0xFF if it was rejected
+            if (rgb_matrix_program_load(via_rgb_matrix_program, sizeof(via_rgb_matrix_program))) {
+                value_data[0] = rgb_matrix_program_cost();
+            } else {
+                value_data[0] = 0xFF;
+            }
+            break;
+        }
+#    endif
     }
 }
 
 void via_qmk_rgb_matrix_save(void) {
     eeconfig_force_flush_rgb_matrix();
+#    ifdef ENABLE_RGB_MATRIX_PROGRAM
+    rgb_matrix_program_save();
+#    endif
 }
 
 #endif // RGB_MATRIX_ENABLE
@@ -37,6 +37,14 @@
 #    define VIA_EEPROM_CUSTOM_CONFIG_SIZE 0
 #endif
 
+// Space for an RGB Matrix lighting program uploaded through VIA
+#if defined(RGB_MATRIX_ENABLE) && defined(ENABLE_RGB_MATRIX_PROGRAM)
+#    include "rgb_matrix_program.h"
+#    define VIA_EEPROM_RGB_MATRIX_PROGRAM_SIZE RGB_MATRIX_PROGRAM_SIZE
+#else
+#    define VIA_EEPROM_RGB_MATRIX_PROGRAM_SIZE 0
+#endif
+
 // This is changed only when the command IDs change,
 // so VIA Configurator can detect compatible firmware.
 #define VIA_PROTOCOL_VERSION 0x000C
@@ -76,6 +84,50 @@ enum via_command_id {
     id_unhandled                            = 0xFF,
 };
 
+#ifdef VIA_BATCH_ENABLE
+/*
+ * Several commands packed into one report, answered by as many reports as
+ * their responses need. Each request starts with a header:
+ *
+ *   [0]  VIA_BATCH_COMMAND
+ *   [1]  sequence ID, chosen by the host
+ *
+ * followed by the commands, each one as
+ *
+ *   [n]      length of the command, 0 ends the list
+ *   [n + 1]  number of bytes of the response to send back
+ *   [n + 2]  the command, starting with its id_* command ID
+ *
+ * The commands are run in order, as if each had been sent on its own and
+ * padded with zeros. Every response report starts with a header:
+ *
+ *   [0]  VIA_BATCH_COMMAND
+ *   [1]  sequence ID of the request
+ *   [2]  index of the report within the response, VIA_BATCH_LAST_REPORT is
+ *        set on the last one
+ *
+ * followed by the responses, each one as its length, 0 ending the list, and
+ * the first bytes of the command buffer after the command was run. A
+ * response is at least 1 byte, the command ID or id_unhandled, and at most
+ * the report size minus 4 bytes. A truncated command ends the batch early. Since
+ * every request gets its own sequence ID, the host can send several without
+ * waiting for the responses in between. Firmware without batches answers a
+ * batch with id_unhandled, like any other unknown command.
+ *
+ * Batched commands only go through via_command(), never via_command_kb(), so
+ * keyboard-specific commands in a batch are answered with id_unhandled and
+ * the host has to send them on their own. Only define VIA_BATCH_ENABLE for a
+ * keyboard that overrides via_command_kb() if that is acceptable.
+ */
+#    ifndef VIA_BATCH_COMMAND
+#        define VIA_BATCH_COMMAND 0x81
+#    endif
+
+#    define VIA_BATCH_REQUEST_HEADER_SIZE 2
+#    define VIA_BATCH_RESPONSE_HEADER_SIZE 3
+#    define VIA_BATCH_LAST_REPORT 0x80
+#endif
+
 enum via_keyboard_value_id {
     id_uptime              = 0x01,
     id_layout_options      = 0x02,
@@ -110,6 +162,8 @@ enum via_qmk_rgb_matrix_value {
     id_qmk_rgb_matrix_effect       = 2,
     id_qmk_rgb_matrix_effect_speed = 3,
     id_qmk_rgb_matrix_color        = 4,
+    id_qmk_rgb_matrix_program      = 5,
+    id_qmk_rgb_matrix_program_load = 6,
 };
 
 enum via_qmk_led_matrix_value {
@@ -153,6 +207,10 @@ void via_set_device_indication(uint8_t value);
 // Called by QMK core to process VIA-specific keycodes.
 bool process_record_via(uint16_t keycode, keyrecord_t *record);
 
+// Runs a single command in place, leaving the response in data.
+// Does not call via_command_kb() or raw_hid_send().
+void via_command(uint8_t *data, uint8_t length);
+
 // These are made external so that keyboard level custom value handlers can use them.
 #if defined(BACKLIGHT_ENABLE)
 void via_qmk_backlight_command(uint8_t *data, uint8_t length);
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
+
 void virtser_init(void);
 
 /* Define this function in your code to process incoming bytes */
@@ -7,3 +10,17 @@ void virtser_recv(const uint8_t ch);
 
 /* Call this to send a character over the Virtual Serial Device */
 void virtser_send(const uint8_t byte);
+
+/* Call this to send several characters at once, in as few USB packets as possible */
+void virtser_send_buffer(const uint8_t *data, const uint8_t length);
+
+/* Returns true while a program on the host has the port open, output sent
+ * before then is not delivered */
+bool virtser_is_open(void);
+
+/* Returns true if `length` characters can be sent without waiting for the host */
+bool virtser_send_ready(const uint8_t length);
+
+/* Define this function in your code to send buffered output, it is called by
+ * virtser_task() right before the pending characters are flushed to the host */
+void virtser_send_pending(void);
@@ -0,0 +1,11 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define DYNAMIC_MACRO_PERSISTENT
+
+// The test EEPROM is tiny, keep clear of most of it
+#define DYNAMIC_MACRO_EEPROM_SIZE 16
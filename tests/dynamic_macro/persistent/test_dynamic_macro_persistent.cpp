@@ -0,0 +1,45 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "nvm_dynamic_macro.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class DynamicMacroPersistent : public TestFixture {};
+
+TEST_F(DynamicMacroPersistent, RecordingIsWrittenToNvm) {
+    TestDriver driver;
+    auto       a_key    = KeymapKey(0, 0, 0, KC_A);
+    auto       b_key    = KeymapKey(0, 1, 0, KC_B);
+    auto       rec2_key = KeymapKey(0, 4, 0, DM_REC2);
+    auto       rstp_key = KeymapKey(0, 7, 0, DM_RSTP);
+
+    set_keymap({a_key, b_key, rec2_key, rstp_key});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    tap_key(rec2_key);
+    tap_keys(a_key, b_key);
+    tap_key(rstp_key);
+    VERIFY_AND_CLEAR(driver);
+
+    // Magic, empty macro 1, then macro 2 as one byte per event
+    uint8_t stored[9];
+    ASSERT_GT(nvm_dynamic_macro_size(), sizeof(stored));
+    ASSERT_EQ(nvm_dynamic_macro_read(stored, 0, sizeof(stored)), sizeof(stored));
+    EXPECT_EQ(stored[1] | stored[2] << 8, 0);
+    EXPECT_EQ(stored[3] | stored[4] << 8, 4);
+    EXPECT_EQ(stored[5], 0x80 | 0);
+    EXPECT_EQ(stored[6], 0x00 | 0);
+    EXPECT_EQ(stored[7], 0x80 | 1);
+    EXPECT_EQ(stored[8], 0x00 | 1);
+}
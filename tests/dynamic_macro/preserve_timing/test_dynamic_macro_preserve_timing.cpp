@@ -0,0 +1,64 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class DynamicMacroPreserveTiming : public TestFixture {};
+
+TEST_F(DynamicMacroPreserveTiming, PlaybackKeepsRecordedDelays) {
+    TestDriver driver;
+    auto       a_key    = KeymapKey(0, 0, 0, KC_A);
+    auto       b_key    = KeymapKey(0, 1, 0, KC_B);
+    auto       rec1_key = KeymapKey(0, 3, 0, DM_REC1);
+    auto       ply1_key = KeymapKey(0, 5, 0, DM_PLY1);
+    auto       rstp_key = KeymapKey(0, 7, 0, DM_RSTP);
+
+    set_keymap({a_key, b_key, rec1_key, ply1_key, rstp_key});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    tap_key(rec1_key);
+    a_key.press();
+    run_one_scan_loop();
+    idle_for(50);
+    a_key.release();
+    run_one_scan_loop();
+    idle_for(200);
+    tap_key(b_key);
+    tap_key(rstp_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    tap_key(ply1_key);
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+
+    // A is held for as long as it was while recording
+    EXPECT_NO_REPORT(driver);
+    idle_for(30);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(30);
+    VERIFY_AND_CLEAR(driver);
+
+    // Followed by the pause before B
+    EXPECT_NO_REPORT(driver);
+    idle_for(150);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_B));
+    idle_for(100);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,165 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::Sequence;
+
+class DynamicMacro : public TestFixture {
+   protected:
+    KeymapKey a_key    = KeymapKey(0, 0, 0, KC_A);
+    KeymapKey b_key    = KeymapKey(0, 1, 0, KC_B);
+    KeymapKey c_key    = KeymapKey(0, 2, 0, KC_C);
+    KeymapKey rec1_key = KeymapKey(0, 3, 0, DM_REC1);
+    KeymapKey rec2_key = KeymapKey(0, 4, 0, DM_REC2);
+    KeymapKey ply1_key = KeymapKey(0, 5, 0, DM_PLY1);
+    KeymapKey ply2_key = KeymapKey(0, 6, 0, DM_PLY2);
+    KeymapKey rstp_key = KeymapKey(0, 7, 0, DM_RSTP);
+
+    void SetUp() override {
+        set_keymap({a_key, b_key, c_key, rec1_key, rec2_key, ply1_key, ply2_key, rstp_key});
+    }
+};
+
+TEST_F(DynamicMacro, RecordAndPlay) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    tap_key(rec1_key);
+    tap_keys(a_key, b_key);
+    tap_key(rstp_key);
+    VERIFY_AND_CLEAR(driver);
+
+    Sequence s;
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A)).InSequence(s);
+    EXPECT_REPORT(driver, (KC_B)).InSequence(s);
+    tap_key(ply1_key);
+    EXPECT_TRUE(dynamic_macro_is_playing());
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, PlaybackDoesNotBlockScanning) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    tap_key(rec1_key);
+    tap_key(a_key);
+    tap_key(rstp_key);
+    VERIFY_AND_CLEAR(driver);
+
+    // Nothing is sent while the play key is handled...
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A)).Times(0);
+    tap_key(ply1_key);
+    VERIFY_AND_CLEAR(driver);
+
+    // ...but on the following scans, alongside live keys.
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_C));
+    idle_for(2);
+    tap_key(c_key);
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, TrailingPressesAreTrimmed) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_C));
+    tap_key(rec1_key);
+    tap_key(a_key);
+    c_key.press();
+    run_one_scan_loop();
+    tap_key(rstp_key);
+    c_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    tap_key(ply1_key);
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, NestedPlayback) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_REPORT(driver, (KC_C));
+    tap_key(rec2_key);
+    tap_key(b_key);
+    tap_key(rstp_key);
+    tap_key(rec1_key);
+    tap_keys(a_key, ply2_key, c_key);
+    tap_key(rstp_key);
+    VERIFY_AND_CLEAR(driver);
+
+    Sequence s;
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A)).InSequence(s);
+    EXPECT_REPORT(driver, (KC_B)).InSequence(s);
+    EXPECT_REPORT(driver, (KC_C)).InSequence(s);
+    tap_key(ply1_key);
+    idle_for(20);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, RecursivePlaybackIsIgnored) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    tap_key(rec1_key);
+    tap_keys(a_key, ply1_key);
+    tap_key(rstp_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A)).Times(1);
+    tap_key(ply1_key);
+    idle_for(20);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, CompactEncodingExceedsRecordCapacity) {
+    TestDriver driver;
+    // More key events than DYNAMIC_MACRO_SIZE, which used to be the
+    // capacity of both macros combined.
+    const int taps = DYNAMIC_MACRO_SIZE;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A)).Times(taps);
+    tap_key(rec1_key);
+    for (int i = 0; i < taps; i++) {
+        tap_key(a_key);
+    }
+    tap_key(rstp_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A)).Times(taps);
+    tap_key(ply1_key);
+    idle_for(2 * taps + 10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
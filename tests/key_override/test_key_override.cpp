@@ -0,0 +1,162 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class KeyOverride : public TestFixture {};
+
+TEST_F(KeyOverride, ShiftBackspaceSendsDelete) {
+    TestDriver driver;
+    InSequence s;
+    auto       shift_key     = KeymapKey(0, 0, 0, KC_LSFT);
+    auto       backspace_key = KeymapKey(0, 1, 0, KC_BSPC);
+
+    set_keymap({shift_key, backspace_key});
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    shift_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_DEL));
+    backspace_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_LSFT));
+    backspace_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    shift_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, NoOverrideWithoutModifiers) {
+    TestDriver driver;
+    InSequence s;
+    auto       backspace_key = KeymapKey(0, 1, 0, KC_BSPC);
+
+    set_keymap({backspace_key});
+
+    EXPECT_REPORT(driver, (KC_BSPC));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(backspace_key);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, FirstOverrideWithSameTriggerWins) {
+    TestDriver driver;
+    InSequence s;
+    auto       ctrl_key = KeymapKey(0, 0, 0, KC_LCTL);
+    auto       a_key    = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({ctrl_key, a_key});
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    ctrl_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_B));
+    a_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_LCTL));
+    a_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    ctrl_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, ListOrderIsKeptAcrossModifierRequirements) {
+    TestDriver driver;
+    InSequence s;
+    auto       alt_key = KeymapKey(0, 0, 0, KC_LALT);
+    auto       q_key   = KeymapKey(0, 1, 0, KC_Q);
+
+    set_keymap({alt_key, q_key});
+
+    // Without modifiers, only the override requiring none applies
+    EXPECT_REPORT(driver, (KC_W));
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(q_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LALT));
+    alt_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // With Alt down, the earlier Alt + Q override applies
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_E));
+    q_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_LALT)).Times(AnyNumber());
+    q_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    alt_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, ModifierAfterTriggerDefersReplacement) {
+    TestDriver driver;
+    InSequence s;
+    auto       shift_key     = KeymapKey(0, 0, 0, KC_LSFT);
+    auto       backspace_key = KeymapKey(0, 1, 0, KC_BSPC);
+
+    set_keymap({shift_key, backspace_key});
+
+    EXPECT_REPORT(driver, (KC_BSPC));
+    backspace_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // Pressing Shift while Backspace is held removes Backspace, and registers Delete once the repeat delay since the Backspace press passed
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_LSFT)).Times(AnyNumber());
+    shift_key.press();
+    idle_for(100);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_DEL));
+    idle_for(500); // KEY_OVERRIDE_REPEAT_DELAY
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_LSFT));
+    backspace_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    shift_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,30 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// Overrides that never match the tested keys, so the tested ones are found among many candidates
+#define FILLER_OVERRIDE(n) const key_override_t filler_override_##n = ko_make_basic(MOD_MASK_CTRL, KC_F1 + n, KC_F13 + n);
+FILLER_OVERRIDE(0)
+FILLER_OVERRIDE(1)
+FILLER_OVERRIDE(2)
+FILLER_OVERRIDE(3)
+FILLER_OVERRIDE(4)
+FILLER_OVERRIDE(5)
+FILLER_OVERRIDE(6)
+FILLER_OVERRIDE(7)
+
+// Shift + Backspace = Delete
+const key_override_t delete_override = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+
+// Ctrl + A = B takes priority over the later Ctrl + A = C
+const key_override_t ctrl_a_b_override = ko_make_basic(MOD_MASK_CTRL, KC_A, KC_B);
+const key_override_t ctrl_a_c_override = ko_make_basic(MOD_MASK_CTRL, KC_A, KC_C);
+
+// Alt + Q = E takes priority over the later Q = W, which requires no modifiers
+const key_override_t alt_q_e_override = ko_make_basic(MOD_MASK_ALT, KC_Q, KC_E);
+const key_override_t q_w_override     = ko_make_basic(0, KC_Q, KC_W);
+
+const key_override_t *key_overrides[] = {
+    &filler_override_0, &filler_override_1, &filler_override_2, &filler_override_3, &delete_override, &ctrl_a_b_override, &filler_override_4, &filler_override_5, &alt_q_e_override, &ctrl_a_c_override, &filler_override_6, &q_w_override, &filler_override_7,
+};
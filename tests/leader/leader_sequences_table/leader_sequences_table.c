@@ -0,0 +1,13 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// clang-format off
+const leader_sequence_t PROGMEM leader_sequences[] = {
+    {{KC_A}, KC_1},
+    {{KC_A, KC_B}, KC_2},
+    {{KC_C, KC_D, KC_E, KC_F, KC_G, KC_H}, KC_6},
+    {{KC_X}, KC_9},
+};
+// clang-format on
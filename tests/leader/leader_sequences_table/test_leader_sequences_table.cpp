@@ -0,0 +1,122 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+
+class Leader : public TestFixture {};
+
+TEST_F(Leader, ends_early_on_unique_sequence) {
+    TestDriver driver;
+
+    auto key_leader = KeymapKey(0, 0, 0, QK_LEADER);
+    auto key_x      = KeymapKey(0, 1, 0, KC_X);
+
+    set_keymap({key_leader, key_x});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_leader);
+
+    EXPECT_REPORT(driver, (KC_9));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_x);
+
+    EXPECT_EQ(leader_sequence_active(), false);
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_x);
+}
+
+TEST_F(Leader, waits_for_timeout_on_prefix_of_longer_sequence) {
+    TestDriver driver;
+
+    auto key_leader = KeymapKey(0, 0, 0, QK_LEADER);
+    auto key_a      = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({key_leader, key_a});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_leader);
+    tap_key(key_a);
+
+    EXPECT_EQ(leader_sequence_active(), true);
+    EXPECT_EQ(leader_sequence_match(), 0);
+
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(300);
+
+    EXPECT_EQ(leader_sequence_active(), false);
+}
+
+TEST_F(Leader, ends_early_on_longer_sequence) {
+    TestDriver driver;
+
+    auto key_leader = KeymapKey(0, 0, 0, QK_LEADER);
+    auto key_a      = KeymapKey(0, 1, 0, KC_A);
+    auto key_b      = KeymapKey(0, 2, 0, KC_B);
+
+    set_keymap({key_leader, key_a, key_b});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_leader);
+    tap_key(key_a);
+
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+
+    EXPECT_EQ(leader_sequence_active(), false);
+}
+
+TEST_F(Leader, matches_sequence_longer_than_five_keys) {
+    TestDriver driver;
+
+    auto key_leader = KeymapKey(0, 0, 0, QK_LEADER);
+    auto key_c      = KeymapKey(0, 1, 0, KC_C);
+    auto key_d      = KeymapKey(0, 2, 0, KC_D);
+    auto key_e      = KeymapKey(0, 3, 0, KC_E);
+    auto key_f      = KeymapKey(0, 4, 0, KC_F);
+    auto key_g      = KeymapKey(0, 5, 0, KC_G);
+    auto key_h      = KeymapKey(0, 6, 0, KC_H);
+
+    set_keymap({key_leader, key_c, key_d, key_e, key_f, key_g, key_h});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_leader);
+    tap_keys(key_c, key_d, key_e, key_f, key_g);
+
+    EXPECT_EQ(leader_sequence_active(), true);
+
+    EXPECT_REPORT(driver, (KC_6));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_h);
+
+    EXPECT_EQ(leader_sequence_active(), false);
+}
+
+TEST_F(Leader, does_not_match_unknown_sequence) {
+    TestDriver driver;
+
+    auto key_leader = KeymapKey(0, 0, 0, QK_LEADER);
+    auto key_a      = KeymapKey(0, 1, 0, KC_A);
+    auto key_c      = KeymapKey(0, 2, 0, KC_C);
+
+    set_keymap({key_leader, key_a, key_c});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_leader);
+    tap_key(key_a);
+    tap_key(key_c);
+
+    EXPECT_EQ(leader_sequence_match(), -1);
+
+    idle_for(300);
+
+    EXPECT_EQ(leader_sequence_active(), false);
+}
@@ -0,0 +1,111 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "matrix_idle.h"
+#include "test_matrix.h"
+
+void last_matrix_activity_trigger(void);
+}
+
+using testing::_;
+
+class MatrixIdle : public TestFixture {
+   protected:
+    void SetUp() override {
+        matrix_idle_exit();
+        last_matrix_activity_trigger();
+    }
+
+    // Run until the matrix has gone idle
+    void go_idle() {
+        idle_for(MATRIX_IDLE_TIMEOUT + 1);
+        ASSERT_TRUE(matrix_is_idle());
+    }
+};
+
+TEST_F(MatrixIdle, StopsScanningAfterTimeout) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    idle_for(MATRIX_IDLE_TIMEOUT - 10);
+    EXPECT_FALSE(matrix_is_idle());
+
+    go_idle();
+    uint32_t scans = test_matrix_scan_count();
+    idle_for(1000);
+    EXPECT_TRUE(matrix_is_idle());
+    EXPECT_EQ(test_matrix_scan_count(), scans);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixIdle, WakingKeyIsReportedOnFirstScan) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    go_idle();
+
+    key.press();
+    EXPECT_REPORT(driver, (key.report_code));
+    run_one_scan_loop();
+    EXPECT_FALSE(matrix_is_idle());
+    VERIFY_AND_CLEAR(driver);
+
+    key.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixIdle, HeldKeyKeepsScanning) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_LEFT_SHIFT);
+    set_keymap({key});
+
+    key.press();
+    EXPECT_REPORT(driver, (key.report_code));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    idle_for(MATRIX_IDLE_TIMEOUT * 3);
+    EXPECT_FALSE(matrix_is_idle());
+
+    // Going idle starts from the release
+    key.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    idle_for(MATRIX_IDLE_TIMEOUT - 10);
+    EXPECT_FALSE(matrix_is_idle());
+    go_idle();
+}
+
+TEST_F(MatrixIdle, KeyDownWhileArmingKeepsScanning) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    idle_for(MATRIX_IDLE_TIMEOUT);
+    EXPECT_FALSE(matrix_is_idle());
+
+    // Down on the pins, but not yet through the matrix
+    press_key(0, 0);
+    EXPECT_TRUE(matrix_idle_task());
+    EXPECT_FALSE(matrix_is_idle());
+
+    EXPECT_REPORT(driver, (key.report_code));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    key.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
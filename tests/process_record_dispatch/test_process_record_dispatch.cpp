@@ -0,0 +1,79 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+
+// modules, kb, caps word, space cadet and process_quantum observe every key.
+static const uint32_t all_key_handlers = 5;
+
+class ProcessRecordDispatch : public TestFixture {
+   protected:
+    void SetUp() override {
+        process_record_quantum_reset_stats();
+    }
+
+    process_record_quantum_stats_t stats(void) {
+        process_record_quantum_stats_t s;
+        process_record_quantum_get_stats(&s);
+        return s;
+    }
+};
+
+// Typing a plain letter only reaches the handlers that observe every key.
+TEST_F(ProcessRecordDispatch, PlainLetterSkipsRangedHandlers) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey{0, 0, 0, KC_A};
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    process_record_quantum_stats_t s = stats();
+    EXPECT_EQ(s.events, 2);
+    EXPECT_EQ(s.handler_calls, 2 * all_key_handlers);
+    EXPECT_GT(s.chain_length, all_key_handlers);
+}
+
+// Ranged handlers still run, in chain order, for the keycodes they own.
+TEST_F(ProcessRecordDispatch, RangedHandlersStillRun) {
+    TestDriver driver;
+    KeymapKey  grave_esc = KeymapKey{0, 0, 0, QK_GRAVE_ESCAPE};
+    KeymapKey  lower     = KeymapKey{0, 1, 0, QK_TRI_LAYER_LOWER};
+    set_keymap({grave_esc, lower, KeymapKey{1, 1, 0, KC_TRNS}});
+
+    EXPECT_REPORT(driver, (KC_ESCAPE));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(grave_esc);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    lower.press();
+    run_one_scan_loop();
+    EXPECT_TRUE(layer_state_is(get_tri_layer_lower_layer()));
+    lower.release();
+    run_one_scan_loop();
+    EXPECT_FALSE(layer_state_is(get_tri_layer_lower_layer()));
+    VERIFY_AND_CLEAR(driver);
+
+    process_record_quantum_stats_t s = stats();
+    EXPECT_EQ(s.events, 4);
+    // Each event reaches its owner, which consumes it before process_quantum().
+    EXPECT_EQ(s.handler_calls, 4 * all_key_handlers);
+}
+
+// A keycode owned by no handler still reaches process_quantum().
+TEST_F(ProcessRecordDispatch, UnownedQuantumKeycode) {
+    TestDriver driver;
+    KeymapKey  caps_word = KeymapKey{0, 0, 0, QK_CAPS_WORD_TOGGLE};
+    set_keymap({caps_word});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(caps_word);
+    EXPECT_TRUE(is_caps_word_on());
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,100 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <set>
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgblight.h"
+}
+
+// Counts what reaches the LED driver
+static std::set<int> pushed;
+static int           pushes  = 0;
+static int           flushes = 0;
+
+static void mock_init(void) {}
+
+static void mock_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    pushed.insert(index);
+    pushes++;
+}
+
+static void mock_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {}
+
+static void mock_flush(void) {
+    flushes++;
+}
+
+extern "C" const rgblight_driver_t rgblight_driver = {
+    .init          = mock_init,
+    .set_color     = mock_set_color,
+    .set_color_all = mock_set_color_all,
+    .flush         = mock_flush,
+};
+
+class RgblightFrame : public TestFixture {
+   protected:
+    void SetUp() override {
+        rgblight_enable_noeeprom();
+        rgblight_set_effect_range(0, RGBLIGHT_LED_COUNT);
+        rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+        rgblight_sethsv_noeeprom(HSV_RED);
+        clear();
+    }
+
+    void clear(void) {
+        pushed.clear();
+        pushes  = 0;
+        flushes = 0;
+    }
+};
+
+// An explicit call sends the whole frame again, even when nothing changed,
+// for keyboards that push a frame twice or write to the driver themselves.
+TEST_F(RgblightFrame, explicit_set_pushes_whole_frame) {
+    TestDriver driver;
+
+    rgblight_set();
+    EXPECT_EQ(flushes, 1);
+    EXPECT_EQ(pushes, RGBLIGHT_LED_COUNT);
+
+    rgblight_set();
+    EXPECT_EQ(flushes, 2);
+    EXPECT_EQ(pushes, 2 * RGBLIGHT_LED_COUNT);
+}
+
+TEST_F(RgblightFrame, setrgb_at_pushes_whole_frame) {
+    TestDriver driver;
+
+    rgblight_setrgb_at(0, 0, 255, 3);
+    EXPECT_EQ(flushes, 1);
+    EXPECT_EQ(pushes, RGBLIGHT_LED_COUNT);
+}
+
+// Animation steps only push the LEDs of the effect range that changed.
+TEST_F(RgblightFrame, animation_pushes_changed_span) {
+    TestDriver driver;
+
+    rgblight_set_effect_range(0, 2);
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_RAINBOW_MOOD);
+    clear();
+
+    idle_for(1000);
+    EXPECT_GT(flushes, 0);
+    EXPECT_EQ(pushes, 2 * flushes);
+    EXPECT_EQ(pushed, (std::set<int>{0, 1}));
+}
+
+// Animation steps that leave every LED as it was do not flush.
+TEST_F(RgblightFrame, unchanged_animation_step_does_not_flush) {
+    TestDriver driver;
+
+    rgblight_sethsv_noeeprom(0, 255, 0);
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_RAINBOW_MOOD);
+    clear();
+
+    idle_for(1000);
+    EXPECT_EQ(flushes, 0);
+    EXPECT_EQ(pushes, 0);
+}
@@ -0,0 +1,75 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+#include "../virtser_mock.h"
+
+using testing::_;
+using testing::ElementsAre;
+
+class StenoFirstUp : public TestFixture {
+   protected:
+    void SetUp() override {
+        virtser_mock_clear();
+    }
+
+    std::vector<uint8_t> output() {
+        virtser_send_pending();
+        return std::vector<uint8_t>(virtser_mock_output, virtser_mock_output + virtser_mock_length);
+    }
+};
+
+TEST_F(StenoFirstUp, first_release_sends_chord) {
+    TestDriver driver;
+
+    auto key_s = KeymapKey(0, 0, 0, STN_S1);
+    auto key_t = KeymapKey(0, 1, 0, STN_TL);
+    auto key_k = KeymapKey(0, 2, 0, STN_KL);
+
+    set_keymap({key_s, key_t, key_k});
+
+    EXPECT_NO_REPORT(driver);
+    key_s.press();
+    run_one_scan_loop();
+    key_t.press();
+    run_one_scan_loop();
+    key_s.release();
+    run_one_scan_loop();
+    EXPECT_THAT(output(), ElementsAre(0x80, 0x50, 0, 0, 0, 0));
+
+    // The key still held starts the next stroke
+    key_k.press();
+    run_one_scan_loop();
+    key_t.release();
+    run_one_scan_loop();
+    key_k.release();
+    run_one_scan_loop();
+    EXPECT_THAT(output(), ElementsAre(0x80, 0x50, 0, 0, 0, 0, 0x80, 0x18, 0, 0, 0, 0));
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StenoFirstUp, held_chord_repeats) {
+    TestDriver driver;
+
+    auto key_s = KeymapKey(0, 0, 0, STN_S1);
+
+    set_keymap({key_s});
+
+    EXPECT_NO_REPORT(driver);
+    key_s.press();
+    idle_for(STENO_REPEAT_DELAY - 10);
+    EXPECT_EQ(output().size(), 0);
+
+    idle_for(20);
+    EXPECT_EQ(output().size(), 6);
+
+    idle_for(STENO_REPEAT_INTERVAL);
+    EXPECT_EQ(output().size(), 12);
+
+    key_s.release();
+    run_one_scan_loop();
+    EXPECT_THAT(output(), ElementsAre(0x80, 0x40, 0, 0, 0, 0, 0x80, 0x40, 0, 0, 0, 0));
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,9 @@
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+STENO_ENABLE = yes
+STENO_PROTOCOL = geminipr
+VIRTSER_ENABLE = yes
+
+SRC += ../virtser_mock.c
@@ -0,0 +1,154 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+#include "../virtser_mock.h"
+
+extern "C" {
+#include "process_steno.h"
+}
+
+using testing::_;
+using testing::ElementsAre;
+
+class StenoQueue : public TestFixture {
+   protected:
+    void SetUp() override {
+        virtser_mock_clear();
+        steno_stats_clear();
+    }
+
+    std::vector<uint8_t> output() {
+        return std::vector<uint8_t>(virtser_mock_output, virtser_mock_output + virtser_mock_length);
+    }
+};
+
+TEST_F(StenoQueue, sends_chord_when_all_keys_are_released) {
+    TestDriver driver;
+
+    auto key_s = KeymapKey(0, 0, 0, STN_S1);
+    auto key_t = KeymapKey(0, 1, 0, STN_TL);
+
+    set_keymap({key_s, key_t});
+
+    EXPECT_NO_REPORT(driver);
+    key_s.press();
+    run_one_scan_loop();
+    key_t.press();
+    run_one_scan_loop();
+    key_s.release();
+    run_one_scan_loop();
+    EXPECT_EQ(steno_queue_count(), 0);
+
+    key_t.release();
+    run_one_scan_loop();
+    EXPECT_EQ(steno_queue_count(), 1);
+
+    virtser_send_pending();
+    EXPECT_THAT(output(), ElementsAre(0x80, 0x50, 0, 0, 0, 0));
+    EXPECT_EQ(steno_queue_count(), 0);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StenoQueue, strokes_wait_for_endpoint) {
+    TestDriver driver;
+
+    auto key_s = KeymapKey(0, 0, 0, STN_S1);
+    auto key_a = KeymapKey(0, 1, 0, STN_A);
+
+    set_keymap({key_s, key_a});
+
+    EXPECT_NO_REPORT(driver);
+    virtser_mock_ready = false;
+    tap_key(key_s);
+    tap_key(key_a);
+
+    virtser_send_pending();
+    EXPECT_EQ(virtser_mock_length, 0);
+    EXPECT_EQ(steno_queue_count(), 2);
+
+    idle_for(20);
+    virtser_mock_ready = true;
+    virtser_send_pending();
+    EXPECT_THAT(output(), ElementsAre(0x80, 0x40, 0, 0, 0, 0, 0x80, 0, 0x20, 0, 0, 0));
+    EXPECT_EQ(steno_queue_count(), 0);
+    EXPECT_EQ(steno_stats_queued(), 2);
+    EXPECT_EQ(steno_stats_dropped(), 0);
+    EXPECT_GE(steno_stats_max_latency(), 20);
+    EXPECT_GE(steno_stats_average_latency(), 20);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StenoQueue, full_queue_drops_newest_stroke) {
+    TestDriver driver;
+
+    auto key_s = KeymapKey(0, 0, 0, STN_S1);
+    auto key_t = KeymapKey(0, 1, 0, STN_TL);
+    auto key_a = KeymapKey(0, 2, 0, STN_A);
+
+    set_keymap({key_s, key_t, key_a});
+
+    EXPECT_NO_REPORT(driver);
+    virtser_mock_ready = false;
+    tap_key(key_s);
+    tap_key(key_t);
+    tap_key(key_a);
+    EXPECT_EQ(steno_queue_count(), 2);
+    EXPECT_EQ(steno_stats_queued(), 2);
+    EXPECT_EQ(steno_stats_dropped(), 1);
+
+    virtser_mock_ready = true;
+    virtser_send_pending();
+    EXPECT_THAT(output(), ElementsAre(0x80, 0x40, 0, 0, 0, 0, 0x80, 0x10, 0, 0, 0, 0));
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StenoQueue, strokes_are_dropped_while_port_is_closed) {
+    TestDriver driver;
+
+    auto key_s = KeymapKey(0, 0, 0, STN_S1);
+    auto key_a = KeymapKey(0, 1, 0, STN_A);
+
+    set_keymap({key_s, key_a});
+
+    EXPECT_NO_REPORT(driver);
+    virtser_mock_open = false;
+    tap_key(key_s);
+    EXPECT_EQ(steno_queue_count(), 0);
+    EXPECT_EQ(steno_stats_dropped(), 1);
+
+    virtser_mock_open = true;
+    virtser_send_pending();
+    EXPECT_EQ(virtser_mock_length, 0);
+
+    tap_key(key_a);
+    virtser_send_pending();
+    EXPECT_THAT(output(), ElementsAre(0x80, 0, 0x20, 0, 0, 0));
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StenoQueue, queued_strokes_are_dropped_when_port_closes) {
+    TestDriver driver;
+
+    auto key_s = KeymapKey(0, 0, 0, STN_S1);
+
+    set_keymap({key_s});
+
+    EXPECT_NO_REPORT(driver);
+    virtser_mock_ready = false;
+    tap_key(key_s);
+    EXPECT_EQ(steno_queue_count(), 1);
+
+    virtser_mock_open = false;
+    virtser_send_pending();
+    EXPECT_EQ(steno_queue_count(), 0);
+    EXPECT_EQ(steno_stats_dropped(), 1);
+
+    virtser_mock_open  = true;
+    virtser_mock_ready = true;
+    virtser_send_pending();
+    EXPECT_EQ(virtser_mock_length, 0);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,36 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "virtser.h"
+#include "virtser_mock.h"
+
+uint8_t virtser_mock_output[64];
+uint8_t virtser_mock_length = 0;
+bool    virtser_mock_ready  = true;
+bool    virtser_mock_open   = true;
+
+void virtser_mock_clear(void) {
+    virtser_mock_length = 0;
+    virtser_mock_ready  = true;
+    virtser_mock_open   = true;
+}
+
+void virtser_init(void) {}
+
+void virtser_send(const uint8_t byte) {
+    virtser_send_buffer(&byte, 1);
+}
+
+void virtser_send_buffer(const uint8_t *data, const uint8_t length) {
+    for (uint8_t i = 0; i < length && virtser_mock_length < sizeof(virtser_mock_output); i++) {
+        virtser_mock_output[virtser_mock_length++] = data[i];
+    }
+}
+
+bool virtser_is_open(void) {
+    return virtser_mock_open;
+}
+
+bool virtser_send_ready(const uint8_t length) {
+    return virtser_mock_open && virtser_mock_ready && virtser_mock_length + length <= sizeof(virtser_mock_output);
+}
@@ -0,0 +1,26 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bytes written to the virtual serial port since the last virtser_mock_clear()
+extern uint8_t virtser_mock_output[64];
+extern uint8_t virtser_mock_length;
+// Whether the endpoint accepts more bytes
+extern bool virtser_mock_ready;
+// Whether a program has the port open
+extern bool virtser_mock_open;
+
+void virtser_mock_clear(void);
+void virtser_send_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
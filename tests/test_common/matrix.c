@@ -17,8 +17,12 @@
 #include "matrix.h"
 #include "test_matrix.h"
 #include <string.h>
+#ifdef MATRIX_IDLE_ENABLE
+#    include "matrix_idle.h"
+#endif
 
 static matrix_row_t matrix[MATRIX_ROWS] = {};
+static uint32_t     scan_count          = 0;
 
 void matrix_init(void) {
     clear_all_keys();
@@ -26,6 +30,10 @@ void matrix_init(void) {
 }
 
 uint8_t matrix_scan(void) {
+#ifdef MATRIX_IDLE_ENABLE
+    matrix_idle_exit();
+#endif
+    scan_count++;
     matrix_scan_kb();
     return 1;
 }
@@ -40,8 +48,33 @@ void matrix_init_kb(void) {}
 
 void matrix_scan_kb(void) {}
 
+#ifdef MATRIX_IDLE_ENABLE
+static bool idle_armed = false;
+
+// Any key down pulls an input, as it would with every output selected
+bool matrix_idle_arm(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (matrix[row]) {
+            return false;
+        }
+    }
+    idle_armed = true;
+    return true;
+}
+
+void matrix_idle_disarm(void) {
+    idle_armed = false;
+}
+#endif
+
 void press_key(uint8_t col, uint8_t row) {
     matrix[row] |= (matrix_row_t)1 << col;
+#ifdef MATRIX_IDLE_ENABLE
+    // The pin change interrupt
+    if (idle_armed) {
+        matrix_idle_wake();
+    }
+#endif
 }
 
 void release_key(uint8_t col, uint8_t row) {
@@ -52,6 +85,10 @@ bool matrix_is_on(uint8_t row, uint8_t col) {
     return (matrix[row] & ((matrix_row_t)1 << col));
 }
 
+uint32_t test_matrix_scan_count(void) {
+    return scan_count;
+}
+
 void clear_all_keys(void) {
     memset(matrix, 0, sizeof(matrix));
 }
@@ -23,6 +23,8 @@ extern "C" {
 void press_key(uint8_t col, uint8_t row);
 void release_key(uint8_t col, uint8_t row);
 void clear_all_keys(void);
+// Number of matrix_scan() calls so far
+uint32_t test_matrix_scan_count(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,178 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class UnicodeQueue : public TestFixture {};
+
+enum { QUEUE_STRING = SAFE_RANGE };
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == QUEUE_STRING && record->event.pressed) {
+        send_unicode_string("ΨΨ");
+        return false;
+    }
+    return true;
+}
+
+TEST_F(UnicodeQueue, types_string_from_task) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    EXPECT_NO_REPORT(driver);
+    send_unicode_string("ΨΨ");
+
+    EXPECT_EQ(unicode_queue_active(), true);
+    VERIFY_AND_CLEAR(driver);
+
+    {
+        InSequence s;
+        EXPECT_UNICODE(driver, 0x03A8);
+        EXPECT_UNICODE(driver, 0x03A8);
+    }
+    idle_for(100);
+
+    EXPECT_EQ(unicode_queue_active(), false);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeQueue, key_press_waits_for_queue) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    send_unicode_string("Ψ");
+
+    {
+        InSequence s;
+        EXPECT_UNICODE(driver, 0x03A8);
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_EMPTY_REPORT(driver);
+    }
+    tap_key(key_a);
+
+    EXPECT_EQ(unicode_queue_active(), false);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeQueue, release_of_queueing_key_does_not_wait) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    auto key_string = KeymapKey(0, 0, 0, QUEUE_STRING);
+
+    set_keymap({key_string});
+
+    EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+    key_string.press();
+    run_one_scan_loop();
+    EXPECT_EQ(unicode_queue_active(), true);
+
+    // Releasing the key leaves the string to be typed in the background
+    key_string.release();
+    run_one_scan_loop();
+    EXPECT_EQ(unicode_queue_active(), true);
+
+    idle_for(100);
+    EXPECT_EQ(unicode_queue_active(), false);
+    EXPECT_EQ(keyboard_report->mods, 0);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeQueue, batches_code_points_on_macos) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_MACOS);
+
+    send_unicode_string("Ψ⌘");
+
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_LEFT_ALT));
+        for (uint16_t keycode : {KC_0, KC_3, KC_A, KC_8, KC_2, KC_3, KC_1, KC_8}) {
+            EXPECT_REPORT(driver, (KC_LEFT_ALT, keycode));
+            EXPECT_REPORT(driver, (KC_LEFT_ALT));
+        }
+        EXPECT_EMPTY_REPORT(driver);
+    }
+    idle_for(100);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeQueue, paces_reports) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_MACOS);
+
+    send_unicode_string("Ψ");
+
+    // Option, then the delay before the first digit
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(UNICODE_TYPE_DELAY - 2);
+    VERIFY_AND_CLEAR(driver);
+
+    // One report per millisecond from then on
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_0));
+    idle_for(2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    idle_for(1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+    unicode_flush();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeQueue, release_of_held_modifier_waits_for_queue) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    auto key_shift = KeymapKey(0, 0, 0, KC_LEFT_SHIFT);
+
+    set_keymap({key_shift});
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    key_shift.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    send_unicode_string("ΨΨ");
+    // The input sequence has started with Shift saved
+    EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+    idle_for(2);
+    EXPECT_EQ(unicode_queue_active(), true);
+    VERIFY_AND_CLEAR(driver);
+
+    // The rest of the queue is typed before Shift is released
+    EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+    key_shift.release();
+    run_one_scan_loop();
+    EXPECT_EQ(unicode_queue_active(), false);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(100);
+    EXPECT_EQ(get_mods(), 0);
+    EXPECT_EQ(keyboard_report->mods, 0);
+    VERIFY_AND_CLEAR(driver);
+}
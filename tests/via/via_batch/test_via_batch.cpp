@@ -0,0 +1,242 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "raw_hid.h"
+#include "via.h"
+#include "dynamic_keymap.h"
+}
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+
+#define REPORT_SIZE 32
+
+typedef std::vector<uint8_t> bytes_t;
+
+/**
+ * Stands in for a configurator: sends OUT reports to raw_hid_receive() and
+ * collects the IN reports sent back, counting both.
+ */
+class MockHost {
+   public:
+    MockHost() : m_driver(*host_get_driver()) {
+        m_previous            = host_get_driver();
+        m_driver.send_raw_hid = &MockHost::receive;
+        host_set_driver(&m_driver);
+        m_this = this;
+    }
+    ~MockHost() {
+        host_set_driver(m_previous);
+        m_this = nullptr;
+    }
+
+    void send(const bytes_t &report) {
+        uint8_t data[REPORT_SIZE] = {0};
+        std::copy(report.begin(), report.end(), data);
+        out_reports++;
+        raw_hid_receive(data, sizeof(data));
+    }
+
+    bytes_t read(void) {
+        EXPECT_FALSE(m_in.empty());
+        if (m_in.empty()) {
+            return bytes_t(REPORT_SIZE);
+        }
+        bytes_t report = m_in.front();
+        m_in.erase(m_in.begin());
+        return report;
+    }
+
+    // One command per report, waiting for each answer
+    bytes_t command(const bytes_t &command) {
+        send(command);
+        return read();
+    }
+
+    // Packs the commands into as few batches as possible and sends them all
+    // before reading any response, returning the first response_length bytes
+    // of each answer.
+    std::vector<bytes_t> batch(const std::vector<bytes_t> &commands, uint8_t response_length) {
+        std::vector<uint8_t> sequences;
+        bytes_t              request = {VIA_BATCH_COMMAND, m_sequence};
+
+        for (const bytes_t &command : commands) {
+            if (request.size() + 2 + command.size() > REPORT_SIZE) {
+                send(request);
+                sequences.push_back(m_sequence++);
+                request = {VIA_BATCH_COMMAND, m_sequence};
+            }
+            request.push_back(command.size());
+            request.push_back(response_length);
+            request.insert(request.end(), command.begin(), command.end());
+        }
+        send(request);
+        sequences.push_back(m_sequence++);
+
+        std::vector<bytes_t> responses;
+        for (uint8_t sequence : sequences) {
+            for (uint8_t index = 0;; index++) {
+                bytes_t report = read();
+                EXPECT_EQ(report[0], VIA_BATCH_COMMAND);
+                EXPECT_EQ(report[1], sequence);
+                EXPECT_EQ(report[2] & ~VIA_BATCH_LAST_REPORT, index);
+
+                size_t pos = VIA_BATCH_RESPONSE_HEADER_SIZE;
+                while (pos < report.size() && report[pos] != 0) {
+                    uint8_t length = report[pos++];
+                    responses.push_back(bytes_t(report.begin() + pos, report.begin() + pos + length));
+                    pos += length;
+                }
+                if (report[2] & VIA_BATCH_LAST_REPORT) {
+                    break;
+                }
+            }
+        }
+        return responses;
+    }
+
+    size_t in_reports  = 0;
+    size_t out_reports = 0;
+
+   private:
+    static void receive(uint8_t *data, uint8_t length) {
+        m_this->in_reports++;
+        m_this->m_in.push_back(bytes_t(data, data + length));
+    }
+
+    host_driver_t        m_driver;
+    host_driver_t       *m_previous;
+    std::vector<bytes_t> m_in;
+    uint8_t              m_sequence = 1;
+    static MockHost     *m_this;
+};
+
+MockHost *MockHost::m_this = nullptr;
+
+// The fields a configurator reads when a keyboard is connected: versions,
+// layout and macro settings, then the keycodes of the first layer.
+static std::vector<bytes_t> configurator_load(void) {
+    std::vector<bytes_t> commands = {
+        {id_get_protocol_version},
+        {id_get_keyboard_value, id_firmware_version},
+        {id_get_keyboard_value, id_layout_options},
+        {id_dynamic_keymap_get_layer_count},
+        {id_dynamic_keymap_macro_get_count},
+        {id_dynamic_keymap_macro_get_buffer_size},
+    };
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            commands.push_back({id_dynamic_keymap_get_keycode, 0, row, col});
+        }
+    }
+    return commands;
+}
+
+class ViaBatch : public TestFixture {};
+
+TEST_F(ViaBatch, answers_like_single_commands) {
+    TestDriver driver;
+    MockHost   host;
+
+    dynamic_keymap_set_keycode(0, 1, 2, KC_B);
+    dynamic_keymap_set_keycode(0, 3, 9, KC_Z);
+
+    std::vector<bytes_t> commands = configurator_load();
+    std::vector<bytes_t> single;
+    for (const bytes_t &command : commands) {
+        bytes_t response = host.command(command);
+        single.push_back(bytes_t(response.begin(), response.begin() + 6));
+    }
+
+    EXPECT_THAT(host.batch(commands, 6), ElementsAreArray(single));
+    EXPECT_THAT(single[6 + 1 * MATRIX_COLS + 2], ElementsAre(id_dynamic_keymap_get_keycode, 0, 1, 2, 0x00, KC_B));
+    EXPECT_THAT(single[6 + 3 * MATRIX_COLS + 9], ElementsAre(id_dynamic_keymap_get_keycode, 0, 3, 9, 0x00, KC_Z));
+}
+
+TEST_F(ViaBatch, reduces_round_trips) {
+    TestDriver           driver;
+    MockHost             single;
+    std::vector<bytes_t> commands = configurator_load();
+
+    for (const bytes_t &command : commands) {
+        single.command(command);
+    }
+    EXPECT_EQ(single.out_reports, commands.size());
+    EXPECT_EQ(single.in_reports, commands.size());
+
+    MockHost batched;
+    batched.batch(commands, 6);
+    // 46 round trips become 9 requests, sent all at once, answered by 17 reports
+    EXPECT_EQ(commands.size(), 46);
+    EXPECT_EQ(batched.out_reports, 9);
+    EXPECT_EQ(batched.in_reports, 17);
+}
+
+TEST_F(ViaBatch, pipelined_requests_keep_their_sequence) {
+    TestDriver driver;
+    MockHost   host;
+
+    host.send({VIA_BATCH_COMMAND, 7, 1, 3, id_get_protocol_version});
+    host.send({VIA_BATCH_COMMAND, 8, 1, 2, id_dynamic_keymap_get_layer_count});
+
+    bytes_t first = host.read();
+    EXPECT_THAT(bytes_t(first.begin(), first.begin() + 8), ElementsAre(VIA_BATCH_COMMAND, 7, VIA_BATCH_LAST_REPORT, 3, id_get_protocol_version, VIA_PROTOCOL_VERSION >> 8, VIA_PROTOCOL_VERSION & 0xFF, 0));
+    bytes_t second = host.read();
+    EXPECT_THAT(bytes_t(second.begin(), second.begin() + 7), ElementsAre(VIA_BATCH_COMMAND, 8, VIA_BATCH_LAST_REPORT, 2, id_dynamic_keymap_get_layer_count, DYNAMIC_KEYMAP_LAYER_COUNT, 0));
+}
+
+TEST_F(ViaBatch, streams_long_responses) {
+    TestDriver driver;
+    MockHost   host;
+
+    // Four macro buffer reads of 20 bytes need four response reports
+    std::vector<bytes_t> commands;
+    for (uint8_t i = 0; i < 4; i++) {
+        commands.push_back({id_dynamic_keymap_macro_get_buffer, 0, (uint8_t)(i * 20), 20});
+    }
+    std::vector<bytes_t> responses = host.batch(commands, 24);
+
+    EXPECT_EQ(host.out_reports, 1);
+    EXPECT_EQ(host.in_reports, 4);
+    ASSERT_EQ(responses.size(), 4);
+    EXPECT_EQ(responses[3][0], id_dynamic_keymap_macro_get_buffer);
+    EXPECT_EQ(responses[3][2], 60);
+}
+
+TEST_F(ViaBatch, rejects_unknown_and_nested_commands) {
+    TestDriver driver;
+    MockHost   host;
+
+    std::vector<bytes_t> responses = host.batch({{0x42, 1, 2}, {VIA_BATCH_COMMAND, 1, 1, 1, id_get_protocol_version}}, 1);
+
+    EXPECT_THAT(responses, ElementsAre(ElementsAre(id_unhandled), ElementsAre(id_unhandled)));
+}
+
+TEST_F(ViaBatch, stops_at_truncated_command) {
+    TestDriver driver;
+    MockHost   host;
+
+    // The second command claims more bytes than are left in the report
+    host.send({VIA_BATCH_COMMAND, 3, 1, 3, id_get_protocol_version, 30, 1, id_get_protocol_version});
+
+    bytes_t response = host.read();
+    EXPECT_EQ(response[2], VIA_BATCH_LAST_REPORT);
+    EXPECT_EQ(response[3], 3);
+    EXPECT_EQ(response[7], 0);
+    EXPECT_EQ(host.in_reports, 1);
+}
+
+TEST_F(ViaBatch, single_commands_are_unchanged) {
+    TestDriver driver;
+    MockHost   host;
+
+    bytes_t response = host.command({id_get_protocol_version});
+    EXPECT_EQ(response[0], id_get_protocol_version);
+    EXPECT_EQ(response[1], VIA_PROTOCOL_VERSION >> 8);
+    EXPECT_EQ(response[2], VIA_PROTOCOL_VERSION & 0xFF);
+    EXPECT_EQ(host.in_reports, 1);
+}
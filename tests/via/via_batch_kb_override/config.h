@@ -0,0 +1,10 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define VIA_BATCH_ENABLE
+#define DYNAMIC_KEYMAP_LAYER_COUNT 2
+#define TRANSIENT_EEPROM_SIZE 1024
@@ -0,0 +1,98 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "raw_hid.h"
+#include "via.h"
+}
+
+using testing::ElementsAre;
+
+#define REPORT_SIZE 32
+#define ID_KB_COMMAND 0x70
+
+typedef std::vector<uint8_t> bytes_t;
+
+// A keyboard-specific command, answered by the keyboard itself
+extern "C" bool via_command_kb(uint8_t *data, uint8_t length) {
+    if (data[0] != ID_KB_COMMAND) {
+        return false;
+    }
+    data[1] = 0x42;
+    raw_hid_send(data, length);
+    return true;
+}
+
+/**
+ * Sends OUT reports to raw_hid_receive() and returns the IN report sent back.
+ * Construct after the TestDriver, which replaces the host driver.
+ */
+class MockHost {
+   public:
+    MockHost() : m_driver(*host_get_driver()) {
+        m_previous            = host_get_driver();
+        m_driver.send_raw_hid = &MockHost::receive;
+        host_set_driver(&m_driver);
+        m_this = this;
+    }
+    ~MockHost() {
+        host_set_driver(m_previous);
+        m_this = nullptr;
+    }
+
+    bytes_t command(const bytes_t &report, size_t length) {
+        uint8_t data[REPORT_SIZE] = {0};
+        std::copy(report.begin(), report.end(), data);
+        raw_hid_receive(data, sizeof(data));
+        EXPECT_EQ(m_in.size(), 1);
+        if (m_in.empty()) {
+            return bytes_t(length);
+        }
+        bytes_t response = m_in.front();
+        m_in.clear();
+        return bytes_t(response.begin(), response.begin() + length);
+    }
+
+   private:
+    static void receive(uint8_t *data, uint8_t length) {
+        m_this->m_in.push_back(bytes_t(data, data + length));
+    }
+
+    host_driver_t        m_driver;
+    host_driver_t       *m_previous;
+    std::vector<bytes_t> m_in;
+    static MockHost     *m_this;
+};
+
+MockHost *MockHost::m_this = nullptr;
+
+class ViaBatchKbOverride : public TestFixture {};
+
+// Overriding via_command_kb() does not turn batches off, core commands are
+// still batched.
+TEST_F(ViaBatchKbOverride, batch_runs_core_commands) {
+    TestDriver driver;
+    MockHost   host;
+
+    EXPECT_THAT(host.command({VIA_BATCH_COMMAND, 1, 1, 3, id_get_protocol_version}, 8), ElementsAre(VIA_BATCH_COMMAND, 1, VIA_BATCH_LAST_REPORT, 3, id_get_protocol_version, VIA_PROTOCOL_VERSION >> 8, VIA_PROTOCOL_VERSION & 0xFF, 0));
+}
+
+// Batched commands do not reach via_command_kb(), so keyboard commands in a
+// batch are unhandled and the host sends them on their own.
+TEST_F(ViaBatchKbOverride, batched_kb_command_is_unhandled) {
+    TestDriver driver;
+    MockHost   host;
+
+    EXPECT_THAT(host.command({VIA_BATCH_COMMAND, 2, 1, 2, ID_KB_COMMAND, 1, 3, id_get_protocol_version}, 11), ElementsAre(VIA_BATCH_COMMAND, 2, VIA_BATCH_LAST_REPORT, 2, id_unhandled, 0, 3, id_get_protocol_version, VIA_PROTOCOL_VERSION >> 8, VIA_PROTOCOL_VERSION & 0xFF, 0));
+}
+
+TEST_F(ViaBatchKbOverride, single_commands_still_work) {
+    TestDriver driver;
+    MockHost   host;
+
+    EXPECT_THAT(host.command({ID_KB_COMMAND}, 2), ElementsAre(ID_KB_COMMAND, 0x42));
+    EXPECT_THAT(host.command({id_get_protocol_version}, 3), ElementsAre(id_get_protocol_version, VIA_PROTOCOL_VERSION >> 8, VIA_PROTOCOL_VERSION & 0xFF));
+}
@@ -320,6 +320,24 @@ bool usb_endpoint_in_is_inactive(usb_endpoint_in_t *endpoint) {
     return inactive;
 }
 
+bool usb_endpoint_in_has_space(usb_endpoint_in_t *endpoint, size_t size) {
+    osalDbgCheck(endpoint != NULL);
+
+    output_buffers_queue_t *obqp = &endpoint->obqueue;
+
+    osalSysLock();
+    /* The buffer that is currently being filled still counts as empty until
+     * it is posted, only the bytes left in it are available. */
+    size_t space = bqSpaceI(obqp) * endpoint->config.buffer_size;
+    if (obqp->ptr != NULL) {
+        space -= endpoint->config.buffer_size - ((size_t)obqp->top - (size_t)obqp->ptr);
+    }
+    bool has_space = usbGetDriverStateI(endpoint->config.usbp) == USB_ACTIVE && space >= size;
+    osalSysUnlock();
+
+    return has_space;
+}
+
 bool usb_endpoint_out_receive(usb_endpoint_out_t *endpoint, uint8_t *data, size_t size, sysinterval_t timeout) {
     osalDbgCheck((endpoint != NULL) && (data != NULL) && (size > 0U));
 
@@ -538,6 +538,7 @@ bool recv_midi_packet(MIDI_EventPacket_t *const event) {
 #ifdef VIRTSER_ENABLE
 
 #    include "hal_usb_cdc.h"
+#    include "virtser.h"
 /**
  * @brief CDC serial driver configuration structure. Set to 9600 baud, 1 stop bit, no parity, 8 data bits.
  */
@@ -572,10 +573,25 @@ void virtser_send(const uint8_t byte) {
     send_report_buffered(USB_ENDPOINT_IN_CDC_DATA, (void *)&byte, sizeof(byte));
 }
 
+void virtser_send_buffer(const uint8_t *data, const uint8_t length) {
+    send_report_buffered(USB_ENDPOINT_IN_CDC_DATA, (void *)data, length);
+}
+
+// The control lines are not tracked, so the port counts as always open
+bool virtser_is_open(void) {
+    return true;
+}
+
+bool virtser_send_ready(const uint8_t length) {
+    return usb_endpoint_in_has_space(&usb_endpoints_in[USB_ENDPOINT_IN_CDC_DATA], length);
+}
+
 __attribute__((weak)) void virtser_recv(uint8_t c) {
     // Ignore by default
 }
 
+__attribute__((weak)) void virtser_send_pending(void) {}
+
 void virtser_task(void) {
     uint8_t buffer[CDC_EPSIZE];
     while (receive_report(USB_ENDPOINT_OUT_CDC_DATA, buffer, sizeof(buffer))) {
@@ -584,6 +600,7 @@ void virtser_task(void) {
         }
     }
 
+    virtser_send_pending();
     flush_report_buffered(USB_ENDPOINT_IN_CDC_DATA, false);
 }
 
@@ -696,11 +696,20 @@ void virtser_recv(uint8_t c) {
     // Ignore by default
 }
 
+/** \brief Virtual Serial Send Pending
+ *
+ * Called before the received bytes are processed, define it to send buffered output.
+ */
+void virtser_send_pending(void) __attribute__((weak));
+void virtser_send_pending(void) {}
+
 /** \brief Virtual Serial Task
  *
  * FIXME: Needs doc
  */
 void virtser_task(void) {
+    virtser_send_pending();
+
     uint16_t count = CDC_Device_BytesReceived(&cdc_device);
     uint8_t  ch;
     for (; count; --count) {
@@ -738,6 +747,64 @@ void virtser_send(const uint8_t byte) {
         Endpoint_SelectEndpoint(ep);
     }
 }
+
+/** \brief Virtual Serial Send Buffer
+ *
+ * Write all bytes into the IN endpoint and send them as a single packet.
+ */
+void virtser_send_buffer(const uint8_t *data, const uint8_t length) {
+    uint8_t timeout = 255;
+    uint8_t ep      = Endpoint_GetCurrentEndpoint();
+
+    if (cdc_device.State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR) {
+        /* IN packet */
+        Endpoint_SelectEndpoint(cdc_device.Config.DataINEndpoint.Address);
+
+        if (!Endpoint_IsEnabled() || !Endpoint_IsConfigured()) {
+            Endpoint_SelectEndpoint(ep);
+            return;
+        }
+
+        while (timeout-- && !Endpoint_IsReadWriteAllowed())
+            _delay_us(40);
+
+        for (uint8_t i = 0; i < length; i++) {
+            Endpoint_Write_8(data[i]);
+        }
+        CDC_Device_Flush(&cdc_device);
+
+        if (Endpoint_IsINReady()) {
+            Endpoint_ClearIN();
+        }
+
+        Endpoint_SelectEndpoint(ep);
+    }
+}
+
+/** \brief Virtual Serial Is Open
+ *
+ * True while the host has set DTR, i.e. a program has the port open.
+ */
+bool virtser_is_open(void) {
+    return cdc_device.State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR;
+}
+
+/** \brief Virtual Serial Send Ready
+ *
+ * True if the IN endpoint can take `length` more bytes without waiting for the host.
+ */
+bool virtser_send_ready(const uint8_t length) {
+    if (!virtser_is_open()) {
+        return false;
+    }
+
+    uint8_t ep = Endpoint_GetCurrentEndpoint();
+    Endpoint_SelectEndpoint(cdc_device.Config.DataINEndpoint.Address);
+    bool ready = Endpoint_IsEnabled() && Endpoint_IsConfigured() && Endpoint_IsReadWriteAllowed() && Endpoint_BytesInEndpoint() + length <= CDC_EPSIZE;
+    Endpoint_SelectEndpoint(ep);
+
+    return ready;
+}
 #endif
 
 /*******************************************************************************